@@ -4,101 +4,222 @@ namespace CBP
 {
     IArmorCache IArmorCache::m_Instance;
 
+    class ArmorCacheReader
+    {
+    public:
+        ArmorCacheReader(const char* a_data, std::size_t a_size) :
+            m_p(a_data),
+            m_end(a_data + a_size)
+        {
+        }
+
+        template <class T>
+        T Read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            if (static_cast<std::size_t>(m_end - m_p) < sizeof(T))
+                throw std::exception("Unexpected end of data");
+
+            T r;
+            std::memcpy(std::addressof(r), m_p, sizeof(T));
+            m_p += sizeof(T);
+
+            return r;
+        }
+
+        void Read(std::string& a_out)
+        {
+            auto len = Read<uint32_t>();
+
+            if (static_cast<std::size_t>(m_end - m_p) < len)
+                throw std::exception("Unexpected end of data");
+
+            a_out.assign(m_p, len);
+            m_p += len;
+        }
+
+    private:
+        const char* m_p;
+        const char* m_end;
+    };
+
+    template <class T>
+    static void WriteValue(std::ofstream& a_out, const T& a_value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        a_out.write(reinterpret_cast<const char*>(std::addressof(a_value)), sizeof(T));
+    }
+
+    static void WriteValue(std::ofstream& a_out, const std::string& a_value)
+    {
+        WriteValue(a_out, static_cast<uint32_t>(a_value.size()));
+        a_out.write(a_value.data(), a_value.size());
+    }
+
     const armorCacheEntry_t* IArmorCache::GetEntry(
         const std::string& a_path)
+    {
+        auto data = GetData(a_path);
+        return data ? std::addressof(data->entry) : nullptr;
+    }
+
+    const armorCacheData_t* IArmorCache::GetData(
+        const std::string& a_path)
     {
         auto it = m_Instance.m_armorCache.find(a_path);
         if (it != m_Instance.m_armorCache.end())
             return std::addressof(it->second);
 
-        const armorCacheEntry_t* ptr(nullptr);
+        warmEntry_t warm;
+        if (TakeWarm(a_path, warm))
+        {
+            if (warm.parsed)
+                m_Instance.m_dirty = true;
 
-        Load(a_path, ptr);
+            return Adopt(a_path, std::move(warm.entry), warm.info);
+        }
 
-        return ptr;
+        return LoadImpl(a_path);
     }
 
     bool IArmorCache::Load(
         const std::string& a_path, 
         const armorCacheEntry_t*& a_out)
+    {
+        auto data = LoadImpl(a_path);
+        if (!data)
+            return false;
+
+        a_out = std::addressof(data->entry);
+
+        return true;
+    }
+
+    const armorCacheData_t* IArmorCache::LoadImpl(
+        const std::string& a_path)
     {
         try
         {
-            Json::Value root;
+            armorCacheEntry_t entry;
+            ParseFile(a_path, entry);
 
-            Serialization::ReadData(a_path, root);
+            armorCacheFileInfo_t info;
+            GetFileInfo(a_path, info);
 
-            if (root.isNull())
-                throw std::exception("root == null");
+            m_Instance.m_dirty = true;
 
-            if (!root.isObject())
-                throw std::exception("Root not an object");
+            return Adopt(a_path, std::move(entry), info);
+        }
+        catch (const std::exception& e)
+        {
+            m_Instance.m_lastException = e;
+            return nullptr;
+        }
+    }
 
-            armorCacheEntry_t entry;
+    void IArmorCache::ParseFile(
+        const std::string& a_path,
+        armorCacheEntry_t& a_out)
+    {
+        Json::Value root;
 
-            for (auto it1 = root.begin(); it1 != root.end(); ++it1)
-            {
-                if (!it1->isObject())
-                    throw std::exception("Unexpected data");
+        Serialization::ReadData(a_path, root);
 
-                std::string configGroup(it1.key().asString());
+        if (root.isNull())
+            throw std::exception("root == null");
 
-                /*if (!IConfig::IsValidGroup(configGroup)) {
-                    gLog.Warning("%s: Unknown config group '%s', discarding", __FUNCTION__, configGroup.c_str());
-                    continue;
-                }*/
+        if (!root.isObject())
+            throw std::exception("Root not an object");
 
-                auto& e = entry[configGroup];
+        for (auto it1 = root.begin(); it1 != root.end(); ++it1)
+        {
+            if (!it1->isObject())
+                throw std::exception("Unexpected data");
 
-                for (auto it2 = it1->begin(); it2 != it1->end(); ++it2)
-                {
-                    if (!it2->isArray())
-                        throw std::exception("Expected array");
+            std::string configGroup(it1.key().asString());
 
-                    if (it2->size() != 2)
-                        throw std::exception("Value array size must be 2");
+            /*if (!IConfig::IsValidGroup(configGroup)) {
+                gLog.Warning("%s: Unknown config group '%s', discarding", __FUNCTION__, configGroup.c_str());
+                continue;
+            }*/
 
-                    auto& v = *it2;
+            auto& e = a_out[configGroup];
 
-                    auto& type = v[0];
+            for (auto it2 = it1->begin(); it2 != it1->end(); ++it2)
+            {
+                if (!it2->isArray())
+                    throw std::exception("Expected array");
 
-                    if (!type.isNumeric())
-                        throw std::exception("Value type not numeric");
+                if (it2->size() != 2)
+                    throw std::exception("Value array size must be 2");
 
-                    auto& value = v[1];
+                auto& v = *it2;
 
-                    if (!value.isNumeric())
-                        throw std::exception("Value not numeric");
+                auto& type = v[0];
 
-                    uint32_t m = type.asUInt();
+                if (!type.isNumeric())
+                    throw std::exception("Value type not numeric");
 
-                    if (m > 1)
-                        throw std::exception("Value type out of range");
+                auto& value = v[1];
 
-                    std::string valName(it2.key().asString());
+                if (!value.isNumeric())
+                    throw std::exception("Value not numeric");
 
-                    if (!configComponent32_t::descMap.contains(valName)) {
-                        gLog.Warning("%s: Unknown value name: %s", __FUNCTION__, valName.c_str());
-                        continue;
-                    }
+                uint32_t m = type.asUInt();
+
+                if (m > 1)
+                    throw std::exception("Value type out of range");
 
-                    auto& r = e[valName];
+                std::string valName(it2.key().asString());
 
-                    r.first = m;
-                    r.second = value.asFloat();
+                if (!configComponent32_t::descMap.contains(valName)) {
+                    gLog.Warning("%s: Unknown value name: %s", __FUNCTION__, valName.c_str());
+                    continue;
                 }
-            }
 
-            auto res = m_Instance.m_armorCache.insert_or_assign(a_path, std::move(entry));
-            a_out = std::addressof(res.first->second);
+                auto& r = e[valName];
 
-            return true;
+                r.first = m;
+                r.second = value.asFloat();
+            }
         }
-        catch (const std::exception& e)
-        {
-            m_Instance.m_lastException = e;
+    }
+
+    bool IArmorCache::GetFileInfo(
+        const std::string& a_path,
+        armorCacheFileInfo_t& a_out)
+    {
+        std::error_code ec;
+
+        auto time = fs::last_write_time(a_path, ec);
+        if (ec)
             return false;
-        }
+
+        auto size = fs::file_size(a_path, ec);
+        if (ec)
+            return false;
+
+        a_out.mtime = static_cast<long long>(time.time_since_epoch().count());
+        a_out.size = static_cast<uint64_t>(size);
+
+        return true;
+    }
+
+    const armorCacheData_t* IArmorCache::Adopt(
+        const std::string& a_path,
+        armorCacheEntry_t&& a_entry,
+        const armorCacheFileInfo_t& a_info)
+    {
+        armorCacheData_t data;
+
+        Compile(a_entry, data.ops);
+        data.entry = std::move(a_entry);
+        data.info = a_info;
+
+        auto res = m_Instance.m_armorCache.insert_or_assign(a_path, std::move(data));
+
+        return std::addressof(res.first->second);
     }
 
     bool IArmorCache::Save(
@@ -109,7 +230,12 @@ namespace CBP
         {
             SerializeAndWrite(a_path, a_in);
 
-            m_Instance.m_armorCache.insert_or_assign(a_path, a_in);
+            armorCacheFileInfo_t info;
+            GetFileInfo(a_path, info);
+
+            m_Instance.m_dirty = true;
+
+            Adopt(a_path, armorCacheEntry_t(a_in), info);
 
             return true;
         }
@@ -128,7 +254,12 @@ namespace CBP
         {
             SerializeAndWrite(a_path, a_in);
 
-            m_Instance.m_armorCache.insert_or_assign(a_path, std::move(a_in));
+            armorCacheFileInfo_t info;
+            GetFileInfo(a_path, info);
+
+            m_Instance.m_dirty = true;
+
+            Adopt(a_path, std::move(a_in), info);
 
             return true;
         }
@@ -161,6 +292,55 @@ namespace CBP
         Serialization::WriteData(a_path, root);
 
     }
+
+    void IArmorCache::Compile(
+        const armorCacheEntry_t& a_in,
+        armorOverrideOps_t& a_out)
+    {
+        a_out.clear();
+
+        for (const auto& e : a_in)
+        {
+            auto group = IConfig::InternConfigGroup(e.first);
+
+            for (const auto& f : e.second)
+            {
+                auto id = configComponent32_t::GetValueId(f.first);
+                if (id == INVALID_CONFIG_VALUE_ID)
+                    continue;
+
+                a_out.emplace_back(armorOverrideOp_t{
+                    group,
+                    static_cast<uint32_t>(configComponent32_t::GetValueDesc(id).offset),
+                    static_cast<ArmorOverrideOp>(f.second.first),
+                    f.second.second });
+            }
+        }
+    }
+
+    void IArmorCache::MergeOps(
+        const armorOverrideOps_t& a_in,
+        armorOverrideOps_t& a_out)
+    {
+        if (a_out.empty())
+        {
+            a_out = a_in;
+            return;
+        }
+
+        for (const auto& e : a_in)
+        {
+            auto it = std::find_if(a_out.begin(), a_out.end(),
+                [&](const auto& a_op) {
+                    return a_op.group == e.group && a_op.offset == e.offset;
+                });
+
+            if (it != a_out.end())
+                *it = e;
+            else
+                a_out.emplace_back(e);
+        }
+    }
     
     void IArmorCache::Copy(
         const armorCacheEntry_t& a_lhs, 
@@ -196,4 +376,374 @@ namespace CBP
         }
     }
 
+    bool IArmorCache::TakeWarm(
+        const std::string& a_path,
+        warmEntry_t& a_out)
+    {
+        std::lock_guard<std::mutex> lock(m_Instance.m_warmMutex);
+
+        auto it = m_Instance.m_warm.find(a_path);
+        if (it == m_Instance.m_warm.end())
+            return false;
+
+        a_out = std::move(it->second);
+        m_Instance.m_warm.erase(it);
+
+        return true;
+    }
+
+    void IArmorCache::StartWarm(const fs::path& a_path)
+    {
+        auto& inst = m_Instance;
+
+        if (inst.m_warmThread.joinable())
+            return;
+
+        inst.m_persistentPath = a_path;
+        inst.m_warmThread = std::thread(&IArmorCache::WarmWorker, std::addressof(inst), a_path);
+    }
+
+    bool IArmorCache::QueueParse(
+        const std::string& a_path,
+        Game::ObjectHandle a_handle)
+    {
+        auto& inst = m_Instance;
+
+        if (inst.m_armorCache.find(a_path) != inst.m_armorCache.end())
+            return false;
+
+        std::lock_guard<std::mutex> lock(inst.m_warmMutex);
+
+        // failures are reported by the synchronous path
+        if (inst.m_parseStop ||
+            inst.m_warm.contains(a_path) ||
+            inst.m_parseFailed.contains(a_path))
+        {
+            return false;
+        }
+
+        auto r = inst.m_parseWaiting.try_emplace(a_path);
+        r.first->second.emplace_back(a_handle);
+
+        if (r.second)
+            inst.m_parseQueue.emplace(a_path);
+
+        if (!inst.m_parseThread.joinable())
+            inst.m_parseThread = std::thread(&IArmorCache::ParseWorker, std::addressof(inst));
+
+        inst.m_parseCond.notify_one();
+
+        return true;
+    }
+
+    void IArmorCache::ParseWorker()
+    {
+        std::unique_lock<std::mutex> lock(m_warmMutex);
+
+        for (;;)
+        {
+            m_parseCond.wait(lock, [&] {
+                return !m_parseQueue.empty() || m_parseStop;
+                });
+
+            if (m_parseStop)
+                break;
+
+            auto path = std::move(m_parseQueue.front());
+            m_parseQueue.pop();
+
+            lock.unlock();
+
+            warmEntry_t entry;
+            bool result;
+
+            try
+            {
+                ParseFile(path, entry.entry);
+                GetFileInfo(path, entry.info);
+                entry.parsed = true;
+                result = true;
+            }
+            catch (const std::exception&)
+            {
+                result = false;
+            }
+
+            lock.lock();
+
+            if (result)
+                m_warm.insert_or_assign(path, std::move(entry));
+            else
+                m_parseFailed.emplace(path);
+
+            auto it = m_parseWaiting.find(path);
+            if (it != m_parseWaiting.end())
+            {
+                for (auto& e : it->second)
+                    DCBP::DispatchActorTask(e, ControllerInstruction::Action::UpdateArmorOverride);
+
+                m_parseWaiting.erase(it);
+            }
+        }
+    }
+
+    void IArmorCache::WarmWorker(fs::path a_path)
+    {
+        auto start = PerfCounter::Query();
+
+        warmCache_t cache;
+
+        try
+        {
+            if (fs::exists(a_path))
+                ReadPersistent(a_path, cache);
+        }
+        catch (const std::exception& e)
+        {
+            gLog.Warning("%s: couldn't read persistent cache, rebuilding: %s", __FUNCTION__, e.what());
+            cache.clear();
+        }
+
+        uint32_t loaded(0), reparsed(0), dropped(0);
+
+        auto it = cache.begin();
+        while (it != cache.end())
+        {
+            armorCacheFileInfo_t info;
+            if (!GetFileInfo(it->first, info))
+            {
+                it = cache.erase(it);
+                dropped++;
+                continue;
+            }
+
+            if (!(info == it->second.info))
+            {
+                try
+                {
+                    armorCacheEntry_t entry;
+                    ParseFile(it->first, entry);
+
+                    it->second.entry = std::move(entry);
+                    it->second.info = info;
+                    it->second.parsed = true;
+
+                    reparsed++;
+                }
+                catch (const std::exception& e)
+                {
+                    gLog.Warning("%s: [%s] %s", __FUNCTION__, it->first.c_str(), e.what());
+
+                    it = cache.erase(it);
+                    dropped++;
+                    continue;
+                }
+            }
+            else
+                loaded++;
+
+            ++it;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_warmMutex);
+
+            for (auto& e : cache)
+                m_warm.try_emplace(e.first, std::move(e.second));
+
+            m_warmDone = true;
+            m_warmDirty = reparsed || dropped;
+        }
+
+        gLog.Debug("%s: %u cached, %u re-parsed, %u dropped (%.3f ms)",
+            __FUNCTION__, loaded, reparsed, dropped,
+            static_cast<double>(PerfCounter::delta_us(start, PerfCounter::Query())) / 1000.0);
+    }
+
+    void IArmorCache::ReadPersistent(
+        const fs::path& a_path,
+        warmCache_t& a_out)
+    {
+        using namespace boost::iostreams;
+
+        mapped_file_source file(a_path);
+        if (!file.is_open())
+            throw std::exception("Couldn't map file");
+
+        ArmorCacheReader reader(file.data(), file.size());
+
+        if (reader.Read<uint32_t>() != PERSISTENT_MAGIC)
+            throw std::exception("Bad magic");
+
+        if (reader.Read<uint32_t>() != PERSISTENT_VERSION)
+            throw std::exception("Unsupported version");
+
+        auto numFiles = reader.Read<uint32_t>();
+
+        std::string path, key;
+
+        for (uint32_t i = 0; i < numFiles; i++)
+        {
+            reader.Read(path);
+
+            warmEntry_t e;
+
+            e.info.mtime = reader.Read<long long>();
+            e.info.size = reader.Read<uint64_t>();
+            e.parsed = false;
+
+            auto numGroups = reader.Read<uint32_t>();
+
+            for (uint32_t j = 0; j < numGroups; j++)
+            {
+                reader.Read(key);
+
+                auto& g = e.entry[key];
+
+                auto numValues = reader.Read<uint32_t>();
+
+                for (uint32_t k = 0; k < numValues; k++)
+                {
+                    reader.Read(key);
+
+                    auto type = reader.Read<uint32_t>();
+                    auto value = reader.Read<float>();
+
+                    if (type > 1)
+                        throw std::exception("Value type out of range");
+
+                    g.insert_or_assign(key, armorCacheValue_t(type, value));
+                }
+            }
+
+            a_out.insert_or_assign(path, std::move(e));
+        }
+    }
+
+    void IArmorCache::WritePersistent(
+        const fs::path& a_path,
+        const warmCache_t& a_in)
+    {
+        Serialization::CreateRootPath(a_path);
+
+        auto tmpPath(a_path);
+        tmpPath += ".tmp";
+
+        {
+            std::ofstream ofs;
+            ofs.open(tmpPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+            if (!ofs.is_open())
+                throw std::system_error(errno, std::system_category(), tmpPath.string());
+
+            WriteValue(ofs, PERSISTENT_MAGIC);
+            WriteValue(ofs, PERSISTENT_VERSION);
+            WriteValue(ofs, static_cast<uint32_t>(a_in.size()));
+
+            for (const auto& e : a_in)
+            {
+                WriteValue(ofs, e.first);
+                WriteValue(ofs, e.second.info.mtime);
+                WriteValue(ofs, e.second.info.size);
+                WriteValue(ofs, static_cast<uint32_t>(e.second.entry.size()));
+
+                for (const auto& g : e.second.entry)
+                {
+                    WriteValue(ofs, g.first);
+                    WriteValue(ofs, static_cast<uint32_t>(g.second.size()));
+
+                    for (const auto& v : g.second)
+                    {
+                        WriteValue(ofs, v.first);
+                        WriteValue(ofs, v.second.first);
+                        WriteValue(ofs, v.second.second);
+                    }
+                }
+            }
+
+            if (ofs.fail())
+                throw std::exception("Write failed");
+        }
+
+        fs::rename(tmpPath, a_path);
+    }
+
+    void IArmorCache::FlushPersistent()
+    {
+        auto& inst = m_Instance;
+
+        if (inst.m_persistentPath.empty())
+            return;
+
+        // snapshot everything known, loaded entries take precedence over warm ones
+        auto snapshot = std::make_unique<warmCache_t>();
+
+        {
+            std::lock_guard<std::mutex> lock(inst.m_warmMutex);
+
+            // nothing to merge with yet
+            if (!inst.m_warmDone)
+                return;
+
+            if (!inst.m_dirty && !inst.m_warmDirty)
+                return;
+
+            for (const auto& e : inst.m_warm)
+                snapshot->try_emplace(e.first, e.second);
+
+            inst.m_warmDirty = false;
+        }
+
+        for (const auto& e : inst.m_armorCache)
+        {
+            if (e.second.info.size == 0 && e.second.info.mtime == 0)
+                continue;
+
+            snapshot->insert_or_assign(e.first, warmEntry_t{ e.second.entry, e.second.info, false });
+        }
+
+        inst.m_dirty = false;
+
+        if (inst.m_writerThread.joinable())
+            inst.m_writerThread.join();
+
+        inst.m_writerThread = std::thread([path = inst.m_persistentPath, data = std::move(snapshot)]
+            {
+                try
+                {
+                    WritePersistent(path, *data);
+                }
+                catch (const std::exception& e)
+                {
+                    gLog.Error("%s: couldn't write persistent cache: %s", __FUNCTION__, e.what());
+
+                    // retried on the next flush
+                    std::lock_guard<std::mutex> lock(m_Instance.m_warmMutex);
+                    m_Instance.m_warmDirty = true;
+                }
+            });
+    }
+
+    void IArmorCache::Release()
+    {
+        auto& inst = m_Instance;
+
+        if (inst.m_warmThread.joinable())
+            inst.m_warmThread.join();
+
+        {
+            std::lock_guard<std::mutex> lock(inst.m_warmMutex);
+            inst.m_parseStop = true;
+        }
+
+        inst.m_parseCond.notify_one();
+
+        if (inst.m_parseThread.joinable())
+            inst.m_parseThread.join();
+
+        FlushPersistent();
+
+        if (inst.m_writerThread.joinable())
+            inst.m_writerThread.join();
+    }
 }
\ No newline at end of file
@@ -5,13 +5,63 @@ namespace CBP
     typedef std::pair<uint32_t, float> armorCacheValue_t;
     typedef stl::iunordered_map<std::string, stl::iunordered_map<std::string, armorCacheValue_t>> armorCacheEntry_t;
     typedef stl::imap<std::string, stl::imap<std::string, armorCacheValue_t>> armorCacheEntrySorted_t;
-    typedef stl::iunordered_map<std::string, armorCacheEntry_t> armorCache_t;
+
+    enum class ArmorOverrideOp : uint32_t
+    {
+        Set = 0,
+        Mul = 1
+    };
+
+    // override value compiled against an interned config group and the
+    // value's offset in configComponent32_t
+    struct armorOverrideOp_t
+    {
+        uint32_t group;
+        uint32_t offset;
+        ArmorOverrideOp op;
+        float value;
+    };
+
+    typedef stl::vector<armorOverrideOp_t> armorOverrideOps_t;
+
+    // source file state the parsed data was produced from
+    struct armorCacheFileInfo_t
+    {
+        long long mtime{ 0 };
+        uint64_t size{ 0 };
+
+        [[nodiscard]] SKMP_FORCEINLINE bool operator==(const armorCacheFileInfo_t& a_rhs) const {
+            return mtime == a_rhs.mtime && size == a_rhs.size;
+        }
+    };
+
+    struct armorCacheData_t
+    {
+        armorCacheEntry_t entry;
+        armorOverrideOps_t ops;
+        armorCacheFileInfo_t info;
+    };
+
+    typedef stl::iunordered_map<std::string, armorCacheData_t> armorCache_t;
 
     class IArmorCache
     {
+        static constexpr uint32_t PERSISTENT_MAGIC = 'CAPC';
+        static constexpr uint32_t PERSISTENT_VERSION = 1;
+
+        struct warmEntry_t
+        {
+            armorCacheEntry_t entry;
+            armorCacheFileInfo_t info;
+            bool parsed;
+        };
+
+        typedef stl::iunordered_map<std::string, warmEntry_t> warmCache_t;
+
     public:
 
         static const armorCacheEntry_t* GetEntry(const std::string& a_path);
+        static const armorCacheData_t* GetData(const std::string& a_path);
         static bool Load(const std::string& a_path, const armorCacheEntry_t*& a_out);
         static bool Save(const std::string& a_path, const armorCacheEntry_t& a_in);
         static bool Save(const std::string& a_path, armorCacheEntry_t&& a_in);
@@ -19,6 +69,9 @@ namespace CBP
         static void Copy(const armorCacheEntry_t& a_lhs, armorCacheEntrySorted_t& a_rhs);
         static void Copy(const armorCacheEntrySorted_t& a_lhs, armorCacheEntry_t& a_rhs);
 
+        // later ops replace earlier ones targeting the same group and value
+        static void MergeOps(const armorOverrideOps_t& a_in, armorOverrideOps_t& a_out);
+
         [[nodiscard]] SKMP_FORCEINLINE static bool HasEntry(const std::string& a_path) {
             return m_Instance.m_armorCache.find(a_path) != m_Instance.m_armorCache.end();
         }
@@ -27,13 +80,55 @@ namespace CBP
             return m_Instance.m_lastException;
         }
 
+        // reads the persistent cache and re-parses changed files off-thread
+        static void StartWarm(const fs::path& a_path);
+        // true if a_path isn't available yet and is parsed off-thread instead,
+        // a_handle gets an armor override update once it's done
+        static bool QueueParse(const std::string& a_path, Game::ObjectHandle a_handle);
+        // writes the persistent cache in the background if anything changed
+        static void FlushPersistent();
+        static void Release();
+
     private:
 
+        IArmorCache() = default;
+
+        static void ParseFile(const std::string& a_path, armorCacheEntry_t& a_out);
+        static bool GetFileInfo(const std::string& a_path, armorCacheFileInfo_t& a_out);
+        static const armorCacheData_t* Adopt(const std::string& a_path, armorCacheEntry_t&& a_entry, const armorCacheFileInfo_t& a_info);
+        static bool TakeWarm(const std::string& a_path, warmEntry_t& a_out);
+
+        void WarmWorker(fs::path a_path);
+        void ParseWorker();
+        void ReadPersistent(const fs::path& a_path, warmCache_t& a_out);
+        static void WritePersistent(const fs::path& a_path, const warmCache_t& a_in);
+
+        static const armorCacheData_t* LoadImpl(const std::string& a_path);
         static void SerializeAndWrite(const std::string& a_path, const armorCacheEntry_t& a_in);
+        static void Compile(const armorCacheEntry_t& a_in, armorOverrideOps_t& a_out);
 
         armorCache_t m_armorCache;
         except::descriptor m_lastException;
 
+        fs::path m_persistentPath;
+        bool m_dirty{ false };
+
+        // guarded by m_warmMutex
+        warmCache_t m_warm;
+        bool m_warmDone{ false };
+        bool m_warmDirty{ false };
+
+        std::queue<std::string> m_parseQueue;
+        stl::iunordered_map<std::string, stl::vector<Game::ObjectHandle>> m_parseWaiting;
+        stl::iunordered_set<std::string> m_parseFailed;
+        bool m_parseStop{ false };
+
+        std::mutex m_warmMutex;
+        std::condition_variable m_parseCond;
+        std::thread m_warmThread;
+        std::thread m_parseThread;
+        std::thread m_writerThread;
+
         static IArmorCache m_Instance;
     };
 }
\ No newline at end of file
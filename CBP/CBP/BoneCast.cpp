@@ -5,10 +5,201 @@ namespace CBP
     IBoneCast IBoneCast::m_Instance;
 
     IBoneCast::IBoneCast() :
-        m_cache(m_iio, 1024 * 1024 * 64)
+        m_cache(m_iio, 1024 * 1024 * 64),
+        m_simplifyQueue(150000, 300000),
+        m_batchDone(0),
+        m_batchTotal(0)
     {
     }
 
+    void IBoneCast::Prefetch(
+        Game::ObjectHandle a_handle,
+        const configNodes_t& a_nodeConfig)
+    {
+        auto& cache = GetCache();
+
+        for (auto& e : a_nodeConfig)
+        {
+            if (!e.second.bl.b.boneCast)
+                continue;
+
+            BoneCastCache::iterator it;
+            if (cache.Get(a_handle, e.first, false, it))
+                continue;
+
+            m_Instance.m_iio.QueuePrefetch(a_handle, e.first);
+        }
+    }
+
+    void IBoneCast::Prefetch(Game::ObjectHandle a_handle)
+    {
+        m_Instance.m_iio.QueuePrefetch(a_handle);
+    }
+
+    bool IBoneCast::TryResolvePrefetch(Game::ObjectHandle a_handle)
+    {
+        if (!DCBP::TryLock())
+            return false;
+
+        Prefetch(a_handle, IConfig::GetActorNode(a_handle));
+
+        DCBP::Unlock();
+
+        return true;
+    }
+
+    bool IBoneCast::UpdateBatch(
+        const stl::vector<BoneCastCache::key_t>& a_keys)
+    {
+        if (IsBatchRunning())
+            return false;
+
+        auto batch = std::make_shared<BoneCastBatch>();
+
+        batch->m_started = PerfCounter::Query();
+        batch->m_done = 0;
+        batch->m_items.reserve(a_keys.size());
+
+        // geometry extraction has to happen here (game thread), the rest is fanned out
+
+        for (auto& e : a_keys)
+        {
+            auto actor = e.first.Resolve<Actor>();
+            if (!actor)
+                continue;
+
+            auto& nodeConfig = IConfig::GetActorNode(e.first);
+            auto itn = nodeConfig.find(e.second);
+            if (itn == nodeConfig.end())
+                continue;
+
+            if (!itn->second.bl.b.boneCast)
+                continue;
+
+            BoneCastBatch::Item item;
+
+            if (!GetGeometry(
+                actor,
+                e.second,
+                itn->second.ex.bcShape,
+                item.m_data.first))
+            {
+                continue;
+            }
+
+            item.m_key = e;
+            item.m_nodeConfig = itn->second;
+            item.m_result = false;
+
+            batch->m_items.emplace_back(std::move(item));
+        }
+
+        if (batch->m_items.empty())
+            return false;
+
+        m_Instance.m_batchDone.store(0, std::memory_order_release);
+        m_Instance.m_batchTotal.store(batch->m_items.size(), std::memory_order_release);
+
+        for (auto& e : batch->m_items)
+        {
+            bool result = m_Instance.m_threadPool.Push([batch, &e]
+                {
+                    ProcessBatchItem(e);
+
+                    m_Instance.m_batchDone.fetch_add(1, std::memory_order_acq_rel);
+
+                    if (batch->m_done.fetch_add(1, std::memory_order_acq_rel) + 1 == batch->m_items.size())
+                        DTasks::AddTask<BoneCastBatchCommitTask>(batch);
+                });
+
+            if (!result)
+            {
+                // pool stopped, the batch can never complete
+                m_Instance.m_batchTotal.store(0, std::memory_order_release);
+                m_Instance.Warning("%s: thread pool stopped, batch discarded", __FUNCTION__);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void IBoneCast::ProcessBatchItem(BoneCastBatch::Item& a_item)
+    {
+        auto& conf = a_item.m_nodeConfig.fp.f32;
+        auto& data = a_item.m_data;
+
+        FilterGeometry(data.first, conf.bcWeightThreshold, a_item.m_filtered);
+
+        if (!a_item.m_filtered.empty())
+        {
+            a_item.m_result = SimplifyGeometry(
+                data.first.m_vertices,
+                a_item.m_filtered,
+                conf.bcSimplifyTarget,
+                conf.bcSimplifyTargetError,
+                a_item.m_simplified);
+
+            if (a_item.m_result)
+                SetResultIndices(data, a_item.m_simplified);
+        }
+
+        data.UpdateSize();
+    }
+
+    void IBoneCast::CommitBatch(BoneCastBatch& a_batch)
+    {
+        auto& cache = GetCache();
+
+        stl::vector<Game::ObjectHandle> handles;
+        handles.reserve(a_batch.m_items.size());
+
+        for (auto& e : a_batch.m_items)
+        {
+            auto writeData = std::make_shared<BoneCastCache::data_t>();
+            writeData->first = e.m_data.first;
+
+            m_Instance.m_iio.QueueWrite(e.m_key.first, e.m_key.second, std::move(writeData));
+
+            auto it = cache.Add(e.m_key.first, e.m_key.second, std::move(e.m_data));
+            auto& entry = it->second;
+
+            auto& conf = e.m_nodeConfig.fp.f32;
+
+            entry.m_stage.SetFilter(conf.bcWeightThreshold, std::move(e.m_filtered));
+            entry.m_stage.AddSimplified(conf.bcSimplifyTarget, conf.bcSimplifyTargetError, e.m_simplified, entry.m_data.first.m_vertices.size());
+
+            if (e.m_result)
+            {
+                entry.m_updateID.Update();
+                entry.m_data.second = e.m_nodeConfig;
+            }
+
+            cache.UpdateSize(entry);
+
+            handles.emplace_back(e.m_key.first);
+        }
+
+        cache.EvictOverflow();
+
+        std::sort(handles.begin(), handles.end());
+        handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+
+        for (auto& e : handles)
+            DCBP::DispatchActorTask(e, ControllerInstruction::Action::UpdateConfig);
+
+        m_Instance.Debug("Batch rebuild: %zu entries, %zu actors, %lld ms",
+            a_batch.m_items.size(), handles.size(),
+            PerfCounter::delta_us(a_batch.m_started, PerfCounter::Query()) / 1000LL);
+    }
+
+    void IBoneCast::Release()
+    {
+        m_Instance.m_threadPool.Stop();
+        m_Instance.m_simplifyQueue.Stop();
+        m_Instance.m_iio.Stop();
+    }
+
     bool IBoneCast::ExtractGeometry(
         Actor* a_actor,
         const BSFixedString& a_nodeName,
@@ -171,9 +362,10 @@ namespace CBP
             size_t rnIndices = c * 3;
             size_t rnVertices = static_cast<size_t>(vi);
 
-            a_out.m_vertices.resize(rnVertices);
+            stl::vector<MeshPoint> outVertices(rnVertices);
+            stl::vector<int> outIndices(rnIndices);
+
             a_out.m_weights.resize(rnVertices);
-            a_out.m_indices.resize(rnIndices);
 
             for (UInt32 i = 0; i < numVertices; i++) {
 
@@ -183,9 +375,9 @@ namespace CBP
                 {
                     auto index = vme.m_index;
 
-                    a_out.m_vertices[index].x = vme.m_vertex.x;
-                    a_out.m_vertices[index].y = vme.m_vertex.y;
-                    a_out.m_vertices[index].z = vme.m_vertex.z;
+                    outVertices[index].x = vme.m_vertex.x;
+                    outVertices[index].y = vme.m_vertex.y;
+                    outVertices[index].z = vme.m_vertex.z;
 
                     a_out.m_weights[index] = vme.m_weight;
                 }
@@ -200,7 +392,7 @@ namespace CBP
                     for (int j = 0; j < 3; j++) {
                         auto index = tri.m_indices[j];
 
-                        a_out.m_indices[c] = index;
+                        outIndices[c] = index;
 
                         c++;
                     }
@@ -208,6 +400,9 @@ namespace CBP
                 }
             }
 
+            a_out.m_vertices.Encode(outVertices.data(), rnVertices);
+            a_out.m_indices.Assign(outIndices, rnVertices);
+
             a_out.m_numTriangles = static_cast<int>(rnIndices / 3);
 
             return true;
@@ -217,17 +412,15 @@ namespace CBP
         return false;
     }
 
-    bool IBoneCast::UpdateGeometry(
-        BoneCastCache::CacheEntry::data_t& a_in,
+    void IBoneCast::FilterGeometry(
+        const ColliderDataStorage& a_in,
         float a_weightThreshold,
-        float a_simplifyTarget,
-        float a_simplifyTargetError)
+        stl::vector<int>& a_out)
     {
-        auto numIndices = a_in.first.m_indices.size();
-
-        auto indices = decltype(a_in.second.m_indices)();
+        auto numIndices = a_in.m_indices.size();
 
-        indices.reserve(numIndices);
+        a_out.clear();
+        a_out.reserve(numIndices);
 
         for (size_t i = 0; i < numIndices; i += 3)
         {
@@ -237,9 +430,9 @@ namespace CBP
 
             for (size_t j = i; j < m; j++)
             {
-                int index = a_in.first.m_indices[j];
+                int index = a_in.m_indices[j];
 
-                if (a_in.first.m_weights[index] < a_weightThreshold)
+                if (a_in.m_weights[index] < a_weightThreshold)
                 {
                     skip = true;
                     break;
@@ -251,65 +444,163 @@ namespace CBP
 
             for (size_t j = i; j < m; j++)
             {
-                indices.emplace_back(a_in.first.m_indices[j]);
+                a_out.emplace_back(a_in.m_indices[j]);
             }
         }
 
-        numIndices = indices.size();
+        a_out.shrink_to_fit();
+    }
+
+    bool IBoneCast::SimplifyGeometry(
+        const QuantizedVertices& a_vertices,
+        const stl::vector<int>& a_indices,
+        float a_simplifyTarget,
+        float a_simplifyTargetError,
+        stl::vector<int>& a_out)
+    {
+        auto numIndices = a_indices.size();
 
-        if (!numIndices) {
-            a_in.second.Clear();
+        if (!numIndices)
             return false;
-        }
 
         auto targetIndices = std::clamp<size_t>(static_cast<size_t>(static_cast<double>(numIndices) * a_simplifyTarget), 3, numIndices);
 
-        if (targetIndices < numIndices)
+        if (targetIndices >= numIndices)
         {
-            auto tmp = std::make_unique<unsigned int[]>(numIndices);
+            a_out = a_indices;
+            return true;
+        }
 
-            auto newIndices = meshopt_simplify(
-                tmp.get(),
-                reinterpret_cast<unsigned int*>(indices.data()),
-                numIndices,
-                reinterpret_cast<const float*>(a_in.first.m_vertices.data()),
-                a_in.first.m_vertices.size(),
-                sizeof(MeshPoint),
-                targetIndices,
-                a_simplifyTargetError);
+        // positions are only expanded here, into a per-thread buffer that
+        // is reused across simplify calls (batch, queue and direct paths)
+        static thread_local stl::vector<MeshPoint> vertices;
+        a_vertices.Decode(vertices);
+
+        a_out.resize(numIndices);
+
+        auto newIndices = meshopt_simplify(
+            reinterpret_cast<unsigned int*>(a_out.data()),
+            reinterpret_cast<const unsigned int*>(a_indices.data()),
+            numIndices,
+            reinterpret_cast<const float*>(vertices.data()),
+            vertices.size(),
+            sizeof(MeshPoint),
+            targetIndices,
+            a_simplifyTargetError);
+
+        if (newIndices % 3 != 0) {
+            a_out.clear();
+            return false;
+        }
 
-            if (newIndices % 3 != 0) {
-                a_in.second.Clear();
-                return false;
-            }
+        a_out.resize(newIndices);
+        a_out.shrink_to_fit();
 
-            a_in.second.m_indices = decltype(a_in.second.m_indices)(newIndices);
-            a_in.second.m_hullPoints = decltype(a_in.second.m_hullPoints)(newIndices);
+        return true;
+    }
 
-            for (decltype(newIndices) i = 0; i < newIndices; i++)
-            {
-                auto index = static_cast<int>(tmp[i]);
+    void IBoneCast::SetResultIndices(
+        BoneCastCache::data_t& a_in,
+        const stl::vector<int>& a_indices)
+    {
+        a_in.second.m_indices.Assign(a_indices, a_in.first.m_vertices.size());
+        a_in.second.m_numTriangles = static_cast<int>(a_indices.size() / 3);
+    }
 
-                a_in.second.m_indices[i] = index;
-                a_in.second.m_hullPoints[i] = a_in.first.m_vertices[index];
-            }
+    void IBoneCast::SetResultIndices(
+        BoneCastCache::data_t& a_in,
+        const IndexBuffer& a_indices)
+    {
+        a_in.second.m_indices = a_indices;
+        a_in.second.m_numTriangles = static_cast<int>(a_indices.size() / 3);
+    }
+
+    void IBoneCast::UpdateFilterStage(
+        BoneCastCache::CacheEntry& a_in,
+        float a_weightThreshold)
+    {
+        auto& stage = a_in.m_stage;
+
+        if (stage.HasFilter(a_weightThreshold))
+            return;
+
+        BoneCastCache::CacheEntry::StageCache::indices_t indices;
+        FilterGeometry(a_in.m_data.first, a_weightThreshold, indices);
+
+        stage.SetFilter(a_weightThreshold, std::move(indices));
+    }
+
+    bool IBoneCast::UpdateGeometry(
+        BoneCastCache::CacheEntry& a_in,
+        const configNode_t& a_nodeConfig)
+    {
+        auto& stage = a_in.m_stage;
+        auto& conf = a_nodeConfig.fp.f32;
 
-            a_in.second.m_numTriangles = static_cast<int>(newIndices / 3);
+        UpdateFilterStage(a_in, conf.bcWeightThreshold);
+
+        if (stage.m_filtered->empty()) {
+            a_in.m_data.second.Clear();
+            return false;
         }
-        else 
+
+        auto memo = stage.FindSimplified(conf.bcSimplifyTarget, conf.bcSimplifyTargetError);
+        if (memo)
         {
-            a_in.second.m_indices = std::move(indices);
-            a_in.second.m_indices.shrink_to_fit();
+            if (memo->empty()) {
+                a_in.m_data.second.Clear();
+                return false;
+            }
+
+            SetResultIndices(a_in.m_data, *memo);
+            return true;
+        }
 
-            a_in.second.m_hullPoints = decltype(a_in.second.m_hullPoints)(numIndices);
-            for (size_t i = 0; i < numIndices; i++)
-                a_in.second.m_hullPoints[i] = a_in.first.m_vertices[a_in.second.m_indices[i]];
+        BoneCastCache::CacheEntry::StageCache::indices_t indices;
 
-            a_in.second.m_numTriangles = static_cast<int>(numIndices / 3);
+        bool res = SimplifyGeometry(
+            a_in.m_data.first.m_vertices,
+            *stage.m_filtered,
+            conf.bcSimplifyTarget,
+            conf.bcSimplifyTargetError,
+            indices);
+
+        stage.AddSimplified(conf.bcSimplifyTarget, conf.bcSimplifyTargetError, indices, a_in.m_data.first.m_vertices.size());
+
+        if (!res) {
+            a_in.m_data.second.Clear();
+            return false;
         }
 
+        SetResultIndices(a_in.m_data, indices);
+
         return true;
+    }
+
+    bool IBoneCast::QueueGeometryUpdate(
+        Game::ObjectHandle a_handle,
+        const std::string& a_nodeName,
+        BoneCastCache::CacheEntry& a_in,
+        const configNode_t& a_nodeConfig)
+    {
+        auto& stage = a_in.m_stage;
+        auto& conf = a_nodeConfig.fp.f32;
+
+        UpdateFilterStage(a_in, conf.bcWeightThreshold);
+
+        if (stage.m_filtered->empty())
+            return false;
+
+        if (stage.FindSimplified(conf.bcSimplifyTarget, conf.bcSimplifyTargetError))
+            return false;
 
+        m_Instance.m_simplifyQueue.Queue(
+            BoneCastCache::key_t(a_handle, a_nodeName),
+            a_in,
+            conf.bcSimplifyTarget,
+            conf.bcSimplifyTargetError);
+
+        return true;
     }
 
     bool IBoneCast::GetGeometry(
@@ -368,6 +659,93 @@ namespace CBP
         SKSE::g_taskInterface->AddTask(new BoneCastCreateTask1(m_handle, m_nodeName));
     }
 
+    void BoneCastBatchCreateTask0::Run()
+    {
+        stl::vector<Game::ObjectHandle> handles;
+        handles.reserve(m_keys.size());
+
+        for (auto& e : m_keys)
+            handles.emplace_back(e.first);
+
+        std::sort(handles.begin(), handles.end());
+        handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+
+        for (auto& e : handles)
+        {
+            auto actor = e.Resolve<Actor>();
+            if (actor)
+                CALL_MEMBER_FN(actor, QueueNiNodeUpdate)(true);
+        }
+
+        SKSE::g_taskInterface->AddTask(new BoneCastBatchCreateTask1(std::move(m_keys)));
+    }
+
+    void BoneCastBatchCreateTask1::Run()
+    {
+        IScopedCriticalSection _(DCBP::GetLock());
+
+        IBoneCast::UpdateBatch(m_keys);
+    }
+
+    void BoneCastBatchCommitTask::Run()
+    {
+        {
+            IScopedCriticalSection _(DCBP::GetLock());
+
+            IBoneCast::CommitBatch(*m_batch);
+        }
+
+        IBoneCast::m_Instance.m_batchTotal.store(0, std::memory_order_release);
+    }
+
+    void BoneCastPrefetchTask::Run()
+    {
+        stl::vector<std::pair<BoneCastCache::key_t, BoneCastCache::data_t>> entries;
+
+        IScopedCriticalSection _(DCBP::GetLock());
+
+        IBoneCast::m_Instance.m_iio.TakePrefetched(entries);
+
+        auto& cache = IBoneCast::GetCache();
+
+        size_t added(0);
+
+        for (auto& e : entries)
+        {
+            BoneCastCache::iterator it;
+            if (cache.Get(e.first.first, e.first.second, false, it))
+                continue;
+
+            cache.Add(e.first.first, e.first.second, std::move(e.second));
+            added++;
+        }
+
+        IBoneCast::m_Instance.Debug("Prefetched %zu/%zu bonecast entries", added, entries.size());
+    }
+
+    void BoneCastSimplifyTask::Run()
+    {
+        IScopedCriticalSection _(DCBP::GetLock());
+
+        auto& cache = IBoneCast::GetCache();
+
+        BoneCastCache::iterator it;
+        if (!cache.Get(m_key.first, m_key.second, false, it))
+            return;
+
+        auto& entry = it->second;
+
+        // discard if the filter stage was rebuilt while we were working
+        if (entry.m_stage.m_filtered != m_filtered)
+            return;
+
+        entry.m_stage.AddSimplified(m_target, m_targetError, m_indices, entry.m_data.first.m_vertices.size());
+        cache.UpdateSize(entry);
+
+        DCBP::DispatchActorTask(
+            m_key.first, ControllerInstruction::Action::UpdateConfig);
+    }
+
     void BoneCastCreateTask1::Run()
     {
         IScopedCriticalSection _(DCBP::GetLock());
@@ -413,13 +791,14 @@ namespace CBP
         if (it != m_data.end()) {
             m_totalSize -= it->second.m_size;
             it->second.m_data = std::forward<T>(a_data);
+            it->second.m_stage.Clear();
             it->second.m_lastAccess = PerfCounter::Query();
         }
         else {
             it = m_data.try_emplace(std::move(key), std::forward<T>(a_data)).first;
         }
 
-        it->second.m_size = it->second.m_data.GetSize();
+        it->second.m_size = it->second.m_data.GetSize() + it->second.m_stage.GetSize();
 
         m_totalSize += it->second.m_size;
 
@@ -430,7 +809,7 @@ namespace CBP
     {
         m_totalSize -= a_in.m_size;
         a_in.m_data.UpdateSize();
-        a_in.m_size = a_in.m_data.GetSize();
+        a_in.m_size = a_in.m_data.GetSize() + a_in.m_stage.GetSize();
         m_totalSize += a_in.m_size;
     }
 
@@ -489,13 +868,15 @@ namespace CBP
             return false;
 
         data_t tmp;
-        //{
+
+        if (!m_iio.TakePrefetched(key_t(a_handle, a_nodeName), tmp))
+        {
             //IScopedCriticalSection _(m_iio.GetLock());
-        if (!m_iio.Read(a_handle, a_nodeName, tmp))
-            return false;
-        //}
+            if (!m_iio.Read(a_handle, a_nodeName, tmp))
+                return false;
 
-        tmp.UpdateSize();
+            tmp.UpdateSize();
+        }
 
         a_result = Add(a_handle, a_nodeName, std::move(tmp));
 
@@ -537,21 +918,28 @@ namespace CBP
 
         if (result->second.m_data.second != a_nodeConfig) {
 
-            bool res = UpdateGeometry(
-                result->second.m_data,
-                a_nodeConfig.fp.f32.bcWeightThreshold,
-                a_nodeConfig.fp.f32.bcSimplifyTarget,
-                a_nodeConfig.fp.f32.bcSimplifyTargetError);
+            // while sliders are being dragged keep the current shape and let the worker catch up
+            bool deferred =
+                !result->second.m_data.second.m_indices.empty() &&
+                m_Instance.m_simplifyQueue.IsInteractive() &&
+                QueueGeometryUpdate(a_handle, a_nodeName, result->second, a_nodeConfig);
+
+            if (!deferred)
+            {
+                bool res = UpdateGeometry(
+                    result->second,
+                    a_nodeConfig);
 
-            cache.UpdateSize(result->second);
+                cache.UpdateSize(result->second);
 
-            if (!res)
-                return false;
+                if (!res)
+                    return false;
 
-            evict = true;
+                evict = true;
 
-            result->second.m_updateID.Update(); // not necessary atm
-            result->second.m_data.second = a_nodeConfig;
+                result->second.m_updateID.Update(); // not necessary atm
+                result->second.m_data.second = a_nodeConfig;
+            }
         }
 
         if (result->second.m_data.second.m_indices.empty())
@@ -591,97 +979,500 @@ namespace CBP
 
         cacheEntry.UpdateSize();
 
-        auto& cache = GetCache();
-        auto r = cache.Add(a_handle, a_nodeName, std::move(cacheEntry));
+        m_Instance.Debug("[%X] [%s]: %zu bytes (unpacked: %zu)",
+            a_handle, a_nodeName.c_str(), cacheEntry.GetSize(), cacheEntry.GetUnpackedSize());
 
-        /*auto& wq = DCBP::GetWriterQueue();
-        wq.Create<IBoneCastIO::TaskObjectWriter>(m_Instance.m_iio, a_handle, a_nodeName, r->second.m_data);*/
+        auto writeData = std::make_shared<BoneCastCache::data_t>();
+        writeData->first = cacheEntry.first;
 
-        if (!m_Instance.m_iio.Write(a_handle, a_nodeName, r->second.m_data))
-        {
-            m_Instance.m_iio.Error("[%X] write failed [%s]: %s",
-                a_handle, a_nodeName.c_str(), m_Instance.m_iio.GetLastException().what());
-        }
+        auto& cache = GetCache();
+        cache.Add(a_handle, a_nodeName, std::move(cacheEntry));
+
+        m_Instance.m_iio.QueueWrite(a_handle, a_nodeName, std::move(writeData));
 
         //_DMESSAGE("cache usage: %zu", cache.GetSize());
 
         return true;
     }
 
-    bool IBoneCastIO::Read(
-        Game::ObjectHandle a_handle,
-        const std::string& a_nodeName,
-        BoneCastCache::data_t& a_out)
+    void BoneCastCache::CacheEntry::StageCache::SetFilter(
+        float a_weightThreshold,
+        indices_t&& a_indices)
     {
-        try
-        {
-            auto& driverConf = DCBP::GetDriverConfig();
+        m_weightThreshold = a_weightThreshold;
+        m_filtered = std::make_shared<const indices_t>(std::move(a_indices));
+        m_simplified.clear();
+    }
 
-            auto path = driverConf.paths.boneCastData / MakeKey(a_handle, a_nodeName);
+    auto BoneCastCache::CacheEntry::StageCache::FindSimplified(
+        float a_target,
+        float a_targetError)
+        -> const IndexBuffer*
+    {
+        auto it = std::find_if(m_simplified.begin(), m_simplified.end(),
+            [&](auto& a_v) {
+                return a_v.m_target == a_target &&
+                    a_v.m_targetError == a_targetError;
+            });
 
-            std::ifstream ifs;
+        if (it == m_simplified.end())
+            return nullptr;
 
-            ifs.open(path, std::ifstream::in | std::ifstream::binary);
-            if (!ifs.is_open())
-                throw std::system_error(errno, std::system_category(), path.string());
+        // most recently used at the back
+        if (it != m_simplified.end() - 1)
+            std::rotate(it, it + 1, m_simplified.end());
 
-            using namespace boost::iostreams;
-            using namespace boost::archive;
+        return std::addressof(m_simplified.back().m_indices);
+    }
 
-            filtering_streambuf<input> in;
-            in.push(gzip_decompressor(zlib::default_window_bits, 1024 * 512));
-            in.push(ifs);
+    void BoneCastCache::CacheEntry::StageCache::AddSimplified(
+        float a_target,
+        float a_targetError,
+        const indices_t& a_indices,
+        size_t a_numVertices)
+    {
+        if (FindSimplified(a_target, a_targetError))
+            return;
 
-            binary_iarchive ia(in);
+        if (m_simplified.size() >= MAX_SIMPLIFIED)
+            m_simplified.erase(m_simplified.begin());
 
-            ia >> a_out;
+        auto& e = m_simplified.emplace_back(SimplifyResult{ a_target, a_targetError });
+        e.m_indices.Assign(a_indices, a_numVertices);
+    }
 
-            return true;
-        }
-        catch (const std::exception& e)
-        {
-            m_lastException = e;
-            return false;
-        }
+    void BoneCastCache::CacheEntry::StageCache::Clear()
+    {
+        m_filtered.reset();
+        m_simplified.clear();
     }
 
-    bool IBoneCastIO::Write(
-        Game::ObjectHandle a_handle,
-        const std::string& a_nodeName,
-        const BoneCastCache::data_t& a_in)
+    size_t BoneCastCache::CacheEntry::StageCache::GetSize() const
     {
-        try
-        {
-            auto& driverConf = DCBP::GetDriverConfig();
+        size_t size(0);
 
-            auto path = driverConf.paths.boneCastData / MakeKey(a_handle, a_nodeName);
+        if (m_filtered)
+            size += m_filtered->capacity() * sizeof(indices_t::value_type);
 
-            Serialization::CreateRootPath(path);
+        for (auto& e : m_simplified)
+            size += sizeof(SimplifyResult) + e.m_indices.GetSize();
 
-            auto tmpPath(path);
-            tmpPath += ".tmp";
+        return size;
+    }
 
-            try
-            {
-                {
-                    std::ofstream ofs;
-                    ofs.open(tmpPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    BoneCastSimplifyQueue::BoneCastSimplifyQueue(
+        long long a_debounce,
+        long long a_interactiveTimeout)
+        :
+        m_lastInteractive(0),
+        m_debounce(a_debounce),
+        m_interactiveTimeout(a_interactiveTimeout),
+        m_stop(false)
+    {
+    }
+
+    BoneCastSimplifyQueue::~BoneCastSimplifyQueue() noexcept
+    {
+        Stop();
+    }
+
+    void BoneCastSimplifyQueue::Queue(
+        const BoneCastCache::key_t& a_key,
+        const BoneCastCache::CacheEntry& a_entry,
+        float a_target,
+        float a_targetError)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_stop)
+            return;
+
+        auto& job = m_jobs[a_key];
+
+        if (job.m_filtered != a_entry.m_stage.m_filtered)
+        {
+            job.m_filtered = a_entry.m_stage.m_filtered;
+            job.m_vertices = a_entry.m_data.first.m_vertices;
+        }
+
+        job.m_target = a_target;
+        job.m_targetError = a_targetError;
+        job.m_queued = PerfCounter::Query();
+
+        if (!m_thread.joinable())
+            m_thread = std::thread(&BoneCastSimplifyQueue::Worker, this);
+
+        m_cond.notify_one();
+    }
+
+    bool BoneCastSimplifyQueue::IsPending(
+        const BoneCastCache::key_t& a_key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_jobs.find(a_key) != m_jobs.end();
+    }
+
+    void BoneCastSimplifyQueue::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_jobs.clear();
+        }
+
+        m_cond.notify_one();
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    void BoneCastSimplifyQueue::Worker()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (!m_stop)
+        {
+            if (m_jobs.empty()) {
+                m_cond.wait(lock);
+                continue;
+            }
+
+            auto now = PerfCounter::Query();
+
+            auto it = std::find_if(m_jobs.begin(), m_jobs.end(),
+                [&](auto& a_v) {
+                    return PerfCounter::delta_us(a_v.second.m_queued, now) >= m_debounce;
+                });
+
+            if (it == m_jobs.end()) {
+                m_cond.wait_for(lock, std::chrono::microseconds(m_debounce));
+                continue;
+            }
+
+            auto key = it->first;
+            auto job = std::move(it->second);
+
+            m_jobs.erase(it);
+
+            lock.unlock();
+
+            BoneCastSimplifyTask::indices_t indices;
+
+            IBoneCast::SimplifyGeometry(
+                job.m_vertices,
+                *job.m_filtered,
+                job.m_target,
+                job.m_targetError,
+                indices);
+
+            DTasks::AddTask<BoneCastSimplifyTask>(
+                key,
+                std::move(job.m_filtered),
+                job.m_target,
+                job.m_targetError,
+                std::move(indices));
+
+            lock.lock();
+        }
+    }
+
+    void IBoneCastIO::ReadFile(
+        const fs::path& a_path,
+        BoneCastCache::data_t& a_out)
+    {
+        std::ifstream ifs;
+
+        ifs.open(a_path, std::ifstream::in | std::ifstream::binary);
+        if (!ifs.is_open())
+            throw std::system_error(errno, std::system_category(), a_path.string());
+
+        using namespace boost::iostreams;
+        using namespace boost::archive;
+
+        char header[sizeof(Codec::header_t)];
+        ifs.read(header, sizeof(header));
+
+        if (Codec::HasHeader(header, static_cast<std::size_t>(ifs.gcount())))
+        {
+            ifs.seekg(0, std::ifstream::end);
+            auto size = static_cast<std::size_t>(ifs.tellg());
+            ifs.seekg(0, std::ifstream::beg);
+
+            stl::vector<char> data(size);
+            if (!ifs.read(data.data(), size))
+                throw std::exception("Couldn't read file");
+
+            stl::vector<char> decoded;
+            Codec::Decode(data.data(), data.size(), decoded);
+
+            stream<array_source> in(decoded.data(), decoded.size());
+            binary_iarchive ia(in);
+
+            ia >> a_out;
+
+            return;
+        }
+
+        ifs.clear();
+        ifs.seekg(0, std::ifstream::beg);
+
+        filtering_streambuf<input> in;
+        in.push(gzip_decompressor(zlib::default_window_bits, 1024 * 512));
+        in.push(ifs);
+
+        binary_iarchive ia(in);
+
+        ia >> a_out;
+    }
+
+    bool IBoneCastIO::Read(
+        Game::ObjectHandle a_handle,
+        const std::string& a_nodeName,
+        BoneCastCache::data_t& a_out)
+    {
+        write_data_t pending;
+        if (GetPendingWrite(BoneCastCache::key_t(a_handle, a_nodeName), pending))
+        {
+            a_out.first = pending->first;
+            return true;
+        }
+
+        try
+        {
+            ReadFile(GetFilePath(a_handle, a_nodeName), a_out);
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            m_lastException = e;
+            return false;
+        }
+    }
+
+    void IBoneCastIO::QueuePrefetch(
+        Game::ObjectHandle a_handle,
+        const std::string& a_nodeName)
+    {
+        BoneCastCache::key_t key(a_handle, a_nodeName);
+
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+        if (m_prefetchStop)
+            return;
+
+        if (m_prefetchPending.contains(key) ||
+            m_prefetchReady.contains(key))
+        {
+            return;
+        }
+
+        auto path = GetFilePath(a_handle, a_nodeName);
+
+        m_prefetchPending.emplace(key);
+        m_prefetchQueue.emplace(PrefetchRequest{ std::move(key), std::move(path) });
+
+        if (!m_prefetchThread.joinable())
+            m_prefetchThread = std::thread(&IBoneCastIO::PrefetchWorker, this);
+
+        m_prefetchCond.notify_one();
+    }
+
+    void IBoneCastIO::QueuePrefetch(Game::ObjectHandle a_handle)
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+        if (m_prefetchStop)
+            return;
+
+        m_prefetchActors.emplace(a_handle);
+
+        if (!m_prefetchThread.joinable())
+            m_prefetchThread = std::thread(&IBoneCastIO::PrefetchWorker, this);
+
+        m_prefetchCond.notify_one();
+    }
+
+    bool IBoneCastIO::TakePrefetched(
+        const BoneCastCache::key_t& a_key,
+        BoneCastCache::data_t& a_out)
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+        auto it = m_prefetchReady.find(a_key);
+        if (it == m_prefetchReady.end())
+        {
+            // still queued or in progress, the caller reads it directly
+            m_prefetchPending.erase(a_key);
+            return false;
+        }
 
-                    if (!ofs.is_open())
-                        throw std::system_error(errno, std::system_category(), tmpPath.string());
+        a_out = std::move(it->second);
+        m_prefetchReady.erase(it);
 
-                    using namespace boost::iostreams;
-                    using namespace boost::archive;
+        return true;
+    }
+
+    void IBoneCastIO::TakePrefetched(
+        stl::vector<std::pair<BoneCastCache::key_t, BoneCastCache::data_t>>& a_out)
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+
+        a_out.reserve(m_prefetchReady.size());
 
-                    filtering_streambuf<output> out;
-                    out.push(gzip_compressor(gzip_params(zlib::best_speed), 1024 * 512));
-                    out.push(ofs);
+        for (auto& e : m_prefetchReady)
+            a_out.emplace_back(e.first, std::move(e.second));
 
-                    binary_oarchive oa(out);
+        m_prefetchReady.clear();
+        m_prefetchCommitQueued = false;
+    }
+
+    void IBoneCastIO::PrefetchWorker()
+    {
+        std::unique_lock<std::mutex> lock(m_prefetchMutex);
+
+        for (;;)
+        {
+            m_prefetchCond.wait(lock, [&] {
+                return !m_prefetchQueue.empty() || !m_prefetchActors.empty() || m_prefetchStop;
+                });
+
+            if (m_prefetchStop)
+                break;
+
+            if (!m_prefetchActors.empty())
+            {
+                auto handle = m_prefetchActors.front();
+
+                lock.unlock();
+
+                // node config is resolved under the driver lock, back off
+                // instead of blocking on it so Stop() can't deadlock
+                bool resolved = IBoneCast::TryResolvePrefetch(handle);
+
+                lock.lock();
+
+                if (resolved)
+                    m_prefetchActors.pop();
+                else
+                    m_prefetchCond.wait_for(lock, std::chrono::milliseconds(2), [&] {
+                        return m_prefetchStop;
+                        });
+
+                continue;
+            }
 
-                    oa << a_in;
+            auto req = std::move(m_prefetchQueue.front());
+            m_prefetchQueue.pop();
+
+            // cancelled by a direct read
+            if (!m_prefetchPending.contains(req.m_key))
+                continue;
+
+            lock.unlock();
+
+            BoneCastCache::data_t data;
+            bool result;
+
+            write_data_t pending;
+            if (GetPendingWrite(req.m_key, pending))
+            {
+                data.first = pending->first;
+                result = true;
+            }
+            else
+            {
+                try
+                {
+                    ReadFile(req.m_path, data);
+                    result = true;
+                }
+                catch (const std::exception&)
+                {
+                    result = false;
                 }
+            }
+
+            lock.lock();
+
+            if (!m_prefetchPending.erase(req.m_key) || !result)
+                continue;
 
+            data.UpdateSize();
+
+            m_prefetchReady.insert_or_assign(req.m_key, std::move(data));
+
+            if (!m_prefetchCommitQueued)
+            {
+                m_prefetchCommitQueued = true;
+                DTasks::AddTask<BoneCastPrefetchTask>();
+            }
+        }
+    }
+
+    void IBoneCastIO::WriteTemp(
+        const fs::path& a_path,
+        const BoneCastCache::data_t& a_in)
+    {
+        std::ofstream ofs;
+        ofs.open(a_path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+        if (!ofs.is_open())
+            throw std::system_error(errno, std::system_category(), a_path.string());
+
+        using namespace boost::iostreams;
+        using namespace boost::archive;
+
+        auto codec = DCBP::GetDriverConfig().compression_codec;
+
+        if (codec != Codec::Type::Gzip)
+        {
+            stl::vector<char> data;
+
+            {
+                filtering_streambuf<output> out;
+                out.push(boost::iostreams::back_inserter(data));
+
+                binary_oarchive oa(out);
+
+                oa << a_in;
+            }
+
+            stl::vector<char> encoded;
+            Codec::Encode(codec, 1, data.data(), data.size(), encoded);
+
+            if (!ofs.write(encoded.data(), encoded.size()))
+                throw std::exception("Couldn't write file");
+
+            return;
+        }
+
+        filtering_streambuf<output> out;
+        out.push(gzip_compressor(gzip_params(zlib::best_speed), 1024 * 512));
+        out.push(ofs);
+
+        binary_oarchive oa(out);
+
+        oa << a_in;
+    }
+
+    bool IBoneCastIO::Write(
+        Game::ObjectHandle a_handle,
+        const std::string& a_nodeName,
+        const BoneCastCache::data_t& a_in)
+    {
+        try
+        {
+            auto path = GetFilePath(a_handle, a_nodeName);
+
+            Serialization::CreateRootPath(path);
+
+            auto tmpPath(path);
+            tmpPath += ".tmp";
+
+            try
+            {
+                WriteTemp(tmpPath, a_in);
                 fs::rename(tmpPath, path);
             }
             catch (const std::exception& e)
@@ -699,6 +1490,250 @@ namespace CBP
         }
     }
 
+    IBoneCastIO::IBoneCastIO() :
+        m_writerBusy(false),
+        m_writerStop(false),
+        m_prefetchCommitQueued(false),
+        m_prefetchStop(false)
+    {
+    }
+
+    IBoneCastIO::~IBoneCastIO() noexcept
+    {
+        Stop();
+    }
+
+    void IBoneCastIO::QueueWrite(
+        Game::ObjectHandle a_handle,
+        const std::string& a_nodeName,
+        write_data_t&& a_in)
+    {
+        auto path = GetFilePath(a_handle, a_nodeName);
+
+        {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+
+            if (!m_writerStop)
+            {
+                auto r = m_pendingWrites.insert_or_assign(
+                    BoneCastCache::key_t(a_handle, a_nodeName),
+                    PendingWrite{ std::move(path), std::move(a_in), PerfCounter::Query() });
+
+                if (!r.second)
+                    m_writeStats.superseded++;
+
+                m_writeStats.queued = m_pendingWrites.size();
+                m_writeStats.peakQueued = std::max(m_writeStats.peakQueued, m_writeStats.queued);
+
+                if (!m_writerThread.joinable())
+                    m_writerThread = std::thread(&IBoneCastIO::WriterWorker, this);
+
+                m_writerCond.notify_one();
+
+                return;
+            }
+        }
+
+        // writer is gone (shutting down), fall back to a synchronous write
+        if (!Write(a_handle, a_nodeName, *a_in))
+        {
+            Error("[%X] write failed [%s]: %s",
+                a_handle, a_nodeName.c_str(), m_lastException.what());
+        }
+    }
+
+    bool IBoneCastIO::GetPendingWrite(
+        const BoneCastCache::key_t& a_key,
+        write_data_t& a_out)
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+
+        auto it = m_pendingWrites.find(a_key);
+        if (it != m_pendingWrites.end()) {
+            a_out = it->second.m_data;
+            return true;
+        }
+
+        it = m_inflightWrites.find(a_key);
+        if (it != m_inflightWrites.end()) {
+            a_out = it->second.m_data;
+            return true;
+        }
+
+        return false;
+    }
+
+    void IBoneCastIO::Flush()
+    {
+        PerfTimer pt;
+        pt.Start();
+
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+
+        if (m_pendingWrites.empty() && !m_writerBusy)
+            return;
+
+        m_writerIdleCond.wait(lock, [&] {
+            return m_pendingWrites.empty() && !m_writerBusy;
+            });
+
+        Debug("%s: %fs", __FUNCTION__, pt.Stop());
+    }
+
+    void IBoneCastIO::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            m_prefetchStop = true;
+        }
+
+        m_prefetchCond.notify_one();
+
+        if (m_prefetchThread.joinable())
+            m_prefetchThread.join();
+
+        {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            m_writerStop = true;
+        }
+
+        m_writerCond.notify_one();
+
+        if (m_writerThread.joinable())
+            m_writerThread.join();
+    }
+
+    auto IBoneCastIO::GetWriteStats()
+        -> WriteStats
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        return m_writeStats;
+    }
+
+    bool IBoneCastIO::FlushFile(const fs::path& a_path)
+    {
+        auto handle = ::CreateFileW(
+            a_path.c_str(),
+            GENERIC_WRITE,
+            0,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+
+        if (handle == INVALID_HANDLE_VALUE)
+            return false;
+
+        bool result = ::FlushFileBuffers(handle) != FALSE;
+
+        ::CloseHandle(handle);
+
+        return result;
+    }
+
+    void IBoneCastIO::WriterWorker()
+    {
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+
+        for (;;)
+        {
+            m_writerCond.wait(lock, [&] {
+                return !m_pendingWrites.empty() || m_writerStop;
+                });
+
+            if (m_pendingWrites.empty())
+                break;
+
+            m_inflightWrites.swap(m_pendingWrites);
+            m_writeStats.queued = 0;
+            m_writerBusy = true;
+
+            lock.unlock();
+
+            struct written_t
+            {
+                const PendingWrite* entry;
+                fs::path tmpPath;
+            };
+
+            stl::vector<written_t> written;
+            written.reserve(m_inflightWrites.size());
+
+            uint64_t failed(0);
+
+            for (auto& e : m_inflightWrites)
+            {
+                auto tmpPath(e.second.m_path);
+                tmpPath += ".tmp";
+
+                try
+                {
+                    Serialization::CreateRootPath(e.second.m_path);
+                    WriteTemp(tmpPath, *e.second.m_data);
+
+                    written.emplace_back(written_t{ std::addressof(e.second), std::move(tmpPath) });
+                }
+                catch (const std::exception& ex)
+                {
+                    Serialization::SafeCleanup(tmpPath);
+
+                    Error("[%X] write failed [%s]: %s",
+                        e.first.first, e.first.second.c_str(), ex.what());
+
+                    failed++;
+                }
+            }
+
+            // one flush pass for the whole batch, then commit
+            for (auto& e : written)
+            {
+                if (!FlushFile(e.tmpPath))
+                    Warning("%s: flush failed (%lu)", e.tmpPath.string().c_str(), ::GetLastError());
+            }
+
+            long long latency(0);
+            uint64_t committed(0);
+
+            for (auto& e : written)
+            {
+                try
+                {
+                    fs::rename(e.tmpPath, e.entry->m_path);
+
+                    latency += PerfCounter::delta_us(e.entry->m_queued, PerfCounter::Query());
+                    committed++;
+                }
+                catch (const std::exception& ex)
+                {
+                    Serialization::SafeCleanup(e.tmpPath);
+
+                    Error("%s: rename failed: %s",
+                        e.entry->m_path.string().c_str(), ex.what());
+
+                    failed++;
+                }
+            }
+
+            lock.lock();
+
+            m_inflightWrites.clear();
+            m_writerBusy = false;
+
+            m_writeStats.batches++;
+            m_writeStats.written += committed;
+            m_writeStats.failed += failed;
+            m_writeStats.totalLatency += latency;
+
+            if (committed)
+                m_writeStats.lastLatency = latency / static_cast<long long>(committed);
+
+            m_writerIdleCond.notify_all();
+        }
+
+        m_writerBusy = false;
+        m_writerIdleCond.notify_all();
+    }
+
     const pluginInfo_t* IBoneCastIO::GetPluginInfo(
         Game::FormID a_formid)
     {
@@ -725,9 +1760,7 @@ namespace CBP
 
         auto modInfo = GetPluginInfo(formID);
         if (modInfo) {
-            std::string mn(modInfo->name);
-            std::transform(mn.begin(), mn.end(), mn.begin(), ::tolower);
-            ss << modInfo->GetFormIDLower(formID) << "." << mn;
+            ss << modInfo->GetFormIDLower(formID) << "." << modInfo->lowerName;
         }
         else {
             ss << formID;
@@ -738,17 +1771,30 @@ namespace CBP
         return Crypto::SHA1(ss.str());
     }
 
-    /*void IBoneCastIO::TaskObjectWriter::Run()
+    fs::path IBoneCastIO::GetFilePath(
+        Game::ObjectHandle a_handle,
+        const std::string& a_nodeName)
     {
-        bool res;
+        std::lock_guard<std::mutex> lock(m_pathTableMutex);
+
+        auto& nodes = m_pathTable[a_handle.GetFormID()];
+
+        auto it = nodes.find(a_nodeName);
+        if (it == nodes.end())
         {
-            IScopedCriticalSection _(m_parent.GetLock());
-            res = m_parent.Write(m_handle, m_nodeName, m_data);
-        }
+            auto& driverConf = DCBP::GetDriverConfig();
 
-        if (!res) {
-            m_parent.Error("[%X] write failed [%s]: %s", m_handle, m_nodeName.c_str(), m_parent.m_lastException.what());
+            it = nodes.emplace(a_nodeName,
+                driverConf.paths.boneCastData / MakeKey(a_handle, a_nodeName)).first;
         }
-    }*/
+
+        return it->second;
+    }
+
+    void IBoneCastIO::ClearPathTable()
+    {
+        std::lock_guard<std::mutex> lock(m_pathTableMutex);
+        m_pathTable.clear();
+    }
 
 }
\ No newline at end of file
@@ -113,7 +113,51 @@ namespace CBP
             {
             }
 
+            struct StageCache
+            {
+                using indices_t = stl::vector<int>;
+                using filtered_t = std::shared_ptr<const indices_t>;
+
+                static constexpr size_t MAX_SIMPLIFIED = 8;
+
+                struct SimplifyResult
+                {
+                    float m_target;
+                    float m_targetError;
+                    IndexBuffer m_indices;
+                };
+
+                StageCache() :
+                    m_weightThreshold(0.0f)
+                {}
+
+                [[nodiscard]] SKMP_FORCEINLINE bool HasFilter(float a_weightThreshold) const {
+                    return m_filtered && m_weightThreshold == a_weightThreshold;
+                }
+
+                void SetFilter(float a_weightThreshold, indices_t&& a_indices);
+
+                [[nodiscard]] const IndexBuffer* FindSimplified(
+                    float a_target,
+                    float a_targetError);
+
+                void AddSimplified(
+                    float a_target,
+                    float a_targetError,
+                    const indices_t& a_indices,
+                    size_t a_numVertices);
+
+                void Clear();
+
+                [[nodiscard]] size_t GetSize() const;
+
+                float m_weightThreshold;
+                filtered_t m_filtered;
+                stl::vector<SimplifyResult> m_simplified;
+            };
+
             data_t m_data;
+            StageCache m_stage;
 
             size_t m_size;
             long long m_lastAccess;
@@ -187,37 +231,229 @@ namespace CBP
 
     };
 
+    class BoneCastSimplifyTask :
+        public TaskDelegate
+    {
+    public:
+
+        using filtered_t = BoneCastCache::CacheEntry::StageCache::filtered_t;
+        using indices_t = BoneCastCache::CacheEntry::StageCache::indices_t;
+
+        BoneCastSimplifyTask(
+            const BoneCastCache::key_t& a_key,
+            filtered_t&& a_filtered,
+            float a_target,
+            float a_targetError,
+            indices_t&& a_indices)
+            :
+            m_key(a_key),
+            m_filtered(std::move(a_filtered)),
+            m_target(a_target),
+            m_targetError(a_targetError),
+            m_indices(std::move(a_indices))
+        {}
+
+        virtual void Run();
+        virtual void Dispose() {
+            delete this;
+        }
+
+    private:
+
+        BoneCastCache::key_t m_key;
+        filtered_t m_filtered;
+        float m_target;
+        float m_targetError;
+        indices_t m_indices;
+    };
+
+    class BoneCastPrefetchTask :
+        public TaskDelegate
+    {
+    public:
+
+        virtual void Run();
+        virtual void Dispose() {
+            delete this;
+        }
+    };
+
+    class BoneCastBatchCreateTask0 :
+        public TaskDelegate
+    {
+    public:
+
+        BoneCastBatchCreateTask0(
+            stl::vector<BoneCastCache::key_t>&& a_keys)
+            :
+            m_keys(std::move(a_keys))
+        {}
+
+        virtual void Run();
+        virtual void Dispose() {
+            delete this;
+        }
+
+    private:
+
+        stl::vector<BoneCastCache::key_t> m_keys;
+    };
+
+    class BoneCastBatchCreateTask1 :
+        public TaskDelegate
+    {
+    public:
+
+        BoneCastBatchCreateTask1(
+            stl::vector<BoneCastCache::key_t>&& a_keys)
+            :
+            m_keys(std::move(a_keys))
+        {}
+
+        virtual void Run();
+        virtual void Dispose() {
+            delete this;
+        }
+
+    private:
+
+        stl::vector<BoneCastCache::key_t> m_keys;
+    };
+
+    struct BoneCastBatch
+    {
+        struct Item
+        {
+            BoneCastCache::key_t m_key;
+            configNode_t m_nodeConfig;
+            BoneCastCache::data_t m_data;
+            BoneCastCache::CacheEntry::StageCache::indices_t m_filtered;
+            BoneCastCache::CacheEntry::StageCache::indices_t m_simplified;
+            bool m_result;
+        };
+
+        stl::vector<Item> m_items;
+        std::atomic<size_t> m_done;
+        long long m_started;
+    };
+
+    class BoneCastBatchCommitTask :
+        public TaskDelegate
+    {
+    public:
+
+        BoneCastBatchCommitTask(
+            const std::shared_ptr<BoneCastBatch>& a_batch)
+            :
+            m_batch(a_batch)
+        {}
+
+        virtual void Run();
+        virtual void Dispose() {
+            delete this;
+        }
+
+    private:
+
+        std::shared_ptr<BoneCastBatch> m_batch;
+    };
+
+    class BoneCastSimplifyQueue
+    {
+        struct Job
+        {
+            BoneCastCache::CacheEntry::StageCache::filtered_t m_filtered;
+            QuantizedVertices m_vertices;
+            float m_target;
+            float m_targetError;
+            long long m_queued;
+        };
+
+    public:
+
+        BoneCastSimplifyQueue(
+            long long a_debounce,
+            long long a_interactiveTimeout);
+
+        virtual ~BoneCastSimplifyQueue() noexcept;
+
+        void Queue(
+            const BoneCastCache::key_t& a_key,
+            const BoneCastCache::CacheEntry& a_entry,
+            float a_target,
+            float a_targetError);
+
+        [[nodiscard]] bool IsPending(
+            const BoneCastCache::key_t& a_key);
+
+        void Stop();
+
+        SKMP_FORCEINLINE void MarkInteractive() {
+            m_lastInteractive.store(PerfCounter::Query(), std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE bool IsInteractive() const {
+            return PerfCounter::delta_us(
+                m_lastInteractive.load(std::memory_order_relaxed),
+                PerfCounter::Query()) < m_interactiveTimeout;
+        }
+
+    private:
+
+        void Worker();
+
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+
+        stl::iunordered_map<BoneCastCache::key_t, Job> m_jobs;
+
+        std::atomic<long long> m_lastInteractive;
+        long long m_debounce;
+        long long m_interactiveTimeout;
+        bool m_stop;
+    };
+
     class IBoneCastIO :
         public ILog
     {        
     public:
 
-        /*class TaskObjectWriter :
-            public TaskObject
+        using write_data_t = std::shared_ptr<const BoneCastCache::data_t>;
+
+        struct WriteStats
         {
-        public:
+            size_t queued{ 0 };
+            size_t peakQueued{ 0 };
+            uint64_t written{ 0 };
+            uint64_t superseded{ 0 };
+            uint64_t failed{ 0 };
+            uint64_t batches{ 0 };
+            long long lastLatency{ 0 };
+            long long totalLatency{ 0 };
+        };
 
-            TaskObjectWriter(
-                IBoneCastIO& a_parent,
-                Game::ObjectHandle a_handle,
-                const std::string& a_nodeName,
-                const BoneCastCache::data_t& a_in)
-                :
-                m_parent(a_parent),
-                m_handle(a_handle),
-                m_nodeName(a_nodeName),
-                m_data(a_in)
-            {}
+    private:
+
+        struct PendingWrite
+        {
+            fs::path m_path;
+            write_data_t m_data;
+            long long m_queued;
+        };
 
-            virtual void Run();
+        using pending_t = stl::iunordered_map<BoneCastCache::key_t, PendingWrite>;
 
-        private:
-            Game::ObjectHandle m_handle;
-            std::string m_nodeName;
-            BoneCastCache::data_t m_data;
+        struct PrefetchRequest
+        {
+            BoneCastCache::key_t m_key;
+            fs::path m_path;
+        };
+
+    public:
 
-            IBoneCastIO& m_parent;
-        };*/
+        IBoneCastIO();
+        virtual ~IBoneCastIO() noexcept;
 
         bool Read(
             Game::ObjectHandle a_handle,
@@ -229,6 +465,30 @@ namespace CBP
             const std::string& a_nodeName,
             const BoneCastCache::data_t& a_in);
 
+        void QueueWrite(
+            Game::ObjectHandle a_handle,
+            const std::string& a_nodeName,
+            write_data_t&& a_in);
+
+        void Flush();
+        void Stop();
+
+        [[nodiscard]] WriteStats GetWriteStats();
+
+        void QueuePrefetch(
+            Game::ObjectHandle a_handle,
+            const std::string& a_nodeName);
+
+        // nodes are resolved on the prefetch thread
+        void QueuePrefetch(Game::ObjectHandle a_handle);
+
+        [[nodiscard]] bool TakePrefetched(
+            const BoneCastCache::key_t& a_key,
+            BoneCastCache::data_t& a_out);
+
+        void TakePrefetched(
+            stl::vector<std::pair<BoneCastCache::key_t, BoneCastCache::data_t>>& a_out);
+
         [[nodiscard]] SKMP_FORCEINLINE auto GetLock() {
             return std::addressof(m_rwLock);
         }
@@ -237,8 +497,16 @@ namespace CBP
             return m_lastException;
         }
 
+        void ClearPathTable();
+
     private:
 
+        // file path for (form, node), keys only depend on the form so the
+        // table is kept per form and dropped on revert
+        [[nodiscard]] fs::path GetFilePath(
+            Game::ObjectHandle a_handle,
+            const std::string& a_nodeName);
+
         [[nodiscard]] std::string MakeKey(
             Game::ObjectHandle a_handle,
             const std::string& a_nodeName);
@@ -247,8 +515,53 @@ namespace CBP
             Game::FormID a_formid
         );
 
+        [[nodiscard]] bool GetPendingWrite(
+            const BoneCastCache::key_t& a_key,
+            write_data_t& a_out);
+
+        void WriteTemp(
+            const fs::path& a_path,
+            const BoneCastCache::data_t& a_in);
+
+        void ReadFile(
+            const fs::path& a_path,
+            BoneCastCache::data_t& a_out);
+
+        void PrefetchWorker();
+
+        static bool FlushFile(const fs::path& a_path);
+
+        void WriterWorker();
+
         ICriticalSection m_rwLock;
 
+        std::mutex m_pathTableMutex;
+        stl::unordered_map<Game::FormID, stl::unordered_map<std::string, fs::path>> m_pathTable;
+
+        std::thread m_writerThread;
+        std::mutex m_writerMutex;
+        std::condition_variable m_writerCond;
+        std::condition_variable m_writerIdleCond;
+
+        pending_t m_pendingWrites;
+        pending_t m_inflightWrites;
+
+        bool m_writerBusy;
+        bool m_writerStop;
+
+        WriteStats m_writeStats;
+
+        std::thread m_prefetchThread;
+        std::mutex m_prefetchMutex;
+        std::condition_variable m_prefetchCond;
+
+        std::queue<PrefetchRequest> m_prefetchQueue;
+        std::queue<Game::ObjectHandle> m_prefetchActors;
+        stl::iunordered_set<BoneCastCache::key_t> m_prefetchPending;
+        stl::iunordered_map<BoneCastCache::key_t, BoneCastCache::data_t> m_prefetchReady;
+        bool m_prefetchCommitQueued;
+        bool m_prefetchStop;
+
         except::descriptor m_lastException;
     };
 
@@ -257,6 +570,9 @@ namespace CBP
         public ILog
     {
         friend class BoneCastCreateTask;
+        friend class BoneCastSimplifyTask;
+        friend class BoneCastPrefetchTask;
+        friend class BoneCastBatchCommitTask;
 
         struct Triangle
         {
@@ -305,6 +621,60 @@ namespace CBP
             return m_Instance.m_cache.GetSize();
         }
 
+        SKMP_FORCEINLINE static void MarkInteractive() {
+            m_Instance.m_simplifyQueue.MarkInteractive();
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE static bool IsSimplifyPending(
+            Game::ObjectHandle a_handle,
+            const std::string& a_nodeName)
+        {
+            return m_Instance.m_simplifyQueue.IsPending(
+                BoneCastCache::key_t(a_handle, a_nodeName));
+        }
+
+        static void Release();
+
+        static bool UpdateBatch(
+            const stl::vector<BoneCastCache::key_t>& a_keys);
+
+        [[nodiscard]] SKMP_FORCEINLINE static bool IsBatchRunning() {
+            return m_Instance.m_batchTotal.load(std::memory_order_acquire) != 0;
+        }
+
+        SKMP_FORCEINLINE static void GetBatchProgress(size_t& a_done, size_t& a_total) {
+            a_total = m_Instance.m_batchTotal.load(std::memory_order_acquire);
+            a_done = m_Instance.m_batchDone.load(std::memory_order_acquire);
+        }
+
+        static void Prefetch(
+            Game::ObjectHandle a_handle,
+            const configNodes_t& a_nodeConfig);
+
+        // doesn't need the driver lock, node config is resolved (actor/race/global) by the IO thread
+        static void Prefetch(Game::ObjectHandle a_handle);
+
+        [[nodiscard]] static bool TryResolvePrefetch(Game::ObjectHandle a_handle);
+
+        SKMP_FORCEINLINE static void FlushWrites() {
+            m_Instance.m_iio.Flush();
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE static auto GetWriteStats() {
+            return m_Instance.m_iio.GetWriteStats();
+        }
+
+        SKMP_FORCEINLINE static void ClearPathTable() {
+            m_Instance.m_iio.ClearPathTable();
+        }
+
+        static bool SimplifyGeometry(
+            const QuantizedVertices& a_vertices,
+            const stl::vector<int>& a_indices,
+            float a_simplifyTarget,
+            float a_simplifyTargetError,
+            stl::vector<int>& a_out);
+
         static bool ExtractGeometry(
             Actor* a_actor,
             const BSFixedString& a_nodeName,
@@ -331,14 +701,43 @@ namespace CBP
             const std::string& a_shape,
             ColliderDataStorage& a_result);
 
+        static void FilterGeometry(
+            const ColliderDataStorage& a_in,
+            float a_weightThreshold,
+            stl::vector<int>& a_out);
+
+        static void UpdateFilterStage(
+            BoneCastCache::CacheEntry& a_in,
+            float a_weightThreshold);
+
         static bool UpdateGeometry(
+            BoneCastCache::CacheEntry& a_in,
+            const configNode_t& a_nodeConfig);
+
+        static bool QueueGeometryUpdate(
+            Game::ObjectHandle a_handle,
+            const std::string& a_nodeName,
+            BoneCastCache::CacheEntry& a_in,
+            const configNode_t& a_nodeConfig);
+
+        static void SetResultIndices(
             BoneCastCache::data_t& a_in,
-            float a_weightThreshold,
-            float a_simplifyTarget,
-            float a_simplifyTargetError);
+            const stl::vector<int>& a_indices);
+
+        static void SetResultIndices(
+            BoneCastCache::data_t& a_in,
+            const IndexBuffer& a_indices);
+
+        static void ProcessBatchItem(BoneCastBatch::Item& a_item);
+        static void CommitBatch(BoneCastBatch& a_batch);
 
         BoneCastCache m_cache;
         IBoneCastIO m_iio;
+        BoneCastSimplifyQueue m_simplifyQueue;
+        ThreadPool m_threadPool;
+
+        std::atomic<size_t> m_batchDone;
+        std::atomic<size_t> m_batchTotal;
 
         static IBoneCast m_Instance;
     };
@@ -22,4 +22,141 @@ namespace CBP
 
         return m_meta;
     }
+
+    void QuantizedVertices::Encode(const MeshPoint* a_in, size_t a_count)
+    {
+        m_data.clear();
+
+        if (!a_count) {
+            m_data.shrink_to_fit();
+            return;
+        }
+
+        btScalar max[3];
+
+        m_min[0] = max[0] = a_in[0].x;
+        m_min[1] = max[1] = a_in[0].y;
+        m_min[2] = max[2] = a_in[0].z;
+
+        for (size_t i = 1; i < a_count; i++)
+        {
+            auto& e = a_in[i];
+
+            m_min[0] = std::min(m_min[0], e.x);
+            m_min[1] = std::min(m_min[1], e.y);
+            m_min[2] = std::min(m_min[2], e.z);
+
+            max[0] = std::max(max[0], e.x);
+            max[1] = std::max(max[1], e.y);
+            max[2] = std::max(max[2], e.z);
+        }
+
+        constexpr btScalar range = static_cast<btScalar>(std::numeric_limits<uint16_t>::max());
+
+        btScalar inv[3];
+
+        for (int i = 0; i < 3; i++)
+        {
+            auto extent = max[i] - m_min[i];
+
+            if (extent > 0.0f) {
+                m_scale[i] = extent / range;
+                inv[i] = range / extent;
+            }
+            else {
+                m_scale[i] = 0.0f;
+                inv[i] = 0.0f;
+            }
+        }
+
+        m_data.resize(a_count * 3);
+        m_data.shrink_to_fit();
+
+        for (size_t i = 0, j = 0; i < a_count; i++, j += 3)
+        {
+            auto& e = a_in[i];
+
+            m_data[j] = static_cast<uint16_t>(std::clamp((e.x - m_min[0]) * inv[0] + 0.5f, 0.0f, range));
+            m_data[j + 1] = static_cast<uint16_t>(std::clamp((e.y - m_min[1]) * inv[1] + 0.5f, 0.0f, range));
+            m_data[j + 2] = static_cast<uint16_t>(std::clamp((e.z - m_min[2]) * inv[2] + 0.5f, 0.0f, range));
+        }
+    }
+
+    void QuantizedVertices::Decode(MeshPoint* a_out) const
+    {
+        auto count = size();
+
+        for (size_t i = 0; i < count; i++)
+            a_out[i] = (*this)[i];
+    }
+
+    void QuantizedVertices::Decode(stl::vector<MeshPoint>& a_out) const
+    {
+        a_out.resize(size());
+        Decode(a_out.data());
+    }
+
+    void IndexBuffer::Assign(const int* a_in, size_t a_count, size_t a_numVertices)
+    {
+        Clear();
+
+        if (!a_count)
+            return;
+
+        if (a_numVertices <= size_t(std::numeric_limits<uint16_t>::max()) + 1)
+        {
+            m_data16.resize(a_count);
+            for (size_t i = 0; i < a_count; i++)
+                m_data16[i] = static_cast<uint16_t>(a_in[i]);
+        }
+        else
+        {
+            m_data32.resize(a_count);
+            for (size_t i = 0; i < a_count; i++)
+                m_data32[i] = static_cast<uint32_t>(a_in[i]);
+        }
+    }
+
+    void IndexBuffer::CopyTo(int* a_out) const
+    {
+        if (m_data32.empty())
+            std::copy(m_data16.begin(), m_data16.end(), a_out);
+        else
+            std::copy(m_data32.begin(), m_data32.end(), a_out);
+    }
+
+    void IndexBuffer::CopyTo(stl::vector<int>& a_out) const
+    {
+        a_out.resize(size());
+        CopyTo(a_out.data());
+    }
+
+    void ColliderData::GenerateHullPoints()
+    {
+        // one point per referenced vertex, the hull doesn't need duplicates
+
+        stl::vector<bool> used(static_cast<size_t>(m_numVertices), false);
+
+        int count(0);
+
+        for (int i = 0; i < m_numIndices; i++)
+        {
+            auto index = m_indices[i];
+
+            if (!used[index]) {
+                used[index] = true;
+                count++;
+            }
+        }
+
+        m_hullPoints = std::make_shared<MeshPoint[]>(static_cast<size_t>(count));
+
+        for (int i = 0, j = 0; i < m_numVertices; i++)
+        {
+            if (used[i])
+                m_hullPoints[j++] = m_vertices[i];
+        }
+
+        m_numHullPoints = count;
+    }
 }
\ No newline at end of file
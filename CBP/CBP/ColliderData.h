@@ -37,6 +37,128 @@ namespace CBP
         BOOST_SERIALIZATION_SPLIT_MEMBER()
     };
 
+    struct QuantizedVertices
+    {
+        friend class boost::serialization::access;
+
+        enum Serialization : unsigned int
+        {
+            DataVersion1 = 1
+        };
+
+    public:
+
+        QuantizedVertices() :
+            m_min{ 0.0f, 0.0f, 0.0f },
+            m_scale{ 0.0f, 0.0f, 0.0f }
+        {}
+
+        void Encode(const MeshPoint* a_in, size_t a_count);
+        void Decode(MeshPoint* a_out) const;
+        void Decode(stl::vector<MeshPoint>& a_out) const;
+
+        [[nodiscard]] SKMP_FORCEINLINE MeshPoint operator[](size_t a_index) const
+        {
+            auto p = std::addressof(m_data[a_index * 3]);
+
+            return MeshPoint{
+                m_min[0] + static_cast<btScalar>(p[0]) * m_scale[0],
+                m_min[1] + static_cast<btScalar>(p[1]) * m_scale[1],
+                m_min[2] + static_cast<btScalar>(p[2]) * m_scale[2]
+            };
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE size_t size() const {
+            return m_data.size() / 3;
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE bool empty() const {
+            return m_data.empty();
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE size_t GetSize() const {
+            return m_data.capacity() * sizeof(decltype(m_data)::value_type);
+        }
+
+        SKMP_FORCEINLINE void Clear() {
+            if (!m_data.empty())
+                m_data.swap(decltype(m_data)());
+        }
+
+    private:
+
+        template<class Archive>
+        void serialize(Archive& ar, const unsigned int version) {
+            ar& m_min;
+            ar& m_scale;
+            ar& m_data;
+        }
+
+        btScalar m_min[3];
+        btScalar m_scale[3];
+        stl::vector<uint16_t> m_data;
+    };
+
+    struct IndexBuffer
+    {
+        friend class boost::serialization::access;
+
+        enum Serialization : unsigned int
+        {
+            DataVersion1 = 1
+        };
+
+    public:
+
+        // 16-bit storage when all indices fit
+        void Assign(const int* a_in, size_t a_count, size_t a_numVertices);
+
+        SKMP_FORCEINLINE void Assign(const stl::vector<int>& a_in, size_t a_numVertices) {
+            Assign(a_in.data(), a_in.size(), a_numVertices);
+        }
+
+        void CopyTo(int* a_out) const;
+        void CopyTo(stl::vector<int>& a_out) const;
+
+        [[nodiscard]] SKMP_FORCEINLINE int operator[](size_t a_index) const {
+            return m_data32.empty() ?
+                static_cast<int>(m_data16[a_index]) :
+                static_cast<int>(m_data32[a_index]);
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE size_t size() const {
+            return m_data32.empty() ? m_data16.size() : m_data32.size();
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE bool empty() const {
+            return m_data16.empty() && m_data32.empty();
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE size_t GetSize() const {
+            return
+                m_data16.capacity() * sizeof(decltype(m_data16)::value_type) +
+                m_data32.capacity() * sizeof(decltype(m_data32)::value_type);
+        }
+
+        SKMP_FORCEINLINE void Clear() {
+            if (!m_data16.empty())
+                m_data16.swap(decltype(m_data16)());
+            if (!m_data32.empty())
+                m_data32.swap(decltype(m_data32)());
+        }
+
+    private:
+
+        template<class Archive>
+        void serialize(Archive& ar, const unsigned int version) {
+            ar& m_data16;
+            ar& m_data32;
+        }
+
+        stl::vector<uint16_t> m_data16;
+        stl::vector<uint32_t> m_data32;
+    };
+
     struct ColliderDataStorage;
     struct ColliderDataStoragePair;
 
@@ -115,6 +237,7 @@ namespace CBP
         }
 
         void GenerateTriVertexArray();
+        void GenerateHullPoints();
 
         std::shared_ptr<MeshPoint[]> m_vertices;
         std::shared_ptr<MeshPoint[]> m_hullPoints;
@@ -123,6 +246,7 @@ namespace CBP
         int m_numVertices;
         int m_numTriangles;
         int m_numIndices;
+        int m_numHullPoints;
 
         btTriangleIndexVertexArray* m_triVertexArray;
 
@@ -145,6 +269,7 @@ namespace CBP
         m_numVertices = a_rhs.m_numVertices;
         m_numTriangles = a_rhs.m_numTriangles;
         m_numIndices = a_rhs.m_numIndices;
+        m_numHullPoints = a_rhs.m_numHullPoints;
 
         m_triVertexArray = a_rhs.m_triVertexArray;
         a_rhs.m_triVertexArray = nullptr;
@@ -159,6 +284,7 @@ namespace CBP
         m_numVertices = a_rhs.m_numVertices;
         m_numTriangles = a_rhs.m_numTriangles;
         m_numIndices = a_rhs.m_numIndices;
+        m_numHullPoints = a_rhs.m_numHullPoints;
 
         GenerateTriVertexArray();
     }
@@ -181,7 +307,8 @@ namespace CBP
 
         enum Serialization : unsigned int
         {
-            DataVersion1 = 1
+            DataVersion1 = 1,
+            DataVersion2 = 2
         };
 
         struct Meta
@@ -211,7 +338,7 @@ namespace CBP
         };
 
     public:
-        ColliderDataStorage() : m_numTriangles(0) {}
+        ColliderDataStorage() : m_numTriangles(0), m_size(0) {}
 
         ColliderDataStorage(const ColliderData& a_rhs) {
             __copy(a_rhs);
@@ -229,13 +356,21 @@ namespace CBP
             return m_size;
         }
 
+        // size of the same data in the unpacked (float/int, one hull point per index) layout
+        [[nodiscard]] SKMP_FORCEINLINE size_t GetUnpackedSize() const {
+            return
+                sizeof(ColliderDataStorage) +
+                m_vertices.size() * sizeof(MeshPoint) +
+                m_weights.size() * sizeof(decltype(m_weights)::value_type) +
+                m_indices.size() * (sizeof(int) + sizeof(MeshPoint));
+        }
+
         SKMP_FORCEINLINE void UpdateSize();
         SKMP_FORCEINLINE void Clear();
 
-        stl::vector<MeshPoint> m_vertices;
+        QuantizedVertices m_vertices;
         stl::vector<float> m_weights;
-        stl::vector<MeshPoint> m_hullPoints;
-        stl::vector<int> m_indices;
+        IndexBuffer m_indices;
 
         int m_numTriangles;
 
@@ -245,7 +380,6 @@ namespace CBP
         void save(Archive& ar, const unsigned int version) const {
             ar& m_vertices;
             ar& m_weights;
-            ar& m_hullPoints;
             ar& m_indices;
 
             ar& m_numTriangles;
@@ -253,10 +387,26 @@ namespace CBP
         
         template<class Archive>
         void load(Archive& ar, const unsigned int version) {
-            ar& m_vertices;
-            ar& m_weights;
-            ar& m_hullPoints;
-            ar& m_indices;
+            if (version >= DataVersion2)
+            {
+                ar& m_vertices;
+                ar& m_weights;
+                ar& m_indices;
+            }
+            else
+            {
+                stl::vector<MeshPoint> vertices;
+                stl::vector<MeshPoint> hullPoints;
+                stl::vector<int> indices;
+
+                ar& vertices;
+                ar& m_weights;
+                ar& hullPoints;
+                ar& indices;
+
+                m_vertices.Encode(vertices.data(), vertices.size());
+                m_indices.Assign(indices, vertices.size());
+            }
 
             ar& m_numTriangles;
         }
@@ -276,25 +426,19 @@ namespace CBP
     {
         m_size =
             sizeof(ColliderDataStorage) +
-            m_vertices.capacity() * sizeof(decltype(m_vertices)::value_type) +
+            m_vertices.GetSize() +
             m_weights.capacity() * sizeof(decltype(m_weights)::value_type) +
-            m_hullPoints.capacity() * sizeof(decltype(m_hullPoints)::value_type) +
-            m_indices.capacity() * sizeof(decltype(m_indices)::value_type);
+            m_indices.GetSize();
     }
 
     void ColliderDataStorage::Clear()
     {
-        if (!m_vertices.empty())
-            m_vertices.swap(decltype(m_vertices)());
+        m_vertices.Clear();
 
         if (!m_weights.empty())
             m_weights.swap(decltype(m_weights)());
 
-        if (!m_hullPoints.empty())
-            m_hullPoints.swap(decltype(m_hullPoints)());
-
-        if (!m_indices.empty())
-            m_indices.swap(decltype(m_indices)());
+        m_indices.Clear();
 
         m_numTriangles = 0;
     }
@@ -320,6 +464,10 @@ namespace CBP
             second.UpdateSize();
         }
 
+        [[nodiscard]] SKMP_FORCEINLINE size_t GetUnpackedSize() const {
+            return first.GetUnpackedSize() + second.GetUnpackedSize();
+        }
+
     private:
         template<class Archive>
         void save(Archive& ar, const unsigned int version) const {
@@ -337,19 +485,17 @@ namespace CBP
     SKMP_FORCEINLINE void ColliderDataStorage::__copy(const ColliderData& a_rhs)
     {
         if (a_rhs.m_numVertices > 0) {
-            m_vertices = decltype(m_vertices)(a_rhs.m_vertices.get(), a_rhs.m_vertices.get() + a_rhs.m_numVertices);
+            m_vertices.Encode(a_rhs.m_vertices.get(), static_cast<size_t>(a_rhs.m_numVertices));
         }
         else {
-            m_vertices.swap(decltype(m_vertices)());
+            m_vertices.Clear();
         }
 
         if (a_rhs.m_numIndices > 0) {
-            m_hullPoints = decltype(m_hullPoints)(a_rhs.m_hullPoints.get(), a_rhs.m_hullPoints.get() + a_rhs.m_numIndices);
-            m_indices = decltype(m_indices)(a_rhs.m_indices.get(), a_rhs.m_indices.get() + a_rhs.m_numIndices);
+            m_indices.Assign(a_rhs.m_indices.get(), static_cast<size_t>(a_rhs.m_numIndices), m_vertices.size());
         }
         else {
-            m_hullPoints.swap(decltype(m_hullPoints)());
-            m_indices.swap(decltype(m_indices)());
+            m_indices.Clear();
         }
 
         m_numTriangles = a_rhs.m_numTriangles;
@@ -357,55 +503,43 @@ namespace CBP
         UpdateSize();
     }
 
+    // expansion to float happens only here, right before a bullet shape is built
+
     SKMP_FORCEINLINE void ColliderData::__copy(const ColliderDataStorage& a_rhs)
     {
         m_vertices = std::make_shared<MeshPoint[]>(a_rhs.m_vertices.size());
-        m_hullPoints = std::make_shared<MeshPoint[]>(a_rhs.m_hullPoints.size());
         m_indices = std::make_shared<int[]>(a_rhs.m_indices.size());
 
-        std::copy(a_rhs.m_vertices.begin(), a_rhs.m_vertices.end(), m_vertices.get());
-        std::copy(a_rhs.m_hullPoints.begin(), a_rhs.m_hullPoints.end(), m_hullPoints.get());
-        std::copy(a_rhs.m_indices.begin(), a_rhs.m_indices.end(), m_indices.get());
+        a_rhs.m_vertices.Decode(m_vertices.get());
+        a_rhs.m_indices.CopyTo(m_indices.get());
 
         m_numVertices = static_cast<int>(a_rhs.m_vertices.size());
         m_numIndices = static_cast<int>(a_rhs.m_indices.size());
         m_numTriangles = a_rhs.m_numTriangles;
 
+        GenerateHullPoints();
         GenerateTriVertexArray();
     }
     
     SKMP_FORCEINLINE void ColliderData::__move(ColliderDataStorage&& a_rhs)
     {
-        m_vertices = std::make_shared<MeshPoint[]>(a_rhs.m_vertices.size());
-        m_hullPoints = std::make_shared<MeshPoint[]>(a_rhs.m_hullPoints.size());
-        m_indices = std::make_shared<int[]>(a_rhs.m_indices.size());
-
-        std::move(a_rhs.m_vertices.begin(), a_rhs.m_vertices.end(), m_vertices.get());
-        std::move(a_rhs.m_hullPoints.begin(), a_rhs.m_hullPoints.end(), m_hullPoints.get());
-        std::move(a_rhs.m_indices.begin(), a_rhs.m_indices.end(), m_indices.get());
-
-        m_numVertices = static_cast<int>(a_rhs.m_vertices.size());
-        m_numIndices = static_cast<int>(a_rhs.m_indices.size());
-        m_numTriangles = a_rhs.m_numTriangles;
-
-        GenerateTriVertexArray();
+        __copy(a_rhs);
+        a_rhs.Clear();
     }
 
-
     SKMP_FORCEINLINE void ColliderData::__copy(const ColliderDataStoragePair& a_rhs)
     {
         m_vertices = std::make_shared<MeshPoint[]>(a_rhs.first.m_vertices.size());
-        m_hullPoints = std::make_shared<MeshPoint[]>(a_rhs.second.m_hullPoints.size());
         m_indices = std::make_shared<int[]>(a_rhs.second.m_indices.size());
 
-        std::copy(a_rhs.first.m_vertices.begin(), a_rhs.first.m_vertices.end(), m_vertices.get());
-        std::copy(a_rhs.second.m_hullPoints.begin(), a_rhs.second.m_hullPoints.end(), m_hullPoints.get());
-        std::copy(a_rhs.second.m_indices.begin(), a_rhs.second.m_indices.end(), m_indices.get());
+        a_rhs.first.m_vertices.Decode(m_vertices.get());
+        a_rhs.second.m_indices.CopyTo(m_indices.get());
 
         m_numVertices = static_cast<int>(a_rhs.first.m_vertices.size());
         m_numIndices = static_cast<int>(a_rhs.second.m_indices.size());
         m_numTriangles = a_rhs.second.m_numTriangles;
 
+        GenerateHullPoints();
         GenerateTriVertexArray();
     }
 
@@ -415,5 +549,7 @@ namespace CBP
 
 
 BOOST_CLASS_VERSION(CBP::MeshPoint, CBP::MeshPoint::Serialization::DataVersion1)
-BOOST_CLASS_VERSION(CBP::ColliderDataStorage, CBP::ColliderDataStorage::Serialization::DataVersion1)
+BOOST_CLASS_VERSION(CBP::QuantizedVertices, CBP::QuantizedVertices::Serialization::DataVersion1)
+BOOST_CLASS_VERSION(CBP::IndexBuffer, CBP::IndexBuffer::Serialization::DataVersion1)
+BOOST_CLASS_VERSION(CBP::ColliderDataStorage, CBP::ColliderDataStorage::Serialization::DataVersion2)
 BOOST_CLASS_VERSION(CBP::ColliderDataStoragePair, CBP::ColliderDataStoragePair::Serialization::DataVersion1)
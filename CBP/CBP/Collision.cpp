@@ -4,8 +4,9 @@ namespace CBP
 {
     ICollision ICollision::m_Instance;
     ProfileManagerCollider ProfileManagerCollider::m_Instance("^[a-zA-Z0-9_\\- ]+$", ".obj");
+    std::atomic<std::uint64_t> ColliderProfile::m_nextUpdateID(0);
 
-    bool ColliderProfile::Save(const ColliderData& a_data, bool a_store)
+    bool ColliderProfile::Save(const ColliderDataStorage& a_data, bool a_store)
     {
         try
         {
@@ -27,6 +28,72 @@ namespace CBP
             if (m_path.empty())
                 throw std::exception("Bad path");
 
+            std::ifstream fs;
+            fs.open(m_path, std::ifstream::in | std::ifstream::binary);
+            if (!fs.is_open())
+                throw std::exception("Could not open file for reading");
+
+            m_meshLoaded = false;
+            m_meshFailed = false;
+            m_updateID = ++m_nextUpdateID;
+
+            // object/group name, replaced by the imported mesh name once loaded
+            std::string line;
+
+            while (std::getline(fs, line))
+            {
+                if (line.size() > 2 &&
+                    (line[0] == 'o' || line[0] == 'g') &&
+                    line[1] == ' ')
+                {
+                    auto name = line.substr(2);
+                    boost::trim(name);
+
+                    SetDescription(std::move(name));
+
+                    break;
+                }
+
+                // names come before the faces they apply to
+                if (line.size() > 1 && line[0] == 'f' && line[1] == ' ')
+                    break;
+            }
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            m_lastExcept = e;
+            return false;
+        }
+    }
+
+    const ColliderDataStorage* ColliderProfile::GetColliderData()
+    {
+        if (!m_meshLoaded && !m_meshFailed)
+        {
+            PerfTimer pt;
+            pt.Start();
+
+            if (LoadMesh())
+            {
+                m_meshLoaded = true;
+                Debug("%s: imported in %fs", m_name.c_str(), pt.Stop());
+            }
+            else
+            {
+                m_meshFailed = true;
+                Error("%s: %s", m_name.c_str(), m_lastExcept.what());
+            }
+        }
+
+        return m_meshLoaded ? std::addressof(m_data) : nullptr;
+    }
+
+    bool ColliderProfile::LoadMesh()
+    {
+        try
+        {
             Assimp::Importer importer;
             
             importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, IMPORT_RVC_FLAGS);
@@ -53,14 +120,12 @@ namespace CBP
             if (numFaces < 1)
                 throw std::exception("No faces");
 
-            ColliderData tmp;
-
-            tmp.m_vertices = std::make_shared<MeshPoint[]>(size_t(numVertices));
+            stl::vector<MeshPoint> vertices(size_t(numVertices));
 
             for (unsigned int i = 0; i < mesh->mNumVertices; i++)
             {
                 auto& e = mesh->mVertices[i];
-                auto& f = tmp.m_vertices[i];
+                auto& f = vertices[i];
 
                 f.x = e.x;
                 f.y = e.y;
@@ -82,8 +147,7 @@ namespace CBP
             if (numIndices < 1)
                 throw std::exception("No indices");
 
-            tmp.m_indices = std::make_shared<int[]>(size_t(numIndices));
-            tmp.m_hullPoints = std::make_shared<MeshPoint[]>(size_t(numIndices));
+            stl::vector<int> indices(size_t(numIndices));
 
             for (unsigned int i = 0, n = 0; i < mesh->mNumFaces; i++)
             {
@@ -93,26 +157,25 @@ namespace CBP
                 {
                     int index = static_cast<int>(e.mIndices[j]);
 
-                    tmp.m_indices[n] = index;
-                    tmp.m_hullPoints[n] = tmp.m_vertices[index];
+                    indices[n] = index;
                 }
             }
-            
-            tmp.m_triVertexArray = new btTriangleIndexVertexArray(
-                mesh->mNumFaces, tmp.m_indices.get(), sizeof(int) * 3,
-                numVertices, reinterpret_cast<btScalar*>(tmp.m_vertices.get()),
-                sizeof(MeshPoint));
 
-            tmp.m_numVertices = numVertices;
+            ColliderDataStorage tmp;
+
+            tmp.m_vertices.Encode(vertices.data(), vertices.size());
+            tmp.m_indices.Assign(indices, vertices.size());
             tmp.m_numTriangles = numFaces;
-            tmp.m_numIndices = numIndices;
+
+            tmp.UpdateSize();
 
             m_data = std::move(tmp);
 
             SetDescription(mesh->mName.C_Str());
 
-            Debug("%s (%s): vertices: %u, indices: %u, faces: %u",
-                m_name.c_str(), m_desc->c_str(), numVertices, numIndices, numFaces);
+            Debug("%s (%s): vertices: %d, indices: %d, faces: %d, bytes: %zu (unpacked %zu)",
+                m_name.c_str(), m_desc->c_str(), numVertices, numIndices, numFaces,
+                m_data.GetSize(), m_data.GetUnpackedSize());
 
             return true;
         }
@@ -3,7 +3,7 @@
 namespace CBP
 {
     class ColliderProfile :
-        public ProfileBase<ColliderData>,
+        public ProfileBase<ColliderDataStorage>,
         ILog
     {
         static constexpr int IMPORT_RVC_FLAGS =
@@ -32,17 +32,37 @@ namespace CBP
 
         template <typename... Args>
         ColliderProfile(Args&&... a_args) :
-            ProfileBase<ColliderData>(std::forward<Args>(a_args)...)
+            ProfileBase<ColliderDataStorage>(std::forward<Args>(a_args)...)
         {
         }
 
         virtual ~ColliderProfile() noexcept = default;
 
+        // Only reads the mesh name, vertex data is imported on first use
         virtual bool Load();
-        virtual bool Save(const ColliderData& a_data, bool a_store);
+        virtual bool Save(const ColliderDataStorage& a_data, bool a_store);
         virtual void SetDefaults() noexcept;
 
+        // imports the mesh on the first call, nullptr if that failed. Kept
+        // quantized, colliders expand it when building their shape
+        [[nodiscard]] const ColliderDataStorage* GetColliderData();
+
+        // new on every Load, colliders compare it to notice replaced files
+        [[nodiscard]] SKMP_FORCEINLINE std::uint64_t GetUpdateID() const noexcept {
+            return m_updateID;
+        }
+
         FN_NAMEPROC("ColliderProfile");
+
+    private:
+
+        bool LoadMesh();
+
+        bool m_meshLoaded{ false };
+        bool m_meshFailed{ false };
+        std::uint64_t m_updateID{ 0 };
+
+        static std::atomic<std::uint64_t> m_nextUpdateID;
     };
 
     class ProfileManagerCollider :
@@ -435,6 +435,19 @@ namespace CBP
         }
     );
 
+    static auto CreateValueIdMap()
+    {
+        stl::iunordered_map<std::string, configValueId_t> result;
+
+        configValueId_t id(0);
+        for (const auto& e : configComponent32_t::descMap)
+            result.emplace(e.first, id++);
+
+        return result;
+    }
+
+    const stl::iunordered_map<std::string, configValueId_t> configComponent32_t::valueIdMap = CreateValueIdMap();
+
     const stl::iunordered_map<std::string, std::string> configComponent32_t::oldKeyMap =
     {
         {"stiffness", "s"},
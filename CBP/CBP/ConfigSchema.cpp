@@ -0,0 +1,345 @@
+#include "pch.h"
+
+namespace CBP
+{
+    const IConfigSchema::fieldDesc_t IConfigSchema::m_nodeFields[] = {
+        { "fm", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.motion.female)), true },
+        { "fc", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.collisions.female)), true },
+        { "mm", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.motion.male)), true },
+        { "mc", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.collisions.male)), true },
+        { "o-x", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colOffsetMin[0])), false },
+        { "o-y", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colOffsetMin[1])), false },
+        { "o-z", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colOffsetMin[2])), false },
+        { "o+x", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colOffsetMax[0])), false },
+        { "o+y", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colOffsetMax[1])), false },
+        { "o+z", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colOffsetMax[2])), false },
+        { "rx", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colRot[0])), false },
+        { "ry", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colRot[1])), false },
+        { "rz", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.colRot[2])), false },
+        { "s", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.nodeScale)), false },
+        { "o", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.overrideScale)), true },
+        { "op", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.offsetParent)), true },
+        { "b", static_cast<std::uint32_t>(offsetof(configNode_t, bl.b.boneCast)), true },
+        { "bt", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.bcSimplifyTarget)), false },
+        { "be", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.bcSimplifyTargetError)), false },
+        { "bw", static_cast<std::uint32_t>(offsetof(configNode_t, fp.f32.bcWeightThreshold)), false }
+    };
+
+    IConfigSchema::readStats_t IConfigSchema::m_readStats{ 0, 0 };
+
+    void IConfigSchema::Writer::Write(const std::string& a_value)
+    {
+        Write(static_cast<std::uint32_t>(a_value.size()));
+
+        if (!a_value.empty())
+            std::memcpy(Grow(a_value.size()), a_value.data(), a_value.size());
+    }
+
+    char* IConfigSchema::Writer::Grow(std::size_t a_size)
+    {
+        auto pos = m_out.size();
+        m_out.resize(pos + a_size);
+        return m_out.data() + pos;
+    }
+
+    void IConfigSchema::Reader::Read(std::string& a_out)
+    {
+        auto len = Read<std::uint32_t>();
+
+        Check(len);
+
+        a_out.assign(m_p, len);
+        m_p += len;
+    }
+
+    auto IConfigSchema::Reader::Sub(std::size_t a_size) -> Reader
+    {
+        Check(a_size);
+
+        Reader r(m_p, a_size);
+        m_p += a_size;
+
+        return r;
+    }
+
+    void IConfigSchema::Reader::Skip(std::size_t a_size)
+    {
+        Check(a_size);
+        m_p += a_size;
+    }
+
+    auto IConfigSchema::BlockWriter::operator<<(const configComponents_t& a_value) -> BlockWriter&
+    {
+        if (!m_table) {
+            WritePhysicsTable(m_out);
+            m_table = true;
+        }
+
+        Write(m_out, a_value);
+        return *this;
+    }
+
+    auto IConfigSchema::BlockWriter::operator<<(const configNodes_t& a_value) -> BlockWriter&
+    {
+        if (!m_table) {
+            WriteNodeTable(m_out);
+            m_table = true;
+        }
+
+        Write(m_out, a_value);
+        return *this;
+    }
+
+    auto IConfigSchema::BlockReader::operator>>(configComponents_t& a_value) -> BlockReader&
+    {
+        if (!m_table) {
+            ReadPhysicsTable(m_in, m_map);
+            m_table = true;
+        }
+
+        Read(m_in, m_map, a_value);
+        return *this;
+    }
+
+    auto IConfigSchema::BlockReader::operator>>(configNodes_t& a_value) -> BlockReader&
+    {
+        if (!m_table) {
+            ReadNodeTable(m_in, m_map);
+            m_table = true;
+        }
+
+        Read(m_in, m_map, a_value);
+        return *this;
+    }
+
+    void IConfigSchema::WritePhysicsTable(Writer& a_out)
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        a_out.Write(static_cast<std::uint32_t>(vec.size()));
+
+        for (auto& e : vec)
+            a_out.Write(e.first);
+    }
+
+    void IConfigSchema::WriteNodeTable(Writer& a_out)
+    {
+        a_out.Write(static_cast<std::uint32_t>(std::size(m_nodeFields)));
+
+        for (auto& e : m_nodeFields)
+            a_out.Write(std::string(e.name));
+    }
+
+    template <class Tf>
+    static void ReadFieldTable(
+        IConfigSchema::Reader& a_in,
+        IConfigSchema::fieldMap_t& a_out,
+        Tf a_lookup)
+    {
+        auto num = a_in.Read<std::uint32_t>();
+
+        // every entry takes at least its length prefix
+        if (num > a_in.Remaining() / sizeof(std::uint32_t))
+            throw std::exception("Bad field table size");
+
+        a_out.slots.clear();
+        a_out.slots.reserve(num);
+        a_out.unknown = 0;
+
+        std::string name;
+
+        for (std::uint32_t i = 0; i < num; i++)
+        {
+            a_in.Read(name);
+
+            IConfigSchema::fieldSlot_t slot{ -1, false };
+
+            if (!a_lookup(name, slot))
+                a_out.unknown++;
+
+            a_out.slots.emplace_back(slot);
+        }
+    }
+
+    void IConfigSchema::ReadPhysicsTable(Reader& a_in, fieldMap_t& a_out)
+    {
+        ReadFieldTable(a_in, a_out,
+            [](const std::string& a_name, fieldSlot_t& a_slot)
+            {
+                auto it = configComponent32_t::descMap.find(a_name);
+                if (it == configComponent32_t::descMap.map_end())
+                    return false;
+
+                a_slot.offset = static_cast<std::int32_t>(it->second.offset);
+
+                return true;
+            });
+
+        m_readStats.unknownFields += a_out.unknown;
+    }
+
+    void IConfigSchema::ReadNodeTable(Reader& a_in, fieldMap_t& a_out)
+    {
+        ReadFieldTable(a_in, a_out,
+            [](const std::string& a_name, fieldSlot_t& a_slot)
+            {
+                for (auto& e : m_nodeFields)
+                {
+                    if (_stricmp(e.name, a_name.c_str()) == 0)
+                    {
+                        a_slot.offset = static_cast<std::int32_t>(e.offset);
+                        a_slot.isBool = e.isBool;
+                        return true;
+                    }
+                }
+
+                return false;
+            });
+
+        m_readStats.unknownFields += a_out.unknown;
+    }
+
+    void IConfigSchema::Write(Writer& a_out, const configComponents_t& a_data)
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        a_out.Write(static_cast<std::uint32_t>(a_data.size()));
+
+        for (auto& e : a_data)
+        {
+            a_out.Write(e.first);
+
+            auto sizePos = a_out.Position();
+            a_out.Write(std::uint32_t(0));
+
+            auto base = reinterpret_cast<const char*>(std::addressof(e.second));
+            auto p = a_out.Grow(vec.size() * sizeof(float));
+
+            for (auto& f : vec)
+            {
+                std::memcpy(p, base + f.second.offset, sizeof(float));
+                p += sizeof(float);
+            }
+
+            a_out.Write(e.second.ex.colShape);
+            a_out.Write(e.second.ex.colMesh);
+
+            a_out.Patch(sizePos, static_cast<std::uint32_t>(a_out.Position() - sizePos - sizeof(std::uint32_t)));
+        }
+    }
+
+    void IConfigSchema::Write(Writer& a_out, const configNodes_t& a_data)
+    {
+        a_out.Write(static_cast<std::uint32_t>(a_data.size()));
+
+        for (auto& e : a_data)
+        {
+            a_out.Write(e.first);
+
+            auto sizePos = a_out.Position();
+            a_out.Write(std::uint32_t(0));
+
+            auto base = reinterpret_cast<const char*>(std::addressof(e.second));
+            auto p = a_out.Grow(std::size(m_nodeFields) * sizeof(float));
+
+            for (auto& f : m_nodeFields)
+            {
+                float v = f.isBool ?
+                    (*reinterpret_cast<const bool*>(base + f.offset) ? 1.0f : 0.0f) :
+                    *reinterpret_cast<const float*>(base + f.offset);
+
+                std::memcpy(p, std::addressof(v), sizeof(float));
+                p += sizeof(float);
+            }
+
+            a_out.Write(e.second.ex.bcShape);
+
+            a_out.Patch(sizePos, static_cast<std::uint32_t>(a_out.Position() - sizePos - sizeof(std::uint32_t)));
+        }
+    }
+
+    // fills the slots known to a_map, non-finite values keep the default
+    static void ReadFieldSlots(
+        IConfigSchema::Reader& a_in,
+        const IConfigSchema::fieldMap_t& a_map,
+        char* a_base,
+        std::size_t& a_rejected)
+    {
+        for (auto& e : a_map.slots)
+        {
+            auto v = a_in.Read<float>();
+
+            if (e.offset < 0)
+                continue;
+
+            if (e.isBool)
+            {
+                *reinterpret_cast<bool*>(a_base + e.offset) = v != 0.0f;
+                continue;
+            }
+
+            if (!std::isfinite(v)) {
+                a_rejected++;
+                continue;
+            }
+
+            std::memcpy(a_base + e.offset, std::addressof(v), sizeof(float));
+        }
+    }
+
+    void IConfigSchema::Read(Reader& a_in, const fieldMap_t& a_map, configComponents_t& a_out)
+    {
+        auto num = a_in.Read<std::uint32_t>();
+
+        std::string name;
+
+        for (std::uint32_t i = 0; i < num; i++)
+        {
+            a_in.Read(name);
+
+            auto body = a_in.Sub(a_in.Read<std::uint32_t>());
+
+            auto& e = a_out[name];
+
+            ReadFieldSlots(body, a_map, reinterpret_cast<char*>(std::addressof(e)), m_readStats.rejected);
+
+            auto shape = body.Read<ColliderShapeType>();
+            if (shape <= ColliderShapeType::ConvexHull)
+                e.ex.colShape = shape;
+            else
+                m_readStats.rejected++;
+
+            body.Read(e.ex.colMesh);
+        }
+    }
+
+    void IConfigSchema::Read(Reader& a_in, const fieldMap_t& a_map, configNodes_t& a_out)
+    {
+        auto num = a_in.Read<std::uint32_t>();
+
+        std::string name;
+
+        for (std::uint32_t i = 0; i < num; i++)
+        {
+            a_in.Read(name);
+
+            auto body = a_in.Sub(a_in.Read<std::uint32_t>());
+
+            auto& e = a_out[name];
+
+            ReadFieldSlots(body, a_map, reinterpret_cast<char*>(std::addressof(e)), m_readStats.rejected);
+
+            body.Read(e.ex.bcShape);
+        }
+    }
+
+    auto IConfigSchema::GetReadStats() -> readStats_t
+    {
+        return m_readStats;
+    }
+
+    void IConfigSchema::ResetReadStats()
+    {
+        m_readStats = { 0, 0 };
+    }
+}
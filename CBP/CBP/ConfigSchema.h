@@ -0,0 +1,197 @@
+#pragma once
+
+namespace CBP
+{
+    // Flat little-endian layout for configComponent32_t/configNode_t (the
+    // plugin only targets x64 so native order is written as-is).
+    //
+    // A block starts with a field table naming the float slots each record
+    // carries. Readers map the names to offsets once, skip slots they don't
+    // know and leave fields missing from the table at their defaults. Record
+    // bodies are length-prefixed so data appended by later versions is
+    // skipped as well. All reads are bounds-checked.
+    class IConfigSchema
+    {
+    public:
+        static constexpr std::uint32_t VERSION = 1;
+
+        struct fieldDesc_t
+        {
+            const char* name;
+            std::uint32_t offset;
+            bool isBool;
+        };
+
+        class Writer
+        {
+        public:
+            Writer(stl::vector<char>& a_out) :
+                m_out(a_out)
+            {
+            }
+
+            template <class T>
+            SKMP_FORCEINLINE void Write(const T& a_value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                auto pos = m_out.size();
+                m_out.resize(pos + sizeof(T));
+                std::memcpy(m_out.data() + pos, std::addressof(a_value), sizeof(T));
+            }
+
+            void Write(const std::string& a_value);
+
+            // returns a pointer valid until the next write
+            char* Grow(std::size_t a_size);
+
+            [[nodiscard]] SKMP_FORCEINLINE std::size_t Position() const {
+                return m_out.size();
+            }
+
+            template <class T>
+            SKMP_FORCEINLINE void Patch(std::size_t a_pos, const T& a_value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                std::memcpy(m_out.data() + a_pos, std::addressof(a_value), sizeof(T));
+            }
+
+        private:
+            stl::vector<char>& m_out;
+        };
+
+        class Reader
+        {
+        public:
+            Reader(const char* a_data, std::size_t a_size) :
+                m_p(a_data),
+                m_end(a_data + a_size)
+            {
+            }
+
+            template <class T>
+            SKMP_FORCEINLINE T Read()
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                Check(sizeof(T));
+
+                T r;
+                std::memcpy(std::addressof(r), m_p, sizeof(T));
+                m_p += sizeof(T);
+
+                return r;
+            }
+
+            void Read(std::string& a_out);
+
+            // consumes a_size bytes and returns a reader bounded to them
+            Reader Sub(std::size_t a_size);
+
+            void Skip(std::size_t a_size);
+
+            [[nodiscard]] SKMP_FORCEINLINE std::size_t Remaining() const {
+                return static_cast<std::size_t>(m_end - m_p);
+            }
+
+        private:
+            SKMP_FORCEINLINE void Check(std::size_t a_size) const
+            {
+                if (Remaining() < a_size)
+                    throw std::exception("Unexpected end of data");
+            }
+
+            const char* m_p;
+            const char* m_end;
+        };
+
+        struct fieldSlot_t
+        {
+            // offset into the record, -1 for unknown fields
+            std::int32_t offset;
+            bool isBool;
+        };
+
+        struct fieldMap_t
+        {
+            stl::vector<fieldSlot_t> slots;
+            std::uint32_t unknown{ 0 };
+        };
+
+        struct readStats_t
+        {
+            std::size_t unknownFields;
+            std::size_t rejected;
+        };
+
+        // Archive-like front ends so the block code can drive either format
+        // with the same statements. The field table is written/read before
+        // the first config map in the block.
+        class BlockWriter
+        {
+        public:
+            BlockWriter(Writer& a_out) :
+                m_out(a_out)
+            {
+            }
+
+            template <class T>
+            SKMP_FORCEINLINE BlockWriter& operator<<(const T& a_value)
+            {
+                m_out.Write(a_value);
+                return *this;
+            }
+
+            BlockWriter& operator<<(const configComponents_t& a_value);
+            BlockWriter& operator<<(const configNodes_t& a_value);
+
+        private:
+            Writer& m_out;
+            bool m_table{ false };
+        };
+
+        class BlockReader
+        {
+        public:
+            BlockReader(Reader& a_in) :
+                m_in(a_in)
+            {
+            }
+
+            template <class T>
+            SKMP_FORCEINLINE BlockReader& operator>>(T& a_value)
+            {
+                a_value = m_in.Read<T>();
+                return *this;
+            }
+
+            BlockReader& operator>>(configComponents_t& a_value);
+            BlockReader& operator>>(configNodes_t& a_value);
+
+        private:
+            Reader& m_in;
+            fieldMap_t m_map;
+            bool m_table{ false };
+        };
+
+        static void WritePhysicsTable(Writer& a_out);
+        static void WriteNodeTable(Writer& a_out);
+
+        static void ReadPhysicsTable(Reader& a_in, fieldMap_t& a_out);
+        static void ReadNodeTable(Reader& a_in, fieldMap_t& a_out);
+
+        static void Write(Writer& a_out, const configComponents_t& a_data);
+        static void Write(Writer& a_out, const configNodes_t& a_data);
+
+        static void Read(Reader& a_in, const fieldMap_t& a_map, configComponents_t& a_out);
+        static void Read(Reader& a_in, const fieldMap_t& a_map, configNodes_t& a_out);
+
+        [[nodiscard]] static readStats_t GetReadStats();
+        static void ResetReadStats();
+
+    private:
+
+        static const fieldDesc_t m_nodeFields[];
+        static readStats_t m_readStats;
+    };
+}
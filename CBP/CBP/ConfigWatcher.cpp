@@ -0,0 +1,476 @@
+#include "pch.h"
+
+namespace CBP
+{
+    IConfigWatcher IConfigWatcher::m_Instance;
+
+    bool configChanges_t::Empty() const noexcept
+    {
+        return !hasGlobals &&
+            !hasCollisionGroups &&
+            physicsProfiles.empty() &&
+            nodeProfiles.empty() &&
+            colliders.empty();
+    }
+
+    static bool PathEquals(const fs::path& a_lhs, const fs::path& a_rhs)
+    {
+        return _wcsicmp(
+            a_lhs.lexically_normal().c_str(),
+            a_rhs.lexically_normal().c_str()) == 0;
+    }
+
+    template <class T>
+    static void LoadChangedProfile(const fs::path& a_path, bool a_exists, profileChanges_t<T>& a_out)
+    {
+        auto name = a_path.stem().string();
+
+        if (!a_exists)
+        {
+            a_out.push_back({ std::move(name), nullptr });
+            return;
+        }
+
+        auto profile = std::make_unique<T>(a_path);
+
+        if (!profile->Load())
+            throw std::exception(profile->GetLastException().what());
+
+        // import the mesh here rather than on the first frame that needs it
+        if constexpr (std::is_same_v<T, ColliderProfile>)
+            static_cast<void>(profile->GetColliderData());
+
+        // only added once parsed, a failed read must not look like a removal
+        a_out.push_back({ std::move(name), std::move(profile) });
+    }
+
+    template <class T>
+    static void AppendChanges(profileChanges_t<T>& a_out, profileChanges_t<T>& a_in)
+    {
+        std::move(a_in.begin(), a_in.end(), std::back_inserter(a_out));
+    }
+
+    bool IConfigWatcher::Start(const watchPaths_t& a_paths, TaskDelegate* a_task)
+    {
+        auto& inst = m_Instance;
+
+        if (inst.m_thread.joinable())
+            return true;
+
+        inst.m_paths = a_paths;
+        inst.m_task = a_task;
+
+        inst.m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!inst.m_stopEvent)
+        {
+            inst.Error("%s: CreateEvent failed (%lu)", __FUNCTION__, GetLastError());
+            return false;
+        }
+
+        inst.AddDirectory(DirectoryType::Settings, a_paths.settings.parent_path());
+        inst.AddDirectory(DirectoryType::Settings, a_paths.collisionGroups.parent_path());
+        inst.AddDirectory(DirectoryType::PhysicsProfiles, a_paths.profilesPhysics);
+        inst.AddDirectory(DirectoryType::NodeProfiles, a_paths.profilesNode);
+        inst.AddDirectory(DirectoryType::Colliders, a_paths.colliderData);
+
+        if (inst.m_dirs.empty())
+        {
+            inst.Warning("%s: nothing to watch", __FUNCTION__);
+
+            CloseHandle(inst.m_stopEvent);
+            inst.m_stopEvent = nullptr;
+
+            return false;
+        }
+
+        inst.m_thread = std::thread(&IConfigWatcher::Worker, std::addressof(inst));
+
+        inst.Debug("%s: watching %zu directories", __FUNCTION__, inst.m_dirs.size());
+
+        return true;
+    }
+
+    void IConfigWatcher::Release()
+    {
+        auto& inst = m_Instance;
+
+        if (inst.m_thread.joinable())
+        {
+            SetEvent(inst.m_stopEvent);
+            inst.m_thread.join();
+        }
+
+        inst.CloseDirectories();
+
+        if (inst.m_stopEvent)
+        {
+            CloseHandle(inst.m_stopEvent);
+            inst.m_stopEvent = nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(inst.m_mutex);
+        inst.m_ready = configChanges_t();
+    }
+
+    bool IConfigWatcher::TakeChanges(configChanges_t& a_out)
+    {
+        auto& inst = m_Instance;
+
+        std::lock_guard<std::mutex> lock(inst.m_mutex);
+
+        if (inst.m_ready.Empty())
+            return false;
+
+        a_out = std::move(inst.m_ready);
+        inst.m_ready = configChanges_t();
+
+        return true;
+    }
+
+    bool IConfigWatcher::AddDirectory(DirectoryType a_type, const fs::path& a_path)
+    {
+        for (const auto& e : m_dirs)
+        {
+            if (e->type == a_type && PathEquals(e->path, a_path))
+                return true;
+        }
+
+        std::error_code ec;
+        if (!fs::is_directory(a_path, ec))
+        {
+            Warning("%s: not a directory: %s", __FUNCTION__, a_path.string().c_str());
+            return false;
+        }
+
+        auto handle = CreateFileW(
+            a_path.c_str(),
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            nullptr);
+
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            Warning("%s: %s: couldn't open directory (%lu)", __FUNCTION__, a_path.string().c_str(), GetLastError());
+            return false;
+        }
+
+        auto dir = std::make_unique<watchDir_t>();
+
+        dir->type = a_type;
+        dir->path = a_path;
+        dir->handle = handle;
+        dir->buffer = std::make_unique<DWORD[]>(BUFFER_SIZE / sizeof(DWORD));
+
+        std::memset(std::addressof(dir->overlapped), 0x0, sizeof(dir->overlapped));
+        dir->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+        if (!dir->overlapped.hEvent)
+        {
+            Warning("%s: CreateEvent failed (%lu)", __FUNCTION__, GetLastError());
+            CloseHandle(handle);
+            return false;
+        }
+
+        if (!QueueRead(*dir))
+        {
+            CloseHandle(dir->overlapped.hEvent);
+            CloseHandle(handle);
+            return false;
+        }
+
+        m_dirs.emplace_back(std::move(dir));
+
+        return true;
+    }
+
+    void IConfigWatcher::CloseDirectories()
+    {
+        for (auto& e : m_dirs)
+        {
+            // the buffer must outlive the pending read
+            if (CancelIoEx(e->handle, std::addressof(e->overlapped)))
+            {
+                DWORD size;
+                GetOverlappedResult(e->handle, std::addressof(e->overlapped), std::addressof(size), TRUE);
+            }
+
+            CloseHandle(e->overlapped.hEvent);
+            CloseHandle(e->handle);
+        }
+
+        m_dirs.clear();
+    }
+
+    bool IConfigWatcher::QueueRead(watchDir_t& a_dir)
+    {
+        ResetEvent(a_dir.overlapped.hEvent);
+
+        if (!ReadDirectoryChangesW(
+            a_dir.handle,
+            a_dir.buffer.get(),
+            BUFFER_SIZE,
+            FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+            nullptr,
+            std::addressof(a_dir.overlapped),
+            nullptr))
+        {
+            Error("%s: %s: ReadDirectoryChangesW failed (%lu)", __FUNCTION__, a_dir.path.string().c_str(), GetLastError());
+            return false;
+        }
+
+        return true;
+    }
+
+    void IConfigWatcher::Worker()
+    {
+        stl::vector<HANDLE> handles;
+
+        handles.emplace_back(m_stopEvent);
+        for (const auto& e : m_dirs)
+            handles.emplace_back(e->overlapped.hEvent);
+
+        for (;;)
+        {
+            DWORD timeout(INFINITE);
+
+            if (!m_pending.empty())
+            {
+                auto now = GetTickCount64();
+
+                if (now >= m_deadline)
+                {
+                    ProcessPending();
+                    continue;
+                }
+
+                timeout = static_cast<DWORD>(m_deadline - now);
+            }
+
+            auto r = WaitForMultipleObjects(
+                static_cast<DWORD>(handles.size()),
+                handles.data(),
+                FALSE,
+                timeout);
+
+            if (r == WAIT_TIMEOUT)
+                continue;
+
+            if (r == WAIT_OBJECT_0)
+                break;
+
+            auto index = static_cast<std::size_t>(r - WAIT_OBJECT_0);
+            if (index >= handles.size())
+            {
+                Error("%s: wait failed (%lu)", __FUNCTION__, GetLastError());
+                break;
+            }
+
+            auto& dir = *m_dirs[index - 1];
+
+            DWORD size;
+            if (GetOverlappedResult(dir.handle, std::addressof(dir.overlapped), std::addressof(size), FALSE))
+            {
+                if (size == 0)
+                    Rescan(dir);
+                else
+                    OnNotify(dir, size);
+            }
+            else
+                Warning("%s: %s: GetOverlappedResult failed (%lu)", __FUNCTION__, dir.path.string().c_str(), GetLastError());
+
+            QueueRead(dir);
+        }
+    }
+
+    void IConfigWatcher::OnNotify(const watchDir_t& a_dir, DWORD a_size)
+    {
+        auto p = reinterpret_cast<const std::uint8_t*>(a_dir.buffer.get());
+        auto end = p + a_size;
+
+        for (;;)
+        {
+            auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p);
+
+            // removals and renames are told apart once the batch is processed
+            AddPending(a_dir, a_dir.path / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+
+            if (info->NextEntryOffset == 0)
+                break;
+
+            p += info->NextEntryOffset;
+
+            if (p >= end)
+                break;
+        }
+    }
+
+    // the notification buffer overflowed, removals in that window are missed
+    void IConfigWatcher::Rescan(const watchDir_t& a_dir)
+    {
+        Warning("%s: %s: change buffer overflowed, rescanning", __FUNCTION__, a_dir.path.string().c_str());
+
+        try
+        {
+            for (const auto& entry : fs::directory_iterator(a_dir.path))
+            {
+                if (entry.is_regular_file())
+                    AddPending(a_dir, entry.path());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Error("%s: %s", __FUNCTION__, e.what());
+        }
+    }
+
+    void IConfigWatcher::AddPending(const watchDir_t& a_dir, const fs::path& a_path)
+    {
+        FileType type;
+        if (!Classify(a_dir, a_path, type))
+            return;
+
+        m_pending.insert_or_assign(a_path, type);
+        m_deadline = GetTickCount64() + DEBOUNCE_MS;
+    }
+
+    bool IConfigWatcher::Classify(const watchDir_t& a_dir, const fs::path& a_path, FileType& a_out) const
+    {
+        switch (a_dir.type)
+        {
+        case DirectoryType::Settings:
+            if (PathEquals(a_path, m_paths.settings))
+            {
+                a_out = FileType::Globals;
+                return true;
+            }
+            if (PathEquals(a_path, m_paths.collisionGroups))
+            {
+                a_out = FileType::CollisionGroups;
+                return true;
+            }
+            return false;
+        case DirectoryType::PhysicsProfiles:
+            a_out = FileType::PhysicsProfile;
+            return GlobalProfileManager::GetSingleton<PhysicsProfile>().IsProfilePath(a_path);
+        case DirectoryType::NodeProfiles:
+            a_out = FileType::NodeProfile;
+            return GlobalProfileManager::GetSingleton<NodeProfile>().IsProfilePath(a_path);
+        case DirectoryType::Colliders:
+            a_out = FileType::Collider;
+            return ProfileManagerCollider::GetSingleton().IsProfilePath(a_path);
+        default:
+            return false;
+        }
+    }
+
+    void IConfigWatcher::ProcessPending()
+    {
+        PerfTimer pt;
+        pt.Start();
+
+        configChanges_t changes;
+
+        for (const auto& e : m_pending)
+        {
+            auto& path = e.first;
+
+            std::error_code ec;
+            bool exists = fs::is_regular_file(path, ec);
+
+            if (exists && Serialization::IsOwnWrite(path))
+                continue;
+
+            try
+            {
+                switch (e.second)
+                {
+                case FileType::Globals:
+                {
+                    // a missing settings file keeps the live config
+                    if (!exists)
+                        break;
+
+                    Json::Value root;
+                    Serialization::ReadData(path, root);
+
+                    if (root.empty())
+                        break;
+
+                    configGlobal_t tmp;
+                    ISerialization::ParseGlobalConfig(root, tmp);
+
+                    changes.globals = std::move(tmp);
+                    changes.hasGlobals = true;
+                }
+                break;
+                case FileType::CollisionGroups:
+                {
+                    if (!exists)
+                        break;
+
+                    Json::Value root;
+                    Serialization::ReadData(path, root);
+
+                    ISerialization::ParseCollisionGroups(
+                        root,
+                        changes.collisionGroups,
+                        changes.nodeCollisionGroupMap);
+
+                    changes.hasCollisionGroups = true;
+                }
+                break;
+                case FileType::PhysicsProfile:
+                    LoadChangedProfile(path, exists, changes.physicsProfiles);
+                    break;
+                case FileType::NodeProfile:
+                    LoadChangedProfile(path, exists, changes.nodeProfiles);
+                    break;
+                case FileType::Collider:
+                    LoadChangedProfile(path, exists, changes.colliders);
+                    break;
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                // most likely caught mid-write, the next event retries
+                Warning("%s: %s", path.string().c_str(), ex.what());
+            }
+        }
+
+        auto numFiles = m_pending.size();
+        m_pending.clear();
+
+        if (changes.Empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (changes.hasGlobals)
+            {
+                m_ready.globals = std::move(changes.globals);
+                m_ready.hasGlobals = true;
+            }
+
+            if (changes.hasCollisionGroups)
+            {
+                m_ready.collisionGroups = std::move(changes.collisionGroups);
+                m_ready.nodeCollisionGroupMap = std::move(changes.nodeCollisionGroupMap);
+                m_ready.hasCollisionGroups = true;
+            }
+
+            AppendChanges(m_ready.physicsProfiles, changes.physicsProfiles);
+            AppendChanges(m_ready.nodeProfiles, changes.nodeProfiles);
+            AppendChanges(m_ready.colliders, changes.colliders);
+        }
+
+        Debug("%s: %zu file(s) parsed in %fs", __FUNCTION__, numFiles, pt.Stop());
+
+        if (m_task)
+            DTasks::AddTask(m_task);
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+namespace CBP
+{
+    template <class T>
+    struct profileChange_t
+    {
+        std::string name;
+        // nullptr if the file is gone
+        std::unique_ptr<T> profile;
+    };
+
+    // applied in order, later entries win
+    template <class T>
+    using profileChanges_t = stl::vector<profileChange_t<T>>;
+
+    // files re-read off the main thread, waiting to be applied
+    struct configChanges_t
+    {
+        bool hasGlobals{ false };
+        configGlobal_t globals;
+
+        bool hasCollisionGroups{ false };
+        collisionGroups_t collisionGroups;
+        nodeCollisionGroupMap_t nodeCollisionGroupMap;
+
+        profileChanges_t<PhysicsProfile> physicsProfiles;
+        profileChanges_t<NodeProfile> nodeProfiles;
+        profileChanges_t<ColliderProfile> colliders;
+
+        [[nodiscard]] bool Empty() const noexcept;
+    };
+
+    // Watches the settings, profile and collider directories for files
+    // edited outside of the plugin. Events are debounced, changed files are
+    // parsed on the watcher thread and a_task is queued once results are
+    // ready. It runs on the main thread and collects them with TakeChanges.
+    // Writes made through Serialization::WriteStream are ignored.
+    class IConfigWatcher :
+        ILog
+    {
+        static constexpr DWORD DEBOUNCE_MS = 500;
+        static constexpr DWORD BUFFER_SIZE = 1024 * 16;
+
+        enum class DirectoryType : std::uint32_t
+        {
+            Settings,
+            PhysicsProfiles,
+            NodeProfiles,
+            Colliders
+        };
+
+        enum class FileType : std::uint32_t
+        {
+            Globals,
+            CollisionGroups,
+            PhysicsProfile,
+            NodeProfile,
+            Collider
+        };
+
+        struct watchDir_t
+        {
+            DirectoryType type;
+            fs::path path;
+            HANDLE handle;
+            OVERLAPPED overlapped;
+            // ReadDirectoryChangesW wants DWORD alignment
+            std::unique_ptr<DWORD[]> buffer;
+        };
+
+    public:
+
+        struct watchPaths_t
+        {
+            fs::path settings;
+            fs::path collisionGroups;
+            fs::path profilesPhysics;
+            fs::path profilesNode;
+            fs::path colliderData;
+        };
+
+        static bool Start(const watchPaths_t& a_paths, TaskDelegate* a_task);
+        static void Release();
+
+        // false if nothing is pending
+        static bool TakeChanges(configChanges_t& a_out);
+
+        [[nodiscard]] SKMP_FORCEINLINE static bool IsRunning() {
+            return m_Instance.m_thread.joinable();
+        }
+
+        FN_NAMEPROC("ConfigWatcher");
+
+    private:
+
+        IConfigWatcher() = default;
+
+        bool AddDirectory(DirectoryType a_type, const fs::path& a_path);
+        void CloseDirectories();
+        bool QueueRead(watchDir_t& a_dir);
+
+        void Worker();
+        void OnNotify(const watchDir_t& a_dir, DWORD a_size);
+        void Rescan(const watchDir_t& a_dir);
+        void AddPending(const watchDir_t& a_dir, const fs::path& a_path);
+        void ProcessPending();
+
+        bool Classify(const watchDir_t& a_dir, const fs::path& a_path, FileType& a_out) const;
+
+        watchPaths_t m_paths;
+        stl::vector<std::unique_ptr<watchDir_t>> m_dirs;
+
+        // worker only
+        stl::map<fs::path, FileType> m_pending;
+        ULONGLONG m_deadline{ 0 };
+
+        // guarded by m_mutex
+        configChanges_t m_ready;
+
+        std::mutex m_mutex;
+        std::thread m_thread;
+        HANDLE m_stopEvent{ nullptr };
+        TaskDelegate* m_task{ nullptr };
+
+        static IConfigWatcher m_Instance;
+    };
+}
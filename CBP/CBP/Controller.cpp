@@ -31,8 +31,10 @@ namespace CBP
         m_profiler(1000000),
         m_markedActor(0),
         m_ranFrame(true),
-        m_lastFrameTime(1.0f / 60.0f)
+        m_lastFrameTime(1.0f / 60.0f),
+        m_lastDrainTime(0)
     {
+        ResetInstructionStats();
     }
 
     void ControllerTask::UpdateDebugRenderer()
@@ -255,7 +257,7 @@ namespace CBP
                     Debug("Removing [%.8X] [%s] (no longer valid)", it->first.GetFormID(), GetActorName(actor));
 
                 IConfig::RemoveArmorOverride(it->first);
-                IConfig::ClearMergedCacheThreshold();
+                IConfig::RemoveMergedCacheEntry(it->first);
 
                 it = m_actors.erase(it);
 
@@ -343,6 +345,7 @@ namespace CBP
             globalConfig.phys.collisions,
             descList) == nodeDescList_t::size_type(0))
         {
+            IConfig::RemoveMergedCacheEntry(a_handle);
             return;
         }
 
@@ -371,7 +374,7 @@ namespace CBP
         m_actors.erase(it);
 
         IConfig::RemoveArmorOverride(a_handle);
-        IConfig::ClearMergedCacheThreshold();
+        IConfig::RemoveMergedCacheEntry(a_handle);
     }
 
     /*bool ControllerTask::ValidateActor(simActorList_t::value_type& a_entry)
@@ -391,15 +394,7 @@ namespace CBP
 
     void ControllerTask::UpdateConfigOnAllActors()
     {
-        for (auto& e : m_actors)
-        {
-            auto actor = e.first.Resolve<Actor>();
-
-            if (!ActorValid(actor))
-                continue;
-
-            DoConfigUpdate(e.first, actor, e.second);
-        }
+        QueueBulkJob(BulkAction::UpdateConfig);
     }
 
     void ControllerTask::UpdateConfig(Game::ObjectHandle a_handle)
@@ -418,10 +413,12 @@ namespace CBP
 
     void ControllerTask::DoConfigUpdate(Game::ObjectHandle a_handle, Actor* a_actor, SimObject& a_obj)
     {
-        a_obj.UpdateConfig(
+        auto result = a_obj.UpdateConfig(
             a_actor,
             IConfig::GetGlobal().phys.collisions,
             IConfig::GetActorPhysicsAO(a_handle));
+
+        m_profiler.AddConfigUpdates(result.performed, result.skipped);
     }
 
     void ControllerTask::ApplyForce(
@@ -461,13 +458,15 @@ namespace CBP
         else
             m_actors.clear();
 
+        ClearBulkJobs();
+
         IConfig::ReleaseMergedCache();
         IConfig::ReleaseArmorOverrides();
     }
 
     void ControllerTask::ResetInstructionQueue()
     {
-        m_queue.swap(decltype(m_queue)());
+        m_queue.Clear();
     }
 
     void ControllerTask::Reset()
@@ -508,8 +507,7 @@ namespace CBP
 
     void ControllerTask::WeightUpdateAll()
     {
-        for (const auto& e : m_actors)
-            WeightUpdate(e.first);
+        QueueBulkJob(BulkAction::WeightUpdate);
     }
 
     void ControllerTask::NiNodeUpdate(Game::ObjectHandle a_handle)
@@ -556,7 +554,7 @@ namespace CBP
         if (!IArmor::FindOverrides(actor, armor, ovResults))
             return;
 
-        auto current = IConfig::GetArmorOverrides(a_handle);
+        auto current = IConfig::ModifyArmorOverrides(a_handle);
         if (current) {
             armorOverrideDescriptor_t r;
             if (!BuildArmorOverride(a_handle, ovResults, *current))
@@ -614,12 +612,12 @@ namespace CBP
 
         if (current != nullptr)
         {
-            if (current->first.size() == a_desc.size())
+            if (current->paths.size() == a_desc.size())
             {
                 armorOverrideResults_t tmp;
 
                 std::set_symmetric_difference(
-                    current->first.begin(), current->first.end(),
+                    current->paths.begin(), current->paths.end(),
                     a_desc.begin(), a_desc.end(),
                     std::inserter(tmp, tmp.begin()));
 
@@ -644,24 +642,30 @@ namespace CBP
     {
         for (const auto& e : a_in)
         {
-            auto entry = IArmorCache::GetEntry(e);
-            if (!entry) {
+            // picked up by the update queued once it's parsed
+            if (IArmorCache::QueueParse(e, a_handle))
+                continue;
+
+            auto data = IArmorCache::GetData(e);
+            if (!data) {
                 Warning("[%.8X] [%s] Couldn't read armor override data: %s",
                     a_handle.GetFormID(), e.c_str(), IArmorCache::GetLastException().what());
                 continue;
             }
 
-            a_out.first.emplace(e);
+            a_out.paths.emplace(e);
 
-            for (const auto& ea : *entry)
+            for (const auto& ea : data->entry)
             {
-                auto r = a_out.second.emplace(ea.first, ea.second);
+                auto r = a_out.entries.emplace(ea.first, ea.second);
                 for (const auto& eb : ea.second)
                     r.first->second.insert_or_assign(eb.first, eb.second);
             }
+
+            IArmorCache::MergeOps(data->ops, a_out.ops);
         }
 
-        return !a_out.first.empty();
+        return !a_out.paths.empty();
     }
 
     void ControllerTask::UpdateArmorOverridesAll()
@@ -670,76 +674,439 @@ namespace CBP
         if (!globalConfig.general.armorOverrides)
             return;
 
-        for (auto& e : m_actors)
+        QueueBulkJob(BulkAction::UpdateArmorOverrides);
+    }
+
+    void ControllerTask::ClearArmorOverrides()
+    {
+        IConfig::ClearArmorOverrides();
+        UpdateConfigOnAllActors();
+    }
+
+    void ControllerTask::QueueBulkJob(BulkAction a_action)
+    {
+        auto& job = m_bulkJobs[Enum::Underlying(a_action)];
+
+        if (job.pending.empty())
+        {
+            job.time = 0;
+            job.frames = 0;
+            job.processed = 0;
+
+            if (a_action == BulkAction::UpdateConfig)
+                IConfig::ResetMergedCacheStats();
+        }
+
+        // the marked actor is updated right away
+        if (m_markedActor != Game::ObjectHandle(0) &&
+            m_actors.contains(m_markedActor))
         {
+            job.pending.erase(m_markedActor);
+            DoBulkAction(a_action, m_markedActor);
+        }
+
+        // actors not already pending go to the back, nearest first
+        auto player = *g_thePlayer;
+
+        stl::vector<std::pair<float, Game::ObjectHandle>> tmp;
+
+        for (const auto& e : m_actors)
+        {
+            if (e.first == m_markedActor)
+                continue;
+
+            if (job.pending.contains(e.first))
+                continue;
+
+            float d(std::numeric_limits<float>::max());
+
             auto actor = e.first.Resolve<Actor>();
-            if (!actor)
+            if (actor && player)
+            {
+                float dx = actor->pos.x - player->pos.x;
+                float dy = actor->pos.y - player->pos.y;
+                float dz = actor->pos.z - player->pos.z;
+
+                d = dx * dx + dy * dy + dz * dz;
+            }
+
+            tmp.emplace_back(d, e.first);
+        }
+
+        std::sort(tmp.begin(), tmp.end(),
+            [](const auto& a_lhs, const auto& a_rhs) {
+                return a_lhs.first < a_rhs.first;
+            });
+
+        for (const auto& e : tmp)
+        {
+            job.queue.emplace_back(e.second);
+            job.pending.emplace(e.second);
+        }
+    }
+
+    void ControllerTask::ProcessBulkJobs()
+    {
+        auto start = PerfCounter::Query();
+
+        for (uint32_t i = 0; i < Enum::Underlying(BulkAction::Max); i++)
+        {
+            auto& job = m_bulkJobs[i];
+
+            if (job.queue.empty())
                 continue;
 
-            DoUpdateArmorOverrides(e, actor);
+            auto action = static_cast<BulkAction>(i);
+            auto jobStart = PerfCounter::Query();
+
+            job.frames++;
+
+            while (!job.queue.empty())
+            {
+                if (PerfCounter::delta_us(start, PerfCounter::Query()) >= BULK_JOB_BUDGET_US)
+                    break;
+
+                auto handle = job.queue.front();
+                job.queue.pop_front();
+
+                if (job.pending.erase(handle) == 0)
+                    continue;
+
+                DoBulkAction(action, handle);
+
+                job.processed++;
+            }
+
+            job.time += PerfCounter::delta_us(jobStart, PerfCounter::Query());
+
+            if (!job.queue.empty())
+                break;
+
+            job.pending.clear();
+
+            OnBulkJobDone(action, job);
         }
     }
 
-    void ControllerTask::ClearArmorOverrides()
+    void ControllerTask::ClearBulkJobs()
     {
-        IConfig::ClearArmorOverrides();
-        UpdateConfigOnAllActors();
+        for (auto& e : m_bulkJobs)
+        {
+            e.queue.clear();
+            e.pending.clear();
+        }
+    }
+
+    void ControllerTask::DoBulkAction(BulkAction a_action, Game::ObjectHandle a_handle)
+    {
+        switch (a_action)
+        {
+        case BulkAction::UpdateArmorOverrides:
+            UpdateArmorOverrides(a_handle);
+            break;
+        case BulkAction::UpdateConfig:
+            UpdateConfig(a_handle);
+            break;
+        case BulkAction::WeightUpdate:
+            if (m_actors.contains(a_handle))
+                WeightUpdate(a_handle);
+            break;
+        }
+    }
+
+    void ControllerTask::OnBulkJobDone(BulkAction a_action, const bulkJob_t& a_job)
+    {
+        const auto& globalConfig = IConfig::GetGlobal();
+
+        if (!globalConfig.general.controllerStats)
+            return;
+
+        switch (a_action)
+        {
+        case BulkAction::UpdateConfig:
+        {
+            auto& stats = IConfig::GetMergedCacheStats();
+
+            Debug("Config update on %u actors: %.3f ms over %u frame(s) (merged configs: %llu reused, %llu rebuilt)",
+                a_job.processed, static_cast<double>(a_job.time) / 1000.0, a_job.frames, stats.hits, stats.rebuilds);
+        }
+        break;
+        case BulkAction::WeightUpdate:
+            Debug("Weight update on %u actors: %.3f ms over %u frame(s)",
+                a_job.processed, static_cast<double>(a_job.time) / 1000.0, a_job.frames);
+            break;
+        case BulkAction::UpdateArmorOverrides:
+            Debug("Armor override update on %u actors: %.3f ms over %u frame(s)",
+                a_job.processed, static_cast<double>(a_job.time) / 1000.0, a_job.frames);
+            break;
+        }
     }
 
     void ControllerTask::ProcessTasks()
     {
-        while (!TaskQueueEmpty())
+        if (!m_queue.Empty())
         {
-            m_lock.Enter();
-            ControllerInstruction instr = m_queue.front();
-            m_queue.pop();
-            m_lock.Leave();
+            auto& list = m_batch.list;
+
+            auto start = PerfCounter::Query();
+            m_queue.Drain(list);
+            m_lastDrainTime = PerfCounter::delta_us(start, PerfCounter::Query());
+
+            CoalesceInstructions();
 
-            switch (instr.m_action)
+            std::size_t executed(0);
+
+            for (std::size_t i = 0; i < list.size(); i++)
             {
-            case ControllerInstruction::Action::AddActor:
-                AddActor(instr.m_handle);
-                break;
-            case ControllerInstruction::Action::RemoveActor:
-                RemoveActor(instr.m_handle);
-                break;
-            case ControllerInstruction::Action::UpdateConfig:
-                UpdateConfig(instr.m_handle);
-                break;
-            case ControllerInstruction::Action::UpdateConfigAll:
-                UpdateConfigOnAllActors();
-                break;
-            case ControllerInstruction::Action::Reset:
-                Reset();
-                break;
-            case ControllerInstruction::Action::PhysicsReset:
-                PhysicsReset();
-                break;
-            case ControllerInstruction::Action::NiNodeUpdate:
-                NiNodeUpdate(instr.m_handle);
-                break;
-            case ControllerInstruction::Action::NiNodeUpdateAll:
-                NiNodeUpdateAll();
-                break;
-            case ControllerInstruction::Action::WeightUpdate:
-                WeightUpdate(instr.m_handle);
-                break;
-            case ControllerInstruction::Action::WeightUpdateAll:
-                WeightUpdateAll();
-                break;
-                /*case ControllerInstruction::Action::AddArmorOverride:
-                    AddArmorOverride(task.m_handle, task.m_formid);
-                    break;*/
-            case ControllerInstruction::Action::UpdateArmorOverride:
-                UpdateArmorOverrides(instr.m_handle);
-                break;
-            case ControllerInstruction::Action::UpdateArmorOverridesAll:
-                UpdateArmorOverridesAll();
-                break;
-            case ControllerInstruction::Action::ClearArmorOverrides:
-                ClearArmorOverrides();
-                break;
+                auto& instr = list[i];
+
+                m_instrStats.received[Enum::Underlying(instr.m_action)]++;
+
+                if (!ShouldExecute(i))
+                    continue;
+
+                ExecuteInstruction(instr);
+
+                m_instrStats.executed[Enum::Underlying(instr.m_action)]++;
+                executed++;
+            }
+
+            if (executed < list.size())
+            {
+                const auto& globalConfig = IConfig::GetGlobal();
+
+                if (globalConfig.general.controllerStats)
+                    Debug("Coalesced %zu instructions into %zu", list.size(), executed);
             }
+
+            list.clear();
+        }
+
+        ProcessBulkJobs();
+    }
+
+    void ControllerTask::ExecuteInstruction(const ControllerInstruction& a_instr)
+    {
+        switch (a_instr.m_action)
+        {
+        case ControllerInstruction::Action::AddActor:
+            AddActor(a_instr.m_handle);
+            break;
+        case ControllerInstruction::Action::RemoveActor:
+            RemoveActor(a_instr.m_handle);
+            break;
+        case ControllerInstruction::Action::UpdateConfig:
+            UpdateConfig(a_instr.m_handle);
+            break;
+        case ControllerInstruction::Action::UpdateConfigAll:
+            UpdateConfigOnAllActors();
+            break;
+        case ControllerInstruction::Action::Reset:
+            Reset();
+            break;
+        case ControllerInstruction::Action::PhysicsReset:
+            PhysicsReset();
+            break;
+        case ControllerInstruction::Action::NiNodeUpdate:
+            NiNodeUpdate(a_instr.m_handle);
+            break;
+        case ControllerInstruction::Action::NiNodeUpdateAll:
+            NiNodeUpdateAll();
+            break;
+        case ControllerInstruction::Action::WeightUpdate:
+            WeightUpdate(a_instr.m_handle);
+            break;
+        case ControllerInstruction::Action::WeightUpdateAll:
+            WeightUpdateAll();
+            break;
+            /*case ControllerInstruction::Action::AddArmorOverride:
+                AddArmorOverride(task.m_handle, task.m_formid);
+                break;*/
+        case ControllerInstruction::Action::UpdateArmorOverride:
+            UpdateArmorOverrides(a_instr.m_handle);
+            break;
+        case ControllerInstruction::Action::UpdateArmorOverridesAll:
+            UpdateArmorOverridesAll();
+            break;
+        case ControllerInstruction::Action::ClearArmorOverrides:
+            ClearArmorOverrides();
+            break;
+        }
+    }
+
+    void ControllerTask::CoalesceInstructions()
+    {
+        auto& list = m_batch.list;
+
+        m_batch.reset = NO_INDEX;
+
+        for (auto& e : m_batch.last)
+            e.clear();
+
+        for (std::size_t i = 0; i < list.size(); i++)
+        {
+            auto& e = list[i];
+
+            m_batch.last[Enum::Underlying(e.m_action)].insert_or_assign(e.m_handle, i);
+
+            if (e.m_action == action_t::Reset)
+                m_batch.reset = i;
+        }
+    }
+
+    std::size_t ControllerTask::GetLastIndex(
+        action_t a_action,
+        Game::ObjectHandle a_handle) const
+    {
+        auto& m = m_batch.last[Enum::Underlying(a_action)];
+
+        auto it = m.find(a_handle);
+        return it != m.end() ? it->second : NO_INDEX;
+    }
+
+    bool ControllerTask::IsCoveredByAll(
+        std::size_t a_index,
+        Game::ObjectHandle a_handle,
+        std::size_t a_allIndex,
+        BulkAction a_bulkAction)
+    {
+        if (a_allIndex == NO_INDEX)
+            return false;
+
+        // don't look across a reset or past a removal, the actor set changes
+        if (m_batch.reset != NO_INDEX &&
+            ((a_index < m_batch.reset) != (a_allIndex < m_batch.reset)))
+        {
+            return false;
+        }
+
+        auto removed = GetLastIndex(action_t::RemoveActor, a_handle);
+        if (removed != NO_INDEX && removed > a_index)
+            return false;
+
+        if (a_allIndex > a_index)
+            return m_actors.contains(a_handle);
+
+        // the *All instruction already ran, only bulk jobs still hold the actor
+        if (a_bulkAction == BulkAction::Max)
+            return false;
+
+        return m_bulkJobs[Enum::Underlying(a_bulkAction)].pending.contains(a_handle) ||
+            (a_handle == m_markedActor && m_actors.contains(a_handle));
+    }
+
+    bool ControllerTask::ShouldExecute(std::size_t a_index)
+    {
+        auto& instr = m_batch.list[a_index];
+        auto action = instr.m_action;
+
+        // only the last occurrence of an (action, handle) pair runs, every
+        // instruction reads the current state when executed so earlier ones are redundant
+        if (GetLastIndex(action, instr.m_handle) != a_index)
+            return false;
+
+        // reset rebuilds actors, their configs and overrides from scratch
+        if (m_batch.reset != NO_INDEX && a_index < m_batch.reset)
+        {
+            switch (action)
+            {
+            case action_t::AddActor:
+            case action_t::RemoveActor:
+            case action_t::UpdateConfig:
+            case action_t::UpdateConfigAll:
+            case action_t::PhysicsReset:
+            case action_t::UpdateArmorOverride:
+            case action_t::UpdateArmorOverridesAll:
+            case action_t::ClearArmorOverrides:
+                return false;
+            }
+        }
+
+        switch (action)
+        {
+        case action_t::AddActor:
+        {
+            // removed later on, keep add/remove ordering as queued
+            auto removed = GetLastIndex(action_t::RemoveActor, instr.m_handle);
+            return removed == NO_INDEX || removed < a_index;
+        }
+        case action_t::UpdateConfig:
+        {
+            auto all = GetLastIndex(action_t::UpdateConfigAll, Game::ObjectHandle(0));
+            auto clear = GetLastIndex(action_t::ClearArmorOverrides, Game::ObjectHandle(0));
+
+            return !IsCoveredByAll(a_index, instr.m_handle, all, BulkAction::UpdateConfig) &&
+                !IsCoveredByAll(a_index, instr.m_handle, clear, BulkAction::UpdateConfig);
+        }
+        case action_t::UpdateArmorOverride:
+            return !IsCoveredByAll(
+                a_index,
+                instr.m_handle,
+                GetLastIndex(action_t::UpdateArmorOverridesAll, Game::ObjectHandle(0)),
+                BulkAction::UpdateArmorOverrides);
+        case action_t::WeightUpdate:
+            return !IsCoveredByAll(
+                a_index,
+                instr.m_handle,
+                GetLastIndex(action_t::WeightUpdateAll, Game::ObjectHandle(0)),
+                BulkAction::WeightUpdate);
+        case action_t::NiNodeUpdate:
+            return !IsCoveredByAll(
+                a_index,
+                instr.m_handle,
+                GetLastIndex(action_t::NiNodeUpdateAll, Game::ObjectHandle(0)),
+                BulkAction::Max);
+        default:
+            return true;
+        }
+    }
+
+    void ControllerTask::ResetInstructionStats()
+    {
+        for (std::size_t i = 0; i < NUM_ACTIONS; i++)
+        {
+            m_instrStats.received[i] = 0;
+            m_instrStats.executed[i] = 0;
+        }
+
+        m_queue.ResetStats();
+        m_lastDrainTime = 0;
+    }
+
+    const char* ControllerInstruction::GetActionName(Action a_action)
+    {
+        switch (a_action)
+        {
+        case Action::AddActor:
+            return "AddActor";
+        case Action::RemoveActor:
+            return "RemoveActor";
+        case Action::UpdateConfig:
+            return "UpdateConfig";
+        case Action::UpdateConfigAll:
+            return "UpdateConfigAll";
+        case Action::Reset:
+            return "Reset";
+        case Action::PhysicsReset:
+            return "PhysicsReset";
+        case Action::NiNodeUpdate:
+            return "NiNodeUpdate";
+        case Action::NiNodeUpdateAll:
+            return "NiNodeUpdateAll";
+        case Action::WeightUpdate:
+            return "WeightUpdate";
+        case Action::WeightUpdateAll:
+            return "WeightUpdateAll";
+        case Action::AddArmorOverride:
+            return "AddArmorOverride";
+        case Action::UpdateArmorOverride:
+            return "UpdateArmorOverride";
+        case Action::UpdateArmorOverridesAll:
+            return "UpdateArmorOverridesAll";
+        case Action::ClearArmorOverrides:
+            return "ClearArmorOverrides";
+        default:
+            return "Unknown";
         }
     }
 
@@ -21,19 +21,62 @@ namespace CBP
             AddArmorOverride,
             UpdateArmorOverride,
             UpdateArmorOverridesAll,
-            ClearArmorOverrides
+            ClearArmorOverrides,
+
+            Max
         };
 
+        static const char* GetActionName(Action a_action);
+
         Action m_action;
         Game::ObjectHandle m_handle{ 0 };
     };
 
     class SKMP_ALIGN(32) ControllerTask :
         public TaskDelegateFixed,
-        public TaskQueueBase<ControllerInstruction>,
         protected ILog
     {
         typedef stl::unordered_set<Game::ObjectHandle> handleSet_t;
+        typedef ControllerInstruction::Action action_t;
+
+        // ring capacity, instructions past it go through the locked overflow path
+        static constexpr std::size_t INSTRUCTION_QUEUE_SIZE = 4096;
+
+        typedef MPSCQueue<ControllerInstruction, INSTRUCTION_QUEUE_SIZE> instructionQueue_t;
+
+        static constexpr std::size_t NUM_ACTIONS = Enum::Underlying(action_t::Max);
+        static constexpr std::size_t NO_INDEX = std::numeric_limits<std::size_t>::max();
+
+        // per-frame time budget for bulk (*All) jobs
+        static constexpr long long BULK_JOB_BUDGET_US = 1000;
+
+        // in processing order
+        enum class BulkAction : uint32_t
+        {
+            UpdateArmorOverrides,
+            UpdateConfig,
+            WeightUpdate,
+
+            Max
+        };
+
+        struct bulkJob_t
+        {
+            std::deque<Game::ObjectHandle> queue;
+            handleSet_t pending;
+            long long time{ 0 };
+            uint32_t frames{ 0 };
+            uint32_t processed{ 0 };
+        };
+
+        // instructions drained from the queue in one go, plus the last index
+        // of every (action, handle) pair used to coalesce them
+        struct instructionBatch_t
+        {
+            stl::vector<ControllerInstruction> list;
+            stl::unordered_map<Game::ObjectHandle, std::size_t> last[NUM_ACTIONS];
+            std::size_t reset{ NO_INDEX };
+        };
 
         class UpdateWeightTask :
             public TaskDelegate
@@ -50,6 +93,12 @@ namespace CBP
     public:
         SKMP_DECLARE_ALIGNED_ALLOCATOR(32);
 
+        struct instructionStats_t
+        {
+            uint64_t received[NUM_ACTIONS];
+            uint64_t executed[NUM_ACTIONS];
+        };
+
         ControllerTask();
 
         virtual void Run() override;
@@ -102,12 +151,35 @@ namespace CBP
         void UpdateArmorOverridesAll();
         void ClearArmorOverrides();
 
+        void QueueBulkJob(BulkAction a_action);
+        void ProcessBulkJobs();
+        void ClearBulkJobs();
+        void DoBulkAction(BulkAction a_action, Game::ObjectHandle a_handle);
+        void OnBulkJobDone(BulkAction a_action, const bulkJob_t& a_job);
+
+        void CoalesceInstructions();
+        bool ShouldExecute(std::size_t a_index);
+        bool IsCoveredByAll(
+            std::size_t a_index,
+            Game::ObjectHandle a_handle,
+            std::size_t a_allIndex,
+            BulkAction a_bulkAction);
+        std::size_t GetLastIndex(action_t a_action, Game::ObjectHandle a_handle) const;
+        void ExecuteInstruction(const ControllerInstruction& a_instr);
+
     public:
         void PhysicsTick(Game::BSMain* a_main, float a_interval);
 
         void ClearActors(bool a_noNotify = false, bool a_release = false);
         void ResetInstructionQueue();
 
+        SKMP_FORCEINLINE void AddTask(
+            ControllerInstruction::Action a_action,
+            Game::ObjectHandle a_handle = Game::ObjectHandle(0))
+        {
+            m_queue.Push(ControllerInstruction{ a_action, a_handle });
+        }
+
         void ApplyForce(
             Game::ObjectHandle a_handle,
             uint32_t a_steps,
@@ -124,6 +196,20 @@ namespace CBP
             return m_profiler;
         }
 
+        SKMP_FORCEINLINE const auto& GetInstructionStats() const {
+            return m_instrStats;
+        }
+
+        SKMP_FORCEINLINE const auto& GetInstructionQueueStats() const {
+            return m_queue.GetStats();
+        }
+
+        SKMP_FORCEINLINE long long GetLastDrainTime() const {
+            return m_lastDrainTime;
+        }
+
+        void ResetInstructionStats();
+
         SKMP_FORCEINLINE void UpdateTimeTick(float a_val) {
             m_averageInterval = a_val;
         }
@@ -173,6 +259,13 @@ namespace CBP
 
         Profiler m_profiler;
         //PerfTimerInt m_pt;
+
+        bulkJob_t m_bulkJobs[Enum::Underlying(BulkAction::Max)];
+
+        instructionQueue_t m_queue;
+        instructionBatch_t m_batch;
+        instructionStats_t m_instrStats;
+        long long m_lastDrainTime;
     };
 
     class ControllerTaskSim :
@@ -78,7 +78,6 @@ namespace CBP
         float a_val)
     {
         std::string sect(a_sect.c_str());
-        std::string key(a_key.c_str());
 
         auto& tgcd = IConfig::GetTemplateBase<configComponents_t>();
 
@@ -86,13 +85,14 @@ namespace CBP
         if (it == tgcd.end())
             return nullptr;
 
-        if (!it->second.Contains(key))
+        auto valueId = configComponent32_t::GetValueId(a_key.c_str());
+        if (valueId == INVALID_CONFIG_VALUE_ID)
             return nullptr;
 
         auto cmd = s_configUpdateTaskPool.Allocate();
         if (cmd) {
             cmd->m_sect = std::move(sect);
-            cmd->m_key = std::move(key);
+            cmd->m_valueId = valueId;
             cmd->m_val = a_val;
         }
 
@@ -118,19 +118,21 @@ namespace CBP
 
         if (m_handle)
         {
-            auto& ach = IConfig::GetActorPhysicsHolder();
+            if (IConfig::GetActorPhysicsClass(m_handle) != ConfigClass::kConfigActor)
+                return;
 
-            auto ith = ach.find(m_handle);
-            if (ith == ach.end())
+            auto current = IConfig::GetActorPhysics(m_handle, m_sect);
+            if (!current)
                 return;
 
-            auto itt = ith->second.find(m_sect);
-            if (itt == ith->second.end())
+            // nothing to write or update
+            if (current->Get(m_valueId) == m_val)
                 return;
 
-            if (itt->second.Set(m_key, m_val))
-                DCBP::DispatchActorTask(
-                    m_handle, ControllerInstruction::Action::UpdateConfig);
+            IConfig::GetOrCreateActorPhysics(m_handle, m_sect).Set(m_valueId, m_val);
+
+            DCBP::DispatchActorTask(
+                m_handle, ControllerInstruction::Action::UpdateConfig);
         }
         else {
             auto& globalConfig = IConfig::GetGlobalPhysics();
@@ -139,8 +141,12 @@ namespace CBP
             if (it == globalConfig.end())
                 return;
 
-            if (it->second.Set(m_key, m_val))
-                DCBP::UpdateConfigOnAllActors();
+            if (it->second.Get(m_valueId) == m_val)
+                return;
+
+            IConfig::ModifyGlobalPhysics()[m_sect].Set(m_valueId, m_val);
+
+            DCBP::UpdateConfigOnAllActors();
         }
 
     }
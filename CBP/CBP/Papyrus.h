@@ -15,7 +15,7 @@ namespace CBP
         static ConfigUpdateTask* Create(Game::ObjectHandle handle, const BSFixedString& sect, const BSFixedString& key, float val);
     private:
         std::string m_sect;
-        std::string m_key;
+        configValueId_t m_valueId;
         float m_val;
         Game::ObjectHandle m_handle;
     };
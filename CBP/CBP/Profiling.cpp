@@ -68,5 +68,7 @@ namespace CBP
         m_current.avgStepsPerUpdate = 0.0;
         m_current.avgTime = 0.0;
         m_current.avgFrameTime = 0.0;
+        m_configUpdates.performed = 0;
+        m_configUpdates.skipped = 0;
     }
 }
\ No newline at end of file
@@ -13,6 +13,12 @@ namespace CBP
             double avgFrameTime;
         };
 
+        struct ConfigUpdateStats
+        {
+            uint64_t performed;
+            uint64_t skipped;
+        };
+
     public:
         Profiler(long long a_interval);
 
@@ -22,6 +28,16 @@ namespace CBP
         void SetInterval(long long a_interval);
         void Reset();
 
+        SKMP_FORCEINLINE void AddConfigUpdates(uint32_t a_performed, uint32_t a_skipped)
+        {
+            m_configUpdates.performed += a_performed;
+            m_configUpdates.skipped += a_skipped;
+        }
+
+        SKMP_FORCEINLINE const auto& GetConfigUpdateStats() const {
+            return m_configUpdates;
+        }
+
         SKMP_FORCEINLINE const auto& Current() const {
             return m_current;
         }
@@ -34,6 +50,7 @@ namespace CBP
         PerfTimerInt m_perfTimer;
 
         Stats m_current;
+        ConfigUpdateStats m_configUpdates;
 
         uint32_t m_numActorsAccum;
         uint32_t m_numStepsAccum;
@@ -1,423 +1,229 @@
 #include "pch.h"
 
-namespace Serialization
+namespace CBP
 {
+    using namespace Serialization;
 
-    static const std::string s_keyMaxOffset("maxoffset");
-
-    template<>
-    bool Parser<CBP::configComponents_t>::Parse(const Json::Value& a_in, CBP::configComponents_t& a_outData) const
+    void ISerialization::ParseGlobalConfig(const Json::Value& a_root, configGlobal_t& a_out)
     {
-        uint32_t version;
-        if (!ParseVersion(a_in, "data_version", version)) {
-            Error("Bad version data");
-            return false;
-        }
-
-        if (!a_in.isMember("data"))
-            return false;
-
-        auto& data = a_in["data"];
-
-        if (data.empty())
-            return true;
-
-        if (!data.isObject()) {
-            Error("Expected an object");
-            return false;
-        }
-
-        for (auto it1 = data.begin(); it1 != data.end(); ++it1)
-        {
-            std::string configGroup(it1.key().asString());
-
-            if (configGroup.empty()) {
-                Error("Empty config group name");
-                return false;
-            }
-
-            auto& e = a_outData.try_emplace(configGroup).first->second;
-
-            if (!it1->isNull())
+        if (!a_root.isObject())
+            throw std::exception("Root not an object");
+
+        if (a_root.isMember("general"))
+        {
+            const auto& general = a_root["general"];
+
+            a_out.general.femaleOnly = general.get("femaleOnly", true).asBool();
+            a_out.general.controllerStats = general.get("controllerStats", false).asBool();
+            a_out.general.autoPrune = general.get("autoPrune", false).asBool();
+            a_out.profiling.enableProfiling = general.get("enableProfiling", false).asBool();
+            a_out.profiling.profilingInterval = general.get("profilingInterval", 1000).asInt();
+            a_out.profiling.enablePlot = general.get("enablePlot", true).asBool();
+            a_out.profiling.showAvg = general.get("showAvg", false).asBool();
+            a_out.profiling.animatePlot = general.get("animatePlot", true).asBool();
+            a_out.profiling.plotValues = general.get("plotValues", 200).asInt();
+            a_out.profiling.plotHeight = general.get("plotHeight", 30.0f).asFloat();
+        }
+
+        if (a_root.isMember("physics"))
+        {
+            const auto& phys = a_root["physics"];
+
+            a_out.phys.timeTick = std::clamp(phys.get("timeTick", 1.0f / 60.0f).asFloat(), 1.0f / 300.0f, 1.0f);
+            a_out.phys.maxSubSteps = std::max(phys.get("maxSubSteps", 5.0f).asFloat(), 1.0f);
+            a_out.phys.maxDiff = std::clamp(phys.get("maxDiff", 355.0f).asFloat(), 200.0f, 2000.0f);
+            a_out.phys.collisions = phys.get("collisions", true).asBool();
+        }
+
+        if (a_root.isMember("ui"))
+        {
+            const auto& ui = a_root["ui"];
+
+            a_out.ui.lockControls = ui.get("lockControls", true).asBool();
+            a_out.ui.freezeTime = ui.get("freezeTime", false).asBool();
+            a_out.ui.actorPhysics.showAll = ui.get("showAllActors", false).asBool();
+            a_out.ui.actorNode.showAll = ui.get("nodeShowAllActors", false).asBool();
+            a_out.ui.actor.clampValues = ui.get("clampValuesMain", true).asBool();
+            a_out.ui.race.clampValues = ui.get("clampValuesRace", true).asBool();
+            a_out.ui.profile.clampValues = ui.get("clampValuesProfile", true).asBool();
+            a_out.ui.racePhysics.playableOnly = ui.get("rlPlayableOnly", true).asBool();
+            a_out.ui.racePhysics.showEditorIDs = ui.get("rlShowEditorIDs", true).asBool();
+            a_out.ui.raceNode.playableOnly = ui.get("rlNodePlayableOnly", true).asBool();
+            a_out.ui.raceNode.showEditorIDs = ui.get("rlNodeShowEditorIDs", true).asBool();
+            a_out.ui.actor.syncWeightSliders = ui.get("syncWeightSlidersMain", false).asBool();
+            a_out.ui.race.syncWeightSliders = ui.get("syncWeightSlidersRace", false).asBool();
+            a_out.ui.profile.syncWeightSliders = ui.get("syncWeightSlidersProfile", false).asBool();
+            a_out.ui.actor.showNodes = ui.get("showNodesMain", false).asBool();
+            a_out.ui.race.showNodes = ui.get("showNodesRace", false).asBool();
+            a_out.ui.selectCrosshairActor = ui.get("selectCrosshairActor", false).asBool();
+            a_out.ui.comboKey = static_cast<UInt32>(ui.get("comboKey", DIK_LSHIFT).asUInt());
+            a_out.ui.showKey = static_cast<UInt32>(ui.get("showKey", DIK_END).asUInt());
+            a_out.ui.comboKeyDR = static_cast<UInt32>(ui.get("comboKeyDR", DIK_LSHIFT).asUInt());
+            a_out.ui.showKeyDR = static_cast<UInt32>(ui.get("showKeyDR", DIK_PGDN).asUInt());
+            a_out.ui.actorPhysics.lastActor = static_cast<Game::ObjectHandle>(ui.get("lastActor", 0ULL).asUInt64());
+            a_out.ui.actorNode.lastActor = static_cast<Game::ObjectHandle>(ui.get("nodeLastActor", 0ULL).asUInt64());
+            a_out.ui.actorNodeMap.lastActor = static_cast<Game::ObjectHandle>(ui.get("nodeMapLastActor", 0ULL).asUInt64());
+            a_out.ui.fontScale = ui.get("fontScale", 1.0f).asFloat();
+            a_out.ui.backlogLimit = ui.get("backlogLimit", 2000).asInt();
+
+            if (ui.isMember("import"))
             {
-                if (!it1->isObject()) {
-                    Error("Bad sim component data, expected object");
-                    return false;
-                }
-
-                const Json::Value* physData;
-                if (version == 0) {
-                    physData = std::addressof(*it1);
-                }
-                else
-                {
-                    auto& v = (*it1)["phys"];
+                const auto& imp = ui["import"];
 
-                    if (v.empty()) {
-                        Error("%s: Missing physics data", configGroup.c_str());
-                        return false;
-                    }
+                a_out.ui.import.global = imp.get("global", true).asBool();
+                a_out.ui.import.actors = imp.get("actors", true).asBool();
+                a_out.ui.import.races = imp.get("races", true).asBool();
+            }
 
-                    if (!v.isObject()) {
-                        Error("%s: Invalid physics data", configGroup.c_str());
-                        return false;
-                    }
+            if (ui.isMember("force")) {
+                const auto& force = ui["force"];
 
-                    physData = std::addressof(v);
-                }
+                if (force.isObject()) {
 
-                if (version < 3)
-                {
-                    for (auto it2 = physData->begin(); it2 != physData->end(); ++it2)
+                    for (auto it = force.begin(); it != force.end(); ++it)
                     {
-                        if (!it2->isNumeric()) {
-                            Error("(%s) Bad value type, expected number: %d", configGroup.c_str(), Enum::Underlying(it2->type()));
-                            return false;
-                        }
+                        if (!it->isObject())
+                            continue;
 
-                        std::string valName(it2.key().asString());
+                        std::string key(it.key().asString());
+                        //transform(key.begin(), key.end(), key.begin(), ::tolower);
 
-                        if (version < 2 && StrHelpers::icompare(valName, s_keyMaxOffset) == 0)
-                        {
-                            float v = it2->asFloat();
-                            float tv[3]{ v, v, v };
-                            e.Set("mox", tv, 3);
-                        }
-                        else
-                        {
-                            auto ik = CBP::configComponent32_t::oldKeyMap.find(valName);
-                            if (ik == CBP::configComponent32_t::oldKeyMap.end()) {
-                                //Warning("(%s) Unknown value: %s", configGroup.c_str(), valName.c_str());
-                                continue;
-                            }
+                        auto& e = a_out.ui.forceActor[key];
 
-                            ASSERT(e.Set(ik->second, it2->asFloat()));
-                        }
+                        e.force.x = it->get("x", 0.0f).asFloat();
+                        e.force.y = it->get("y", 0.0f).asFloat();
+                        e.force.z = it->get("z", 0.0f).asFloat();
+                        e.steps = std::max(it->get("steps", 0).asInt(), 0);
                     }
                 }
-                else
-                {
-                    for (auto& desc : CBP::configComponent32_t::descMap)
-                    {
-                        auto& v = (*physData)[desc.first];
-
-                        if (!v.isNumeric()) {
-                            if (!v.isNull()) {
-                                Warning("(%s) (%s) Bad value type, expected number: %d",
-                                    configGroup.c_str(), desc.first.c_str(), Enum::Underlying(v.type()));
-                            }
-                            continue;
-                        }
-
-                        e.Set(desc.second, v.asFloat());
-                    }
-                }
-
-                auto& ex = (*it1)["ex"];
+            }
 
-                if (!ex.empty())
+            if (ui.isMember("forceSelected"))
+            {
+                auto& forceSelected = ui["forceSelected"];
+                if (forceSelected.isString())
                 {
-                    auto s = static_cast<uint32_t>(ex.get("cs", 0).asUInt());
-
-                    switch (s)
-                    {
-                    case Enum::Underlying(CBP::ColliderShapeType::Sphere):
-                    case Enum::Underlying(CBP::ColliderShapeType::Capsule):
-                    case Enum::Underlying(CBP::ColliderShapeType::Box):
-                    case Enum::Underlying(CBP::ColliderShapeType::Cone):
-                    case Enum::Underlying(CBP::ColliderShapeType::Tetrahedron):
-                    case Enum::Underlying(CBP::ColliderShapeType::Cylinder):
-                    case Enum::Underlying(CBP::ColliderShapeType::Mesh):
-                    case Enum::Underlying(CBP::ColliderShapeType::ConvexHull):
-                        e.SetColShape(static_cast<CBP::ColliderShapeType>(s));
-                        break;
-                    default:
-                        Warning("(%s) Unknown collision shape specifier: %u", configGroup.c_str(), s);
-                    }
+                    std::string v(ui.get("forceSelected", "").asString());
+                    //transform(v.begin(), v.end(), v.begin(), ::tolower);
 
-                    e.ex.colMesh = ex.get("cm", "").asString();
+                    a_out.ui.forceActorSelected = std::move(v);
                 }
             }
-        }
-
-        return true;
-    }
 
-    template<>
-    void Parser<CBP::configComponents_t>::Create(const CBP::configComponents_t& a_data, Json::Value& a_out) const
-    {
-        auto& data = a_out["data"];
-
-        for (const auto& v : a_data) {
-            auto& simComponent = data[v.first];
-
-            auto& phys = simComponent["phys"];
-
-            auto baseaddr = reinterpret_cast<uintptr_t>(std::addressof(v.second));
-
-            for (const auto& e : v.second.descMap)
-                phys[e.first] = *reinterpret_cast<float*>(baseaddr + e.second.offset);
-
-            auto& ex = simComponent["ex"];
-
-            ex["cs"] = Enum::Underlying(v.second.ex.colShape);
-            ex["cm"] = v.second.ex.colMesh;
-        }
-
-        a_out["data_version"] = Json::Value::UInt(3);
-    }
-
-    template<>
-    bool Parser<CBP::configNodes_t>::Parse(const Json::Value& a_in, CBP::configNodes_t& a_out) const
-    {
-        uint32_t version;
-
-        if (!ParseVersion(a_in, "nodes_version", version)) {
-            Error("Bad version data");
-            return false;
-        }
-
-        if (!a_in.isMember("nodes"))
-            return false;
-
-        auto& data = a_in["nodes"];
-
-        if (data.empty())
-            return true;
-
-        if (!data.isObject()) {
-            Error("root: expected an object");
-            return false;
-        }
-
-        for (auto it = data.begin(); it != data.end(); ++it)
-        {
-            if (it->empty())
-                continue;
-
-            if (!it->isObject())
+            if (ui.isMember("propagate"))
             {
-                Error("Node entry not an object");
-                continue;
-            }
+                auto& propagate = ui["propagate"];
 
-            std::string k(it.key().asString());
+                if (propagate.isObject()) {
 
-            if (k.empty())
-            {
-                Error("Zero length node name");
-                return false;
-            }
+                    for (auto it1 = propagate.begin(); it1 != propagate.end(); ++it1)
+                    {
+                        if (!it1->isObject())
+                            continue;
 
-            auto& nc = a_out.try_emplace(k).first->second;
+                        UIEditorID ki;
 
-            if (version < 1)
-            {
-                nc.bl.b.motion.female = it->get("femaleMovement", false).asBool();
-                nc.bl.b.collisions.female = it->get("femaleCollisions", false).asBool();
-                nc.bl.b.motion.male = it->get("maleMovement", false).asBool();
-                nc.bl.b.collisions.male = it->get("maleCollisions", false).asBool();
+                        try {
+                            ki = static_cast<UIEditorID>(std::stoi(it1.key().asString()));
+                        }
+                        catch (...) {
+                            continue;
+                        }
 
-                auto& offsetMin = (*it)["offsetMin"];
+                        auto& mm = a_out.ui.propagate[ki];
 
-                if (!offsetMin.empty()) {
-                    if (!ParseFloatArray(offsetMin, nc.fp.f32.colOffsetMin, ARRAYSIZE(nc.fp.f32.colOffsetMin))) {
-                        Error("Couldn't parse offsetMin");
-                        return false;
-                    }
-                }
+                        for (auto it2 = it1->begin(); it2 != it1->end(); ++it2)
+                        {
+                            if (!it2->isObject())
+                                continue;
 
-                auto& offsetMax = (*it)["offsetMax"];
+                            std::string k(it2.key().asString());
 
-                if (!offsetMax.empty()) {
-                    if (!ParseFloatArray(offsetMax, nc.fp.f32.colOffsetMax, ARRAYSIZE(nc.fp.f32.colOffsetMax))) {
-                        Error("Couldn't parse offsetMax");
-                        return false;
-                    }
-                }
-            }
-            else
-            {
-                nc.bl.b.motion.female = it->get("fm", false).asBool();
-                nc.bl.b.collisions.female = it->get("fc", false).asBool();
-                nc.bl.b.motion.male = it->get("mm", false).asBool();
-                nc.bl.b.collisions.male = it->get("mc", false).asBool();
+                            auto& me = mm[k];
 
-                auto& offsetMin = (*it)["o-"];
+                            for (auto it3 = it2->begin(); it3 != it2->end(); ++it3)
+                            {
+                                if (!it3->isObject())
+                                    continue;
 
-                if (!offsetMin.empty()) {
-                    if (!ParseFloatArray(offsetMin, nc.fp.f32.colOffsetMin, ARRAYSIZE(nc.fp.f32.colOffsetMin))) {
-                        Error("Couldn't parse offsetMin");
-                        return false;
-                    }
-                }
+                                k = it3.key().asString();
 
-                auto& offsetMax = (*it)["o+"];
+                                auto& v = me[k];
 
-                if (!offsetMax.empty()) {
-                    if (!ParseFloatArray(offsetMax, nc.fp.f32.colOffsetMax, ARRAYSIZE(nc.fp.f32.colOffsetMax))) {
-                        Error("Couldn't parse offsetMax");
-                        return false;
-                    }
-                }
+                                v.enabled = it3->get("e", false).asBool();
 
-                if (version >= 2) {
-                    auto& rot = (*it)["r"];
+                                auto& m = (*it3)["m"];
 
-                    if (!rot.empty()) {
-                        if (!ParseFloatArray(rot, nc.fp.f32.colRot, ARRAYSIZE(nc.fp.f32.colRot))) {
-                            Error("Couldn't parse colRot");
-                            return false;
+                                for (auto& mv : m) {
+                                    if (mv.isString())
+                                        v.mirror.emplace(mv.asString());
+                                }
+                            }
                         }
                     }
-
-                    if (version >= 3)
-                    {
-                        nc.bl.b.boneCast = it->get("b", false).asBool();
-                        nc.fp.f32.bcSimplifyTarget = it->get("bt", 1.0f).asFloat();
-                        nc.fp.f32.bcSimplifyTargetError = it->get("be", 0.02f).asFloat();
-                        nc.fp.f32.bcWeightThreshold = it->get("bw", 0.0f).asFloat();
-                        nc.ex.bcShape = it->get("bs", "").asString();
-                    }
                 }
-
-                nc.fp.f32.nodeScale = std::clamp(it->get("s", 1.0f).asFloat(), 0.0f, 20.0f);
-                nc.bl.b.overrideScale = it->get("o", false).asBool();
             }
-        }
-
-        return true;
-    }
-
-    template<>
-    void Parser<CBP::configNodes_t>::Create(const CBP::configNodes_t& a_data, Json::Value& a_out) const
-    {
-        auto& data = a_out["nodes"];
-
-        for (const auto& e : a_data)
-        {
-            auto& n = data[e.first];
-
-            n["fm"] = e.second.bl.b.motion.female;
-            n["fc"] = e.second.bl.b.collisions.female;
-            n["mm"] = e.second.bl.b.motion.male;
-            n["mc"] = e.second.bl.b.collisions.male;
-
-            auto& offmin = n["o-"];
-
-            offmin[0] = e.second.fp.f32.colOffsetMin[0];
-            offmin[1] = e.second.fp.f32.colOffsetMin[1];
-            offmin[2] = e.second.fp.f32.colOffsetMin[2];
 
-            auto& offmax = n["o+"];
-
-            offmax[0] = e.second.fp.f32.colOffsetMax[0];
-            offmax[1] = e.second.fp.f32.colOffsetMax[1];
-            offmax[2] = e.second.fp.f32.colOffsetMax[2];
-
-            auto& rot = n["r"];
-
-            rot[0] = e.second.fp.f32.colRot[0];
-            rot[1] = e.second.fp.f32.colRot[1];
-            rot[2] = e.second.fp.f32.colRot[2];
-
-            n["s"] = e.second.fp.f32.nodeScale;
-            n["o"] = e.second.bl.b.overrideScale;
-
-            n["b"] = e.second.bl.b.boneCast;
-            n["bt"] = e.second.fp.f32.bcSimplifyTarget;
-            n["be"] = e.second.fp.f32.bcSimplifyTargetError;
-            n["bw"] = e.second.fp.f32.bcWeightThreshold;
-            n["bs"] = e.second.ex.bcShape;
+            a_out.ui.colStates.Parse(ui["colStates"]);
         }
 
-        a_out["nodes_version"] = Json::Value::UInt(3);
+        if (a_root.isMember("debugRenderer")) {
+            auto& debugRenderer = a_root["debugRenderer"];
+            if (debugRenderer.isObject())
+            {
+                a_out.debugRenderer.enabled = debugRenderer.get("enabled", false).asBool();
+                a_out.debugRenderer.wireframe = debugRenderer.get("wireframe", true).asBool();
+                a_out.debugRenderer.contactPointSphereRadius = debugRenderer.get("contactPointSphereRadius", 0.5f).asFloat();
+                a_out.debugRenderer.contactNormalLength = debugRenderer.get("contactNormalLength", 2.0f).asFloat();
+                a_out.debugRenderer.enableMovingNodes = debugRenderer.get("enableMovingNodes", false).asBool();
+                a_out.debugRenderer.enableMovementConstraints = debugRenderer.get("enableMovementConstraints", false).asBool();
+                a_out.debugRenderer.movingNodesRadius = debugRenderer.get("movingNodesRadius", 0.75f).asFloat();
+                a_out.debugRenderer.movingNodesCenterOfGravity = debugRenderer.get("movingNodesCenterOfMass", false).asBool();
+                a_out.debugRenderer.drawAABB = debugRenderer.get("drawAABB", false).asBool();
+                //a_out.debugRenderer.drawBroadphaseAABB = debugRenderer.get("drawBroadphaseAABB", false).asBool();
+            }
+        }
     }
 
-
-    template<>
-    bool Parser<CBP::nodeMap_t>::Parse(const Json::Value& a_in, CBP::nodeMap_t& a_out) const
+    void ISerialization::FilterGlobalConfig(configGlobal_t& a_config)
     {
-        if (a_in.empty())
-        {
-            Error("Empty node map");
-            return false;
-        }
+        auto& force = a_config.ui.forceActor;
 
-        if (!a_in.isObject())
+        for (auto it = force.begin(); it != force.end();)
         {
-            Error("Unexpected data");
-            return false;
+            if (!IConfig::IsValidGroup(it->first))
+                it = force.erase(it);
+            else
+                ++it;
         }
 
-        for (auto it = a_in.begin(); it != a_in.end(); ++it)
+        for (auto& e : a_config.ui.propagate)
         {
-            if (!it->isArray())
-            {
-                Error("Expected array");
-                return false;
-            }
+            auto& mm = e.second;
 
-            std::string configGroup(it.key().asString());
-            if (configGroup.empty())
+            for (auto it1 = mm.begin(); it1 != mm.end();)
             {
-                Error("Zero length config group string");
-                return false;
-            }
-
-            for (auto& v : *it)
-            {
-                if (!v.isString())
+                if (!IConfig::IsValidGroup(it1->first))
                 {
-                    Error("Expected string");
-                    return false;
+                    it1 = mm.erase(it1);
+                    continue;
                 }
 
-                std::string k(v.asString());
-                if (k.empty())
+                auto& me = it1->second;
+
+                for (auto it2 = me.begin(); it2 != me.end();)
                 {
-                    Error("Zero length node name string");
-                    return false;
+                    if (!IConfig::IsValidGroup(it2->first))
+                        it2 = me.erase(it2);
+                    else
+                        ++it2;
                 }
 
-                a_out.insert_or_assign(k, configGroup);
-            }
-        }
-
-        return true;
-    }
-
-    template<>
-    void Parser<CBP::configGroupMap_t>::Create(const CBP::configGroupMap_t& a_data, Json::Value& a_out) const
-    {
-        for (const auto& e : a_data)
-        {
-            auto& l = a_out[e.first];
-
-            for (const auto& f : e.second)
-            {
-                l.append(f);
+                ++it1;
             }
         }
     }
 
-    template<>
-    void Parser<CBP::configComponents_t>::GetDefault(CBP::configComponents_t& a_out) const
-    {
-        a_out = CBP::configComponents_t();
-    }
-
-    template<>
-    void Parser<CBP::configNodes_t>::GetDefault(CBP::configNodes_t& a_out) const
-    {
-        a_out = CBP::configNodes_t();
-    }
-}
-
-namespace CBP
-{
-    using namespace Serialization;
-
     void ISerialization::LoadGlobalConfig()
     {
         try
@@ -432,328 +238,206 @@ namespace CBP
             if (root.empty())
                 return;
 
-            if (!root.isObject())
-                throw std::exception("Root not an object");
-
-            if (root.isMember("general"))
-            {
-                const auto& general = root["general"];
-
-                globalConfig.general.femaleOnly = general.get("femaleOnly", true).asBool();
-                globalConfig.general.controllerStats = general.get("controllerStats", false).asBool();
-                globalConfig.profiling.enableProfiling = general.get("enableProfiling", false).asBool();
-                globalConfig.profiling.profilingInterval = general.get("profilingInterval", 1000).asInt();
-                globalConfig.profiling.enablePlot = general.get("enablePlot", true).asBool();
-                globalConfig.profiling.showAvg = general.get("showAvg", false).asBool();
-                globalConfig.profiling.animatePlot = general.get("animatePlot", true).asBool();
-                globalConfig.profiling.plotValues = general.get("plotValues", 200).asInt();
-                globalConfig.profiling.plotHeight = general.get("plotHeight", 30.0f).asFloat();
-            }
+            ParseGlobalConfig(root, globalConfig);
+            FilterGlobalConfig(globalConfig);
 
-            if (root.isMember("physics"))
-            {
-                const auto& phys = root["physics"];
-
-                globalConfig.phys.timeTick = std::clamp(phys.get("timeTick", 1.0f / 60.0f).asFloat(), 1.0f / 300.0f, 1.0f);
-                globalConfig.phys.maxSubSteps = std::max(phys.get("maxSubSteps", 5.0f).asFloat(), 1.0f);
-                globalConfig.phys.maxDiff = std::clamp(phys.get("maxDiff", 355.0f).asFloat(), 200.0f, 2000.0f);
-                globalConfig.phys.collisions = phys.get("collisions", true).asBool();
-            }
+            IConfig::SetGlobal(std::move(globalConfig));
+        }
+        catch (const std::exception& e)
+        {
+            m_lastException = e;
+            Error("%s: %s", __FUNCTION__, e.what());
+        }
+    }
 
-            if (root.isMember("ui"))
+    void ISerialization::CreateGlobalConfig(const configGlobal_t& a_in, Json::Value& a_out)
+    {
+        auto& general = a_out["general"];
+
+        general["femaleOnly"] = a_in.general.femaleOnly;
+        general["controllerStats"] = a_in.general.controllerStats;
+        general["autoPrune"] = a_in.general.autoPrune;
+        general["enableProfiling"] = a_in.profiling.enableProfiling;
+        general["profilingInterval"] = a_in.profiling.profilingInterval;
+        general["enablePlot"] = a_in.profiling.enablePlot;
+        general["showAvg"] = a_in.profiling.showAvg;
+        general["animatePlot"] = a_in.profiling.animatePlot;
+        general["plotValues"] = a_in.profiling.plotValues;
+        general["plotHeight"] = a_in.profiling.plotHeight;
+
+        auto& phys = a_out["physics"];
+
+        phys["timeTick"] = a_in.phys.timeTick;
+        phys["maxSubSteps"] = a_in.phys.maxSubSteps;
+        phys["maxDiff"] = a_in.phys.maxDiff;
+        phys["collisions"] = a_in.phys.collisions;
+
+        auto& ui = a_out["ui"];
+
+        ui["lockControls"] = a_in.ui.lockControls;
+        ui["freezeTime"] = a_in.ui.freezeTime;
+        ui["showAllActors"] = a_in.ui.actorPhysics.showAll;
+        ui["nodeShowAllActors"] = a_in.ui.actorNode.showAll;
+        ui["clampValuesMain"] = a_in.ui.actor.clampValues;
+        ui["clampValuesRace"] = a_in.ui.race.clampValues;
+        ui["clampValuesProfile"] = a_in.ui.profile.clampValues;
+        ui["rlPlayableOnly"] = a_in.ui.racePhysics.playableOnly;
+        ui["rlShowEditorIDs"] = a_in.ui.racePhysics.showEditorIDs;
+        ui["rlNodePlayableOnly"] = a_in.ui.raceNode.playableOnly;
+        ui["rlNodeShowEditorIDs"] = a_in.ui.raceNode.showEditorIDs;
+        ui["syncWeightSlidersMain"] = a_in.ui.actor.syncWeightSliders;
+        ui["syncWeightSlidersRace"] = a_in.ui.race.syncWeightSliders;
+        ui["syncWeightSlidersProfile"] = a_in.ui.profile.syncWeightSliders;
+        ui["showNodesMain"] = a_in.ui.actor.showNodes;
+        ui["showNodesRace"] = a_in.ui.race.showNodes;
+        ui["selectCrosshairActor"] = a_in.ui.selectCrosshairActor;
+        ui["comboKey"] = static_cast<uint32_t>(a_in.ui.comboKey);
+        ui["showKey"] = static_cast<uint32_t>(a_in.ui.showKey);
+        ui["comboKeyDR"] = static_cast<uint32_t>(a_in.ui.comboKeyDR);
+        ui["showKeyDR"] = static_cast<uint32_t>(a_in.ui.showKeyDR);
+        ui["lastActor"] = static_cast<uint64_t>(a_in.ui.actorPhysics.lastActor);
+        ui["nodeLastActor"] = static_cast<uint64_t>(a_in.ui.actorNode.lastActor);
+        ui["nodeMapLastActor"] = static_cast<uint64_t>(a_in.ui.actorNodeMap.lastActor);
+        ui["fontScale"] = a_in.ui.fontScale;
+        ui["backlogLimit"] = a_in.ui.backlogLimit;
+
+        auto& imp = ui["import"];
+
+        imp["global"] = a_in.ui.import.global;
+        imp["actors"] = a_in.ui.import.actors;
+        imp["races"] = a_in.ui.import.races;
+
+        auto& force = ui["force"];
+
+        for (const auto& e : a_in.ui.forceActor)
+        {
+            auto& fe = force[e.first];
+
+            fe["x"] = e.second.force.x;
+            fe["y"] = e.second.force.y;
+            fe["z"] = e.second.force.z;
+            fe["steps"] = std::max(e.second.steps, 0);
+        }
+
+        ui["forceSelected"] = a_in.ui.forceActorSelected;
+
+        auto& propagate = ui["propagate"];
+        for (const auto& e : a_in.ui.propagate)
+        {
+            auto& je = propagate[std::to_string(Enum::Underlying(e.first))];
+
+            for (const auto& k : e.second)
             {
-                const auto& ui = root["ui"];
-
-                globalConfig.ui.lockControls = ui.get("lockControls", true).asBool();
-                globalConfig.ui.freezeTime = ui.get("freezeTime", false).asBool();
-                globalConfig.ui.actorPhysics.showAll = ui.get("showAllActors", false).asBool();
-                globalConfig.ui.actorNode.showAll = ui.get("nodeShowAllActors", false).asBool();
-                globalConfig.ui.actor.clampValues = ui.get("clampValuesMain", true).asBool();
-                globalConfig.ui.race.clampValues = ui.get("clampValuesRace", true).asBool();
-                globalConfig.ui.profile.clampValues = ui.get("clampValuesProfile", true).asBool();
-                globalConfig.ui.racePhysics.playableOnly = ui.get("rlPlayableOnly", true).asBool();
-                globalConfig.ui.racePhysics.showEditorIDs = ui.get("rlShowEditorIDs", true).asBool();
-                globalConfig.ui.raceNode.playableOnly = ui.get("rlNodePlayableOnly", true).asBool();
-                globalConfig.ui.raceNode.showEditorIDs = ui.get("rlNodeShowEditorIDs", true).asBool();
-                globalConfig.ui.actor.syncWeightSliders = ui.get("syncWeightSlidersMain", false).asBool();
-                globalConfig.ui.race.syncWeightSliders = ui.get("syncWeightSlidersRace", false).asBool();
-                globalConfig.ui.profile.syncWeightSliders = ui.get("syncWeightSlidersProfile", false).asBool();
-                globalConfig.ui.actor.showNodes = ui.get("showNodesMain", false).asBool();
-                globalConfig.ui.race.showNodes = ui.get("showNodesRace", false).asBool();
-                globalConfig.ui.selectCrosshairActor = ui.get("selectCrosshairActor", false).asBool();
-                globalConfig.ui.comboKey = static_cast<UInt32>(ui.get("comboKey", DIK_LSHIFT).asUInt());
-                globalConfig.ui.showKey = static_cast<UInt32>(ui.get("showKey", DIK_END).asUInt());
-                globalConfig.ui.comboKeyDR = static_cast<UInt32>(ui.get("comboKeyDR", DIK_LSHIFT).asUInt());
-                globalConfig.ui.showKeyDR = static_cast<UInt32>(ui.get("showKeyDR", DIK_PGDN).asUInt());
-                globalConfig.ui.actorPhysics.lastActor = static_cast<Game::ObjectHandle>(ui.get("lastActor", 0ULL).asUInt64());
-                globalConfig.ui.actorNode.lastActor = static_cast<Game::ObjectHandle>(ui.get("nodeLastActor", 0ULL).asUInt64());
-                globalConfig.ui.actorNodeMap.lastActor = static_cast<Game::ObjectHandle>(ui.get("nodeMapLastActor", 0ULL).asUInt64());
-                globalConfig.ui.fontScale = ui.get("fontScale", 1.0f).asFloat();
-                globalConfig.ui.backlogLimit = ui.get("backlogLimit", 2000).asInt();
-
-                if (ui.isMember("import"))
-                {
-                    const auto& imp = ui["import"];
-
-                    globalConfig.ui.import.global = imp.get("global", true).asBool();
-                    globalConfig.ui.import.actors = imp.get("actors", true).asBool();
-                    globalConfig.ui.import.races = imp.get("races", true).asBool();
-                }
-
-                if (ui.isMember("force")) {
-                    const auto& force = ui["force"];
-
-                    if (force.isObject()) {
+                auto& ke = je[k.first];
 
-                        for (auto it = force.begin(); it != force.end(); ++it)
-                        {
-                            if (!it->isObject())
-                                continue;
-
-                            std::string key(it.key().asString());
-                            //transform(key.begin(), key.end(), key.begin(), ::tolower);
+                for (const auto& l : k.second) {
+                    auto& v = ke[l.first];
 
-                            if (!IConfig::IsValidGroup(key))
-                                continue;
+                    v["e"] = l.second.enabled;
 
-                            auto& e = globalConfig.ui.forceActor[key];
+                    if (!l.second.mirror.empty()) {
+                        auto& m = v["m"] = Json::Value(Json::ValueType::arrayValue);
 
-                            e.force.x = it->get("x", 0.0f).asFloat();
-                            e.force.y = it->get("y", 0.0f).asFloat();
-                            e.force.z = it->get("z", 0.0f).asFloat();
-                            e.steps = std::max(it->get("steps", 0).asInt(), 0);
+                        for (auto& mv : l.second.mirror) {
+                            m.append(mv);
                         }
                     }
                 }
+            }
+        }
 
-                if (ui.isMember("forceSelected"))
-                {
-                    auto& forceSelected = ui["forceSelected"];
-                    if (forceSelected.isString())
-                    {
-                        std::string v(ui.get("forceSelected", "").asString());
-                        //transform(v.begin(), v.end(), v.begin(), ::tolower);
-
-                        globalConfig.ui.forceActorSelected = std::move(v);
-                    }
-                }
-
-                if (ui.isMember("propagate"))
-                {
-                    auto& propagate = ui["propagate"];
-
-                    if (propagate.isObject()) {
-
-                        for (auto it1 = propagate.begin(); it1 != propagate.end(); ++it1)
-                        {
-                            if (!it1->isObject())
-                                continue;
-
-                            UIEditorID ki;
-
-                            try {
-                                ki = static_cast<UIEditorID>(std::stoi(it1.key().asString()));
-                            }
-                            catch (...) {
-                                continue;
-                            }
-
-                            auto& mm = globalConfig.ui.propagate[ki];
-
-                            for (auto it2 = it1->begin(); it2 != it1->end(); ++it2)
-                            {
-                                if (!it2->isObject())
-                                    continue;
-
-                                std::string k(it2.key().asString());
-
-                                if (!IConfig::IsValidGroup(k))
-                                    continue;
-
-                                auto& me = mm[k];
-
-                                for (auto it3 = it2->begin(); it3 != it2->end(); ++it3)
-                                {
-                                    if (!it3->isObject())
-                                        continue;
-
-                                    k = it3.key().asString();
-
-                                    if (!IConfig::IsValidGroup(k))
-                                        continue;
-
-                                    auto& v = me[k];
+        a_in.ui.colStates.Create(ui["colStates"]);
 
-                                    v.enabled = it3->get("e", false).asBool();
+        auto& debugRenderer = a_out["debugRenderer"];
 
-                                    auto& m = (*it3)["m"];
+        debugRenderer["enabled"] = a_in.debugRenderer.enabled;
+        debugRenderer["wireframe"] = a_in.debugRenderer.wireframe;
+        debugRenderer["contactPointSphereRadius"] = a_in.debugRenderer.contactPointSphereRadius;
+        debugRenderer["contactNormalLength"] = a_in.debugRenderer.contactNormalLength;
+        debugRenderer["enableMovingNodes"] = a_in.debugRenderer.enableMovingNodes;
+        debugRenderer["enableMovementConstraints"] = a_in.debugRenderer.enableMovementConstraints;
+        debugRenderer["movingNodesCenterOfMass"] = a_in.debugRenderer.movingNodesCenterOfGravity;
+        debugRenderer["movingNodesRadius"] = a_in.debugRenderer.movingNodesRadius;
+        debugRenderer["drawAABB"] = a_in.debugRenderer.drawAABB;
+        //debugRenderer["drawBroadphaseAABB"] = a_in.debugRenderer.drawBroadphaseAABB;
+    }
 
-                                    for (auto& mv : m) {
-                                        if (mv.isString())
-                                            v.mirror.emplace(mv.asString());
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+    bool ISerialization::SaveGlobalConfig()
+    {
+        try
+        {
+            Json::Value root;
+            CreateGlobalConfig(IConfig::GetGlobal(), root);
 
-                globalConfig.ui.colStates.Parse(ui["colStates"]);
-            }
+            auto& driverConf = DCBP::GetDriverConfig();
 
-            if (root.isMember("debugRenderer")) {
-                auto& debugRenderer = root["debugRenderer"];
-                if (debugRenderer.isObject())
-                {
-                    globalConfig.debugRenderer.enabled = debugRenderer.get("enabled", false).asBool();
-                    globalConfig.debugRenderer.wireframe = debugRenderer.get("wireframe", true).asBool();
-                    globalConfig.debugRenderer.contactPointSphereRadius = debugRenderer.get("contactPointSphereRadius", 0.5f).asFloat();
-                    globalConfig.debugRenderer.contactNormalLength = debugRenderer.get("contactNormalLength", 2.0f).asFloat();
-                    globalConfig.debugRenderer.enableMovingNodes = debugRenderer.get("enableMovingNodes", false).asBool();
-                    globalConfig.debugRenderer.enableMovementConstraints = debugRenderer.get("enableMovementConstraints", false).asBool();
-                    globalConfig.debugRenderer.movingNodesRadius = debugRenderer.get("movingNodesRadius", 0.75f).asFloat();
-                    globalConfig.debugRenderer.movingNodesCenterOfGravity = debugRenderer.get("movingNodesCenterOfMass", false).asBool();
-                    globalConfig.debugRenderer.drawAABB = debugRenderer.get("drawAABB", false).asBool();
-                    //globalConfig.debugRenderer.drawBroadphaseAABB = debugRenderer.get("drawBroadphaseAABB", false).asBool();
-                }
-            }
+            WriteData(driverConf.paths.settings, root);
 
-            IConfig::SetGlobal(std::move(globalConfig));
+            return true;
         }
         catch (const std::exception& e)
         {
             m_lastException = e;
             Error("%s: %s", __FUNCTION__, e.what());
+            return false;
         }
     }
 
-    bool ISerialization::SaveGlobalConfig()
+    void ISerialization::ParseCollisionGroups(
+        const Json::Value& a_root,
+        collisionGroups_t& a_groups,
+        nodeCollisionGroupMap_t& a_nodeMap)
     {
-        try
-        {
-            auto& globalConfig = IConfig::GetGlobal();
-
-            Json::Value root;
+        if (a_root.isMember("groups")) {
+            auto& groups = a_root["groups"];
+            if (groups.isArray()) {
+                for (const auto& e : groups)
+                {
+                    if (!e.isNumeric())
+                        continue;
 
-            auto& general = root["general"];
-
-            general["femaleOnly"] = globalConfig.general.femaleOnly;
-            general["controllerStats"] = globalConfig.general.controllerStats;
-            general["enableProfiling"] = globalConfig.profiling.enableProfiling;
-            general["profilingInterval"] = globalConfig.profiling.profilingInterval;
-            general["enablePlot"] = globalConfig.profiling.enablePlot;
-            general["showAvg"] = globalConfig.profiling.showAvg;
-            general["animatePlot"] = globalConfig.profiling.animatePlot;
-            general["plotValues"] = globalConfig.profiling.plotValues;
-            general["plotHeight"] = globalConfig.profiling.plotHeight;
-
-            auto& phys = root["physics"];
-
-            phys["timeTick"] = globalConfig.phys.timeTick;
-            phys["maxSubSteps"] = globalConfig.phys.maxSubSteps;
-            phys["maxDiff"] = globalConfig.phys.maxDiff;
-            phys["collisions"] = globalConfig.phys.collisions;
-
-            auto& ui = root["ui"];
-
-            ui["lockControls"] = globalConfig.ui.lockControls;
-            ui["freezeTime"] = globalConfig.ui.freezeTime;
-            ui["showAllActors"] = globalConfig.ui.actorPhysics.showAll;
-            ui["nodeShowAllActors"] = globalConfig.ui.actorNode.showAll;
-            ui["clampValuesMain"] = globalConfig.ui.actor.clampValues;
-            ui["clampValuesRace"] = globalConfig.ui.race.clampValues;
-            ui["clampValuesProfile"] = globalConfig.ui.profile.clampValues;
-            ui["rlPlayableOnly"] = globalConfig.ui.racePhysics.playableOnly;
-            ui["rlShowEditorIDs"] = globalConfig.ui.racePhysics.showEditorIDs;
-            ui["rlNodePlayableOnly"] = globalConfig.ui.raceNode.playableOnly;
-            ui["rlNodeShowEditorIDs"] = globalConfig.ui.raceNode.showEditorIDs;
-            ui["syncWeightSlidersMain"] = globalConfig.ui.actor.syncWeightSliders;
-            ui["syncWeightSlidersRace"] = globalConfig.ui.race.syncWeightSliders;
-            ui["syncWeightSlidersProfile"] = globalConfig.ui.profile.syncWeightSliders;
-            ui["showNodesMain"] = globalConfig.ui.actor.showNodes;
-            ui["showNodesRace"] = globalConfig.ui.race.showNodes;
-            ui["selectCrosshairActor"] = globalConfig.ui.selectCrosshairActor;
-            ui["comboKey"] = static_cast<uint32_t>(globalConfig.ui.comboKey);
-            ui["showKey"] = static_cast<uint32_t>(globalConfig.ui.showKey);
-            ui["comboKeyDR"] = static_cast<uint32_t>(globalConfig.ui.comboKeyDR);
-            ui["showKeyDR"] = static_cast<uint32_t>(globalConfig.ui.showKeyDR);
-            ui["lastActor"] = static_cast<uint64_t>(globalConfig.ui.actorPhysics.lastActor);
-            ui["nodeLastActor"] = static_cast<uint64_t>(globalConfig.ui.actorNode.lastActor);
-            ui["nodeMapLastActor"] = static_cast<uint64_t>(globalConfig.ui.actorNodeMap.lastActor);
-            ui["fontScale"] = globalConfig.ui.fontScale;
-            ui["backlogLimit"] = globalConfig.ui.backlogLimit;
-
-            auto& imp = ui["import"];
-
-            imp["global"] = globalConfig.ui.import.global;
-            imp["actors"] = globalConfig.ui.import.actors;
-            imp["races"] = globalConfig.ui.import.races;
-
-            auto& force = ui["force"];
-
-            for (const auto& e : globalConfig.ui.forceActor)
-            {
-                auto& fe = force[e.first];
+                    auto v = static_cast<uint64_t>(e.asUInt64());
+                    reinterpret_cast<char*>(&v)[sizeof(v) - 1] = 0x0;
 
-                fe["x"] = e.second.force.x;
-                fe["y"] = e.second.force.y;
-                fe["z"] = e.second.force.z;
-                fe["steps"] = std::max(e.second.steps, 0);
+                    if (v != 0)
+                        a_groups.emplace(v);
+                }
             }
+        }
 
-            ui["forceSelected"] = globalConfig.ui.forceActorSelected;
-
-            auto& propagate = ui["propagate"];
-            for (const auto& e : globalConfig.ui.propagate)
-            {
-                auto& je = propagate[std::to_string(Enum::Underlying(e.first))];
+        if (a_root.isMember("nodeMap")) {
+            auto& nmap = a_root["nodeMap"];
+            if (nmap.isObject()) {
 
-                for (const auto& k : e.second)
+                for (auto it = nmap.begin(); it != nmap.end(); ++it)
                 {
-                    auto& ke = je[k.first];
+                    if (!it->isNumeric())
+                        continue;
 
-                    for (const auto& l : k.second) {
-                        auto& v = ke[l.first];
+                    std::string k(it.key().asString());
 
-                        v["e"] = l.second.enabled;
+                    auto v = static_cast<uint64_t>(it->asUInt64());
 
-                        if (!l.second.mirror.empty()) {
-                            auto& m = v["m"] = Json::Value(Json::ValueType::arrayValue);
+                    if (v == 0)
+                        continue;
 
-                            for (auto& mv : l.second.mirror) {
-                                m.append(mv);
-                            }
-                        }
-                    }
+                    if (a_groups.find(v) == a_groups.end())
+                        continue;
+
+                    a_nodeMap.emplace(k, v);
                 }
             }
-
-            globalConfig.ui.colStates.Create(ui["colStates"]);
-
-            auto& debugRenderer = root["debugRenderer"];
-
-            debugRenderer["enabled"] = globalConfig.debugRenderer.enabled;
-            debugRenderer["wireframe"] = globalConfig.debugRenderer.wireframe;
-            debugRenderer["contactPointSphereRadius"] = globalConfig.debugRenderer.contactPointSphereRadius;
-            debugRenderer["contactNormalLength"] = globalConfig.debugRenderer.contactNormalLength;
-            debugRenderer["enableMovingNodes"] = globalConfig.debugRenderer.enableMovingNodes;
-            debugRenderer["enableMovementConstraints"] = globalConfig.debugRenderer.enableMovementConstraints;
-            debugRenderer["movingNodesCenterOfMass"] = globalConfig.debugRenderer.movingNodesCenterOfGravity;
-            debugRenderer["movingNodesRadius"] = globalConfig.debugRenderer.movingNodesRadius;
-            debugRenderer["drawAABB"] = globalConfig.debugRenderer.drawAABB;
-            //debugRenderer["drawBroadphaseAABB"] = globalConfig.debugRenderer.drawBroadphaseAABB;
-
-            auto& driverConf = DCBP::GetDriverConfig();
-
-            WriteData(driverConf.paths.settings, root);
-
-            return true;
         }
-        catch (const std::exception& e)
+    }
+
+    void ISerialization::FilterCollisionGroups(nodeCollisionGroupMap_t& a_nodeMap)
+    {
+        for (auto it = a_nodeMap.begin(); it != a_nodeMap.end();)
         {
-            m_lastException = e;
-            Error("%s: %s", __FUNCTION__, e.what());
-            return false;
+            if (!IConfig::IsValidNode(it->first))
+                it = a_nodeMap.erase(it);
+            else
+                ++it;
         }
     }
 
@@ -769,49 +453,8 @@ namespace CBP
             Json::Value root;
             ReadData(driverConf.paths.collisionGroups, root);
 
-            if (root.isMember("groups")) {
-                auto& groups = root["groups"];
-                if (groups.isArray()) {
-                    for (const auto& e : groups)
-                    {
-                        if (!e.isNumeric())
-                            continue;
-
-                        auto v = static_cast<uint64_t>(e.asUInt64());
-                        reinterpret_cast<char*>(&v)[sizeof(v) - 1] = 0x0;
-
-                        if (v != 0)
-                            colGroups.emplace(v);
-                    }
-                }
-            }
-
-            if (root.isMember("nodeMap")) {
-                auto& nmap = root["nodeMap"];
-                if (nmap.isObject()) {
-
-                    for (auto it = nmap.begin(); it != nmap.end(); ++it)
-                    {
-                        if (!it->isNumeric())
-                            continue;
-
-                        std::string k(it.key().asString());
-
-                        if (!IConfig::IsValidNode(k))
-                            continue;
-
-                        auto v = static_cast<uint64_t>(it->asUInt64());
-
-                        if (v == 0)
-                            continue;
-
-                        if (colGroups.find(v) == colGroups.end())
-                            continue;
-
-                        nodeColGroupMap.emplace(k, v);
-                    }
-                }
-            }
+            ParseCollisionGroups(root, colGroups, nodeColGroupMap);
+            FilterCollisionGroups(nodeColGroupMap);
 
             IConfig::SetCollisionGroups(std::move(colGroups));
             IConfig::SetNodeCollisionGroupMap(std::move(nodeColGroupMap));
@@ -894,42 +537,169 @@ namespace CBP
         return 1;
     }
 
-    size_t ISerialization::LoadGlobalProfile(SKSESerializationInterface* intfc, std::stringstream& a_data)
+    size_t ISerialization::LoadGlobalProfile(SKSESerializationInterface* intfc, std::istream& a_data)
     {
         try
         {
             Json::Value root;
 
-            a_data >> root;
+            a_data >> root;
+
+            return _LoadGlobalProfile(root);
+        }
+        catch (const std::exception& e)
+        {
+            m_lastException = e;
+            Error("%s (Load): %s", __FUNCTION__, e.what());
+            return 0;
+        }
+    }
+
+    bool ISerialization::LoadDefaultProfile()
+    {
+        try
+        {
+            Json::Value root;
+
+            auto& driverConf = DCBP::GetDriverConfig();
+
+            ReadData(driverConf.paths.defaultProfile, root);
+
+            return _LoadGlobalProfile(root) != 0;
+        }
+        catch (const std::exception& e)
+        {
+            m_lastException = e;
+            Error("%s (Load): %s", __FUNCTION__, e.what());
+            return false;
+        }
+    }
+
+    bool ISerialization::_LoadActorEntry(
+        SKSESerializationInterface* intfc,
+        const std::string& a_key,
+        const Json::Value& a_entry,
+        actorConfigComponentsHolder_t& a_actorConfigComponents,
+        actorConfigNodesHolder_t& a_nodeData,
+        bool a_updateMaps)
+    {
+        if (!a_entry.isObject()) {
+            Error("Expected an object");
+            return false;
+        }
+
+        Game::ObjectHandle handle;
+
+        try {
+            handle = static_cast<Game::ObjectHandle>(std::stoull(a_key));
+        }
+        catch (...) {
+            Error("Exception while trying to convert handle");
+            return false;
+        }
+
+        if (handle == 0) {
+            Warning("handle == 0");
+            return false;
+        }
+
+        Game::ObjectHandle newHandle = 0;
+
+        if (intfc != nullptr)
+        {
+            if (!SKSE::ResolveHandle(intfc, handle, newHandle)) {
+                Error("0x%llX: Couldn't resolve handle, discarding", handle);
+                return false;
+            }
+
+            if (newHandle == 0) {
+                Error("0x%llX: newHandle == 0", handle);
+                return false;
+            }
+        }
+        else {
+            if (!ResolvePluginHandle(a_entry, handle, newHandle))
+                newHandle = handle;
+        }
+
+        configComponents_t componentData;
+
+        if (m_componentParser.Parse(a_entry, componentData)) {
+            a_actorConfigComponents.emplace(newHandle, std::move(componentData));
+            if (a_updateMaps)
+                IData::UpdateActorMaps(newHandle);
+        }
+
+        configNodes_t nodeData;
+
+        if (m_nodeParser.Parse(a_entry, nodeData))
+            a_nodeData.emplace(newHandle, std::move(nodeData));
+
+        return true;
+    }
+
+    bool ISerialization::_LoadRaceEntry(
+        SKSESerializationInterface* intfc,
+        const std::string& a_key,
+        const Json::Value& a_entry,
+        raceConfigComponentsHolder_t& a_raceConfigComponents,
+        raceConfigNodesHolder_t& a_nodeData)
+    {
+        if (!a_entry.isObject()) {
+            Error("Expected an object");
+            return false;
+        }
+
+        Game::FormID formID;
 
-            return _LoadGlobalProfile(root);
+        try {
+            formID = static_cast<Game::FormID>(std::stoul(a_key));
         }
-        catch (const std::exception& e)
-        {
-            m_lastException = e;
-            Error("%s (Load): %s", __FUNCTION__, e.what());
-            return 0;
+        catch (...) {
+            Error("Exception while trying to convert formID");
+            return false;
         }
-    }
 
-    bool ISerialization::LoadDefaultProfile()
-    {
-        try
-        {
-            Json::Value root;
+        if (formID == 0) {
+            Error("formID == 0");
+            return false;
+        }
 
-            auto& driverConf = DCBP::GetDriverConfig();
+        Game::FormID newFormID = 0;
 
-            ReadData(driverConf.paths.defaultProfile, root);
+        if (intfc != nullptr) {
+            if (!SKSE::ResolveRaceForm(intfc, formID, newFormID)) {
+                Error("0x%lX: Couldn't resolve handle, discarding", formID);
+                return false;
+            }
 
-            return _LoadGlobalProfile(root) != 0;
+            if (newFormID == 0) {
+                Error("0x%lX: newFormID == 0", formID);
+                return false;
+            }
         }
-        catch (const std::exception& e)
-        {
-            m_lastException = e;
-            Error("%s (Load): %s", __FUNCTION__, e.what());
+        else {
+            if (!ResolvePluginFormID(a_entry, formID, newFormID))
+                newFormID = formID;
+        }
+
+        auto& rl = IData::GetRaceList();
+        if (rl.find(newFormID) == rl.end()) {
+            Warning("0x%X: race record not found", newFormID);
             return false;
         }
+
+        configComponents_t componentData;
+
+        if (m_componentParser.Parse(a_entry, componentData))
+            a_raceConfigComponents.emplace(newFormID, std::move(componentData));
+
+        configNodes_t nodeData;
+
+        if (m_nodeParser.Parse(a_entry, nodeData))
+            a_nodeData.emplace(newFormID, std::move(nodeData));
+
+        return true;
     }
 
     size_t ISerialization::_LoadActorProfiles(
@@ -949,58 +719,11 @@ namespace CBP
 
         for (auto it = a_root.begin(); it != a_root.end(); ++it)
         {
-            if (!it->isObject()) {
-                Error("Expected an object");
-                continue;
-            }
-
-            Game::ObjectHandle handle;
-
-            try {
-                handle = static_cast<Game::ObjectHandle>(std::stoull(it.key().asString()));
-            }
-            catch (...) {
-                Error("Exception while trying to convert handle");
-                continue;
-            }
-
-            if (handle == 0) {
-                Warning("handle == 0");
-                continue;
-            }
-
-            Game::ObjectHandle newHandle = 0;
-
-            if (intfc != nullptr)
+            if (_LoadActorEntry(intfc, it.key().asString(), *it,
+                a_actorConfigComponents, a_nodeData, true))
             {
-                if (!SKSE::ResolveHandle(intfc, handle, newHandle)) {
-                    Error("0x%llX: Couldn't resolve handle, discarding", handle);
-                    continue;
-                }
-
-                if (newHandle == 0) {
-                    Error("0x%llX: newHandle == 0", handle);
-                    continue;
-                }
-            }
-            else {
-                if (!ResolvePluginHandle(*it, handle, newHandle))
-                    newHandle = handle;
-            }
-
-            configComponents_t componentData;
-
-            if (m_componentParser.Parse(*it, componentData)) {
-                a_actorConfigComponents.emplace(newHandle, std::move(componentData));
-                IData::UpdateActorMaps(newHandle);
+                c++;
             }
-
-            configNodes_t nodeData;
-
-            if (m_nodeParser.Parse(*it, nodeData))
-                a_nodeData.emplace(newHandle, std::move(nodeData));
-
-            c++;
         }
 
         return c;
@@ -1022,68 +745,17 @@ namespace CBP
 
         for (auto it = a_root.begin(); it != a_root.end(); ++it)
         {
-            if (!it->isObject()) {
-                Error("Expected an object");
-                continue;
-            }
-
-            Game::FormID formID;
-
-            try {
-                formID = static_cast<Game::FormID>(std::stoul(it.key().asString()));
-            }
-            catch (...) {
-                Error("Exception while trying to convert formID");
-                continue;
-            }
-
-            if (formID == 0) {
-                Error("formID == 0");
-                continue;
-            }
-
-            Game::FormID newFormID = 0;
-
-            if (intfc != nullptr) {
-                if (!SKSE::ResolveRaceForm(intfc, formID, newFormID)) {
-                    Error("0x%lX: Couldn't resolve handle, discarding", formID);
-                    continue;
-                }
-
-                if (newFormID == 0) {
-                    Error("0x%lX: newFormID == 0", formID);
-                    continue;
-                }
-            }
-            else {
-                if (!ResolvePluginFormID(*it, formID, newFormID))
-                    newFormID = formID;
-            }
-
-            auto& rl = IData::GetRaceList();
-            if (rl.find(newFormID) == rl.end()) {
-                Warning("0x%X: race record not found", newFormID);
-                continue;
+            if (_LoadRaceEntry(intfc, it.key().asString(), *it,
+                a_raceConfigComponents, a_nodeData))
+            {
+                c++;
             }
-
-            configComponents_t componentData;
-
-            if (m_componentParser.Parse(*it, componentData))
-                a_raceConfigComponents.emplace(newFormID, std::move(componentData));
-
-            configNodes_t nodeData;
-
-            if (m_nodeParser.Parse(*it, nodeData))
-                a_nodeData.emplace(newFormID, std::move(nodeData));
-
-            c++;
         }
 
-
         return c;
     }
 
-    size_t ISerialization::LoadActorProfiles(SKSESerializationInterface* intfc, std::stringstream& a_data)
+    size_t ISerialization::LoadActorProfiles(SKSESerializationInterface* intfc, std::istream& a_data)
     {
         try
         {
@@ -1109,18 +781,162 @@ namespace CBP
         }
     }
 
-    void ISerialization::ReadImportData(const fs::path& a_path, Json::Value& a_out) const
+    // a member set to null is treated as an empty object
+    SKMP_FORCEINLINE static bool IsNullRange(const char* a_begin, const char* a_end)
     {
-        ReadData(a_path, a_out);
+        return a_end - a_begin == 4 && std::memcmp(a_begin, "null", 4) == 0;
+    }
 
-        if (a_out.empty())
-            throw std::exception("Empty root object");
+    struct importRanges_t
+    {
+        const char* actors[2]{ nullptr, nullptr };
+        const char* races[2]{ nullptr, nullptr };
+        const char* global[2]{ nullptr, nullptr };
+    };
 
-        if (!a_out.isMember("actors") ||
-            !a_out.isMember("races") ||
-            !a_out.isMember("global"))
+    static void ScanImportRoot(const char* a_begin, const char* a_end, importRanges_t& a_out)
+    {
+        Serialization::ObjectScanner scanner(a_begin, a_end);
+
+        std::string key;
+        const char* b;
+        const char* e;
+
+        while (scanner.Next(key, b, e))
         {
+            const char** out;
+
+            if (key == "actors")
+                out = a_out.actors;
+            else if (key == "races")
+                out = a_out.races;
+            else if (key == "global")
+                out = a_out.global;
+            else
+                continue;
+
+            out[0] = b;
+            out[1] = e;
+        }
+
+        if (!a_out.actors[0] || !a_out.races[0] || !a_out.global[0])
             throw std::exception("One or more expected members not found");
+    }
+
+    static size_t CountSection(const char* const a_range[2])
+    {
+        if (IsNullRange(a_range[0], a_range[1]))
+            return 0;
+
+        return Serialization::ObjectScanner::CountMembers(a_range[0], a_range[1]);
+    }
+
+    void ISerialization::ReadImport(
+        SKSESerializationInterface* intfc,
+        const fs::path& a_path,
+        ImportFlags a_flags,
+        configHolders_t& a_out,
+        asyncProgress_t* a_progress)
+    {
+        using namespace boost::iostreams;
+
+        if (fs::file_size(a_path) == 0)
+            throw std::exception("Empty root object");
+
+        mapped_file_source file(a_path);
+        if (!file.is_open())
+            throw std::exception("Couldn't map file");
+
+        auto end = file.data() + file.size();
+
+        importRanges_t ranges;
+        ScanImportRoot(file.data(), end, ranges);
+
+        bool actors = (a_flags & ImportFlags::Actors) == ImportFlags::Actors;
+        bool races = (a_flags & ImportFlags::Races) == ImportFlags::Races;
+
+        if (a_progress)
+        {
+            size_t total(0);
+
+            if (actors)
+                total += CountSection(ranges.actors);
+            if (races)
+                total += CountSection(ranges.races);
+
+            a_progress->total.store(total);
+        }
+
+        std::string key;
+        const char* b;
+        const char* e;
+
+        if (actors && !IsNullRange(ranges.actors[0], ranges.actors[1]))
+        {
+            Serialization::ObjectScanner scanner(ranges.actors[0], ranges.actors[1]);
+
+            while (scanner.Next(key, b, e))
+            {
+                Json::Value entry;
+                Serialization::ParseRange(b, e, entry);
+
+                _LoadActorEntry(intfc, key, entry, a_out.actorPhysics, a_out.actorNode, false);
+
+                if (a_progress)
+                    a_progress->done++;
+            }
+        }
+
+        if (races && !IsNullRange(ranges.races[0], ranges.races[1]))
+        {
+            Serialization::ObjectScanner scanner(ranges.races[0], ranges.races[1]);
+
+            while (scanner.Next(key, b, e))
+            {
+                Json::Value entry;
+                Serialization::ParseRange(b, e, entry);
+
+                _LoadRaceEntry(intfc, key, entry, a_out.racePhysics, a_out.raceNode);
+
+                if (a_progress)
+                    a_progress->done++;
+            }
+        }
+
+        if ((a_flags & ImportFlags::Global) == ImportFlags::Global)
+        {
+            Json::Value global;
+            Serialization::ParseRange(ranges.global[0], ranges.global[1], global);
+
+            if (!m_componentParser.Parse(global, a_out.globalPhysics))
+                throw std::exception("Error while parsing global component data");
+
+            if (!m_nodeParser.Parse(global, a_out.globalNode))
+                throw std::exception("Error while parsing global node data");
+        }
+    }
+
+    void ISerialization::ApplyImport(configHolders_t& a_data, ImportFlags a_flags)
+    {
+        if ((a_flags & ImportFlags::Actors) == ImportFlags::Actors)
+        {
+            for (const auto& e : a_data.actorPhysics)
+                IData::UpdateActorMaps(e.first);
+
+            IConfig::SetActorPhysicsConfigHolder(std::move(a_data.actorPhysics));
+            IConfig::SetActorNodeHolder(std::move(a_data.actorNode));
+        }
+
+        if ((a_flags & ImportFlags::Races) == ImportFlags::Races)
+        {
+            IConfig::SetRacePhysicsHolder(std::move(a_data.racePhysics));
+            IConfig::SetRaceNodeHolder(std::move(a_data.raceNode));
+        }
+
+        if ((a_flags & ImportFlags::Global) == ImportFlags::Global)
+        {
+            IConfig::SetGlobalPhysics(std::move(a_data.globalPhysics));
+            IConfig::SetGlobalNode(std::move(a_data.globalNode));
         }
     }
 
@@ -1128,12 +944,20 @@ namespace CBP
     {
         try
         {
-            Json::Value root;
+            using namespace boost::iostreams;
+
+            if (fs::file_size(a_path) == 0)
+                throw std::exception("Empty root object");
 
-            ReadImportData(a_path, root);
+            mapped_file_source file(a_path);
+            if (!file.is_open())
+                throw std::exception("Couldn't map file");
 
-            a_out.numActors = static_cast<size_t>(root["actors"].size());
-            a_out.numRaces = static_cast<size_t>(root["races"].size());
+            importRanges_t ranges;
+            ScanImportRoot(file.data(), file.data() + file.size(), ranges);
+
+            a_out.numActors = CountSection(ranges.actors);
+            a_out.numRaces = CountSection(ranges.races);
 
             return true;
         }
@@ -1148,110 +972,293 @@ namespace CBP
     {
         try
         {
-            Json::Value root;
+            configHolders_t data;
 
-            ReadImportData(a_path, root);
+            ReadImport(intfc, a_path, a_flags, data, nullptr);
+            ApplyImport(data, a_flags);
 
-            actorConfigComponentsHolder_t actorConfigComponents;
-            actorConfigNodesHolder_t actorConfigNodes;
-            raceConfigComponentsHolder_t raceConfigComponents;
-            raceConfigNodesHolder_t raceConfigNodes;
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            m_lastException = e;
+            Error("%s: %s", __FUNCTION__, e.what());
+            return false;
+        }
+    }
 
-            configComponents_t globalComponentData;
-            configNodes_t globalNodeData;
+    void ISerialization::TakeSnapshot(configHolders_t& a_out) const
+    {
+        a_out.globalPhysics = IConfig::GetGlobalPhysics();
+        a_out.globalNode = IConfig::GetGlobalNode();
+        a_out.actorPhysics = IConfig::GetActorPhysicsHolder();
+        a_out.actorNode = IConfig::GetActorNodeHolder();
+        a_out.racePhysics = IConfig::GetRacePhysicsHolder();
+        a_out.raceNode = IConfig::GetRaceNodeHolder();
+    }
+
+    template <class Tp, class Tn>
+    static auto CollectKeys(const Tp& a_physics, const Tn& a_node)
+    {
+        stl::vector<typename Tp::key_type> keys;
+        keys.reserve(a_physics.size() + a_node.size());
 
-            if ((a_flags & ImportFlags::Actors) == ImportFlags::Actors)
-                _LoadActorProfiles(intfc, root["actors"], actorConfigComponents, actorConfigNodes);
+        for (const auto& e : a_physics)
+            keys.emplace_back(e.first);
+        for (const auto& e : a_node)
+            keys.emplace_back(e.first);
 
-            if ((a_flags & ImportFlags::Races) == ImportFlags::Races)
-                _LoadRaceProfiles(intfc, root["races"], raceConfigComponents, raceConfigNodes);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
 
-            if ((a_flags & ImportFlags::Global) == ImportFlags::Global)
-            {
-                if (!m_componentParser.Parse(root["global"], globalComponentData))
-                    throw std::exception("Error while parsing global component data");
+        return keys;
+    }
 
-                if (!m_nodeParser.Parse(root["global"], globalNodeData))
-                    throw std::exception("Error while parsing global node data");
-            }
+    void ISerialization::WriteExport(const fs::path& a_path, const configHolders_t& a_data, asyncProgress_t* a_progress)
+    {
+        auto actors = CollectKeys(a_data.actorPhysics, a_data.actorNode);
+        auto races = CollectKeys(a_data.racePhysics, a_data.raceNode);
+
+        if (a_progress)
+            a_progress->total.store(actors.size() + races.size());
+
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "\t";
+
+        std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
 
-            if ((a_flags & ImportFlags::Actors) == ImportFlags::Actors)
+        Serialization::WriteStream(a_path, [&](std::ofstream& a_out)
             {
-                IConfig::SetActorPhysicsConfigHolder(std::move(actorConfigComponents));
-                IConfig::SetActorNodeHolder(std::move(actorConfigNodes));
-            }
+                auto writeEntry = [&](const std::string& a_key, const Json::Value& a_value, bool a_first)
+                {
+                    a_out << (a_first ? "\n" : ",\n") << Json::valueToQuotedString(a_key.c_str()) << " : ";
+                    writer->write(a_value, std::addressof(a_out));
+
+                    if (a_progress)
+                        a_progress->done++;
+                };
+
+                a_out << "{\n\"actors\" : {";
 
-            if ((a_flags & ImportFlags::Races) == ImportFlags::Races)
+                for (auto it = actors.begin(); it != actors.end(); ++it)
+                {
+                    Json::Value actor;
+
+                    auto itp = a_data.actorPhysics.find(*it);
+                    if (itp != a_data.actorPhysics.end())
+                        m_componentParser.Create(itp->second, actor);
+
+                    auto itn = a_data.actorNode.find(*it);
+                    if (itn != a_data.actorNode.end())
+                        m_nodeParser.Create(itn->second, actor);
+
+                    ResolvePluginName(it->GetFormID(), actor);
+
+                    writeEntry(std::to_string(*it), actor, it == actors.begin());
+                }
+
+                a_out << "\n},\n\"races\" : {";
+
+                for (auto it = races.begin(); it != races.end(); ++it)
+                {
+                    Json::Value race;
+
+                    auto itp = a_data.racePhysics.find(*it);
+                    if (itp != a_data.racePhysics.end())
+                        m_componentParser.Create(itp->second, race);
+
+                    auto itn = a_data.raceNode.find(*it);
+                    if (itn != a_data.raceNode.end())
+                        m_nodeParser.Create(itn->second, race);
+
+                    ResolvePluginName(*it, race);
+
+                    writeEntry(std::to_string(*it), race, it == races.begin());
+                }
+
+                Json::Value global;
+
+                m_componentParser.Create(a_data.globalPhysics, global);
+                m_nodeParser.Create(a_data.globalNode, global);
+
+                a_out << "\n},\n\"global\" : ";
+                writer->write(global, std::addressof(a_out));
+                a_out << "\n}\n";
+            });
+    }
+
+    bool ISerialization::Export(const fs::path& a_path)
+    {
+        try
+        {
+            configHolders_t data;
+
+            TakeSnapshot(data);
+            WriteExport(a_path, data, nullptr);
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            m_lastException = e;
+            Error("%s: %s", __FUNCTION__, e.what());
+            return false;
+        }
+    }
+
+    ISerialization::~ISerialization() noexcept
+    {
+        if (m_async.thread.joinable())
+            m_async.thread.join();
+    }
+
+    bool ISerialization::ImportAsync(
+        const fs::path& a_path,
+        ImportFlags a_flags,
+        TaskDelegate* a_onDone)
+    {
+        if (m_async.state.load() != AsyncState::Idle) {
+            m_lastException = std::exception("Another import/export is in progress");
+            return false;
+        }
+
+        m_async.data = configHolders_t();
+        m_async.flags = a_flags;
+        m_async.progress.done.store(0);
+        m_async.progress.total.store(0);
+        m_async.cancelled.store(false);
+        m_async.resultOp = AsyncOp::None;
+        m_async.op.store(AsyncOp::Import);
+        m_async.state.store(AsyncState::Running);
+
+        m_async.thread = std::thread([this, a_path, a_flags, a_onDone]
             {
-                IConfig::SetRacePhysicsHolder(std::move(raceConfigComponents));
-                IConfig::SetRaceNodeHolder(std::move(raceConfigNodes));
-            }
+                try
+                {
+                    ReadImport(nullptr, a_path, a_flags, m_async.data, std::addressof(m_async.progress));
+                    m_async.state.store(AsyncState::Finished);
+                }
+                catch (const std::exception& e)
+                {
+                    m_async.except = e;
+                    Error("%s: %s", "ImportAsync", e.what());
+                    m_async.state.store(AsyncState::Failed);
+                }
 
-            if ((a_flags & ImportFlags::Global) == ImportFlags::Global)
+                DTasks::AddTask(a_onDone);
+            });
+
+        return true;
+    }
+
+    bool ISerialization::ExportAsync(
+        const fs::path& a_path,
+        TaskDelegate* a_onDone)
+    {
+        if (m_async.state.load() != AsyncState::Idle) {
+            m_lastException = std::exception("Another import/export is in progress");
+            return false;
+        }
+
+        m_async.data = configHolders_t();
+        TakeSnapshot(m_async.data);
+
+        m_async.progress.done.store(0);
+        m_async.progress.total.store(0);
+        m_async.cancelled.store(false);
+        m_async.resultOp = AsyncOp::None;
+        m_async.op.store(AsyncOp::Export);
+        m_async.state.store(AsyncState::Running);
+
+        m_async.thread = std::thread([this, a_path, a_onDone]
             {
-                IConfig::SetGlobalPhysics(std::move(globalComponentData));
-                IConfig::SetGlobalNode(std::move(globalNodeData));
-            }
+                try
+                {
+                    WriteExport(a_path, m_async.data, std::addressof(m_async.progress));
+                    m_async.state.store(AsyncState::Finished);
+                }
+                catch (const std::exception& e)
+                {
+                    m_async.except = e;
+                    Error("%s: %s", "ExportAsync", e.what());
+                    m_async.state.store(AsyncState::Failed);
+                }
+
+                DTasks::AddTask(a_onDone);
+            });
 
-            return true;
-        }
-        catch (const std::exception& e)
-        {
-            m_lastException = e;
-            Error("%s: %s", __FUNCTION__, e.what());
-            return false;
-        }
+        return true;
     }
 
-    bool ISerialization::Export(const fs::path& a_path)
+    auto ISerialization::GetAsyncStatus() const -> asyncStatus_t
     {
-        try
-        {
-            Json::Value root;
+        return {
+            m_async.op.load(),
+            m_async.state.load(),
+            m_async.progress.done.load(),
+            m_async.progress.total.load()
+        };
+    }
 
-            auto& actors = root["actors"];
+    bool ISerialization::CompleteAsync()
+    {
+        auto state = m_async.state.load();
 
-            for (const auto& e : IConfig::GetActorPhysicsHolder()) {
-                auto& actor = actors[std::to_string(e.first)];
-                m_componentParser.Create(e.second, actor);
-                ResolvePluginName(e.first.GetFormID(), actor);
-            }
+        if (state != AsyncState::Finished &&
+            state != AsyncState::Failed)
+        {
+            return false;
+        }
 
-            for (const auto& e : IConfig::GetActorNodeHolder()) {
-                auto& actor = actors[std::to_string(e.first)];
-                m_nodeParser.Create(e.second, actor);
-                ResolvePluginName(e.first.GetFormID(), actor);
-            }
+        if (m_async.thread.joinable())
+            m_async.thread.join();
 
-            auto& races = root["races"];
+        auto op = m_async.op.load();
+        bool result = state == AsyncState::Finished;
 
-            for (const auto& e : IConfig::GetRacePhysicsHolder()) {
-                auto& race = races[std::to_string(e.first)];
-                m_componentParser.Create(e.second, race);
-                ResolvePluginName(e.first, race);
+        if (result)
+        {
+            if (op == AsyncOp::Import)
+            {
+                // parsed against a game that has since been reverted or loaded
+                if (m_async.cancelled.load())
+                {
+                    m_lastException = std::exception("Import cancelled, the game was loaded or reverted");
+                    result = false;
+                }
+                else
+                    ApplyImport(m_async.data, m_async.flags);
             }
+        }
+        else
+            m_lastException = m_async.except;
 
-            for (const auto& e : IConfig::GetRaceNodeHolder()) {
-                auto& race = races[std::to_string(e.first)];
-                m_nodeParser.Create(e.second, race);
-                ResolvePluginName(e.first, race);
-            }
+        m_async.data = configHolders_t();
+        m_async.resultOp = op;
+        m_async.result = result;
+        m_async.op.store(AsyncOp::None);
+        m_async.state.store(AsyncState::Idle);
 
-            auto& global = root["global"];
+        return result;
+    }
 
-            m_componentParser.Create(IConfig::GetGlobalPhysics(), global);
-            m_nodeParser.Create(IConfig::GetGlobalNode(), global);
+    void ISerialization::CancelAsync()
+    {
+        if (m_async.state.load() != AsyncState::Idle)
+            m_async.cancelled.store(true);
 
-            WriteData(a_path, root);
+        m_async.resultOp = AsyncOp::None;
+    }
 
-            return true;
-        }
-        catch (const std::exception& e)
-        {
-            m_lastException = e;
-            Error("%s: %s", __FUNCTION__, e.what());
+    bool ISerialization::TakeAsyncResult(AsyncOp a_op, bool& a_result)
+    {
+        if (a_op == AsyncOp::None || m_async.resultOp != a_op)
             return false;
-        }
+
+        a_result = m_async.result;
+        m_async.resultOp = AsyncOp::None;
+
+        return true;
     }
 
     void ISerialization::ResolvePluginName(Game::FormID a_formid, Json::Value& a_out)
@@ -1308,7 +1315,7 @@ namespace CBP
         return true;
     }
 
-    size_t ISerialization::LoadRaceProfiles(SKSESerializationInterface* intfc, std::stringstream& a_data)
+    size_t ISerialization::LoadRaceProfiles(SKSESerializationInterface* intfc, std::istream& a_data)
     {
         try
         {
@@ -1747,7 +1754,7 @@ namespace CBP
         }
     }
 
-    size_t ISerialization::BinSerializeLoad(SKSESerializationInterface* intfc, std::stringstream& a_in)
+    size_t ISerialization::BinSerializeLoad(SKSESerializationInterface* intfc, std::istream& a_in)
     {
         try
         {
@@ -1776,11 +1783,21 @@ namespace CBP
             IConfig::SetGlobalPhysics(std::move(globalComponentData));
             IConfig::SetGlobalNode(std::move(globalNodeData));
 
-            MoveActorConfig(intfc, actorConfigComponents, IConfig::GetActorPhysicsHolder());
-            MoveActorConfig(intfc, actorConfigNodes, IConfig::GetActorNodeHolder());
+            actorConfigComponentsHolder_t actorPhysics;
+            MoveActorConfig(intfc, actorConfigComponents, actorPhysics);
+            IConfig::SetActorPhysicsConfigHolder(std::move(actorPhysics));
 
-            MoveRaceConfig(intfc, raceConfigComponents, IConfig::GetRacePhysicsHolder());
-            MoveRaceConfig(intfc, raceConfigNodes, IConfig::GetRaceNodeHolder());
+            actorConfigNodesHolder_t actorNode;
+            MoveActorConfig(intfc, actorConfigNodes, actorNode);
+            IConfig::SetActorNodeHolder(std::move(actorNode));
+
+            raceConfigComponentsHolder_t racePhysics;
+            MoveRaceConfig(intfc, raceConfigComponents, racePhysics);
+            IConfig::SetRacePhysicsHolder(std::move(racePhysics));
+
+            raceConfigNodesHolder_t raceNode;
+            MoveRaceConfig(intfc, raceConfigNodes, raceNode);
+            IConfig::SetRaceNodeHolder(std::move(raceNode));
 
             return num;
         }
@@ -1790,4 +1807,495 @@ namespace CBP
         }
     }
 
+    static std::uint64_t HashBlock(const stl::vector<char>& a_data)
+    {
+        // FNV-1a
+        std::uint64_t h = 14695981039346656037ULL;
+
+        for (auto c : a_data)
+        {
+            h ^= static_cast<std::uint8_t>(c);
+            h *= 1099511628211ULL;
+        }
+
+        return h;
+    }
+
+    SKMP_FORCEINLINE static std::uint32_t GetBlockBucket(std::uint64_t a_key, std::uint32_t a_numBuckets)
+    {
+        return static_cast<std::uint32_t>((a_key * 0x9E3779B97F4A7C15ULL) >> 32) % a_numBuckets;
+    }
+
+    // Iteration order (and the bucket count boost writes) of an unordered map
+    // depends on its insert/rehash history. Rebuilt in key order with a
+    // size-derived capacity, equal maps always serialize to identical bytes
+    // and the stock loader still reads them.
+    template <class Archive, class T>
+    static void SaveSortedMap(Archive& a_ar, const T& a_map)
+    {
+        stl::vector<const typename T::value_type*> items;
+        items.reserve(a_map.size());
+
+        for (const auto& e : a_map)
+            items.emplace_back(std::addressof(e));
+
+        std::sort(items.begin(), items.end(),
+            [](auto a_lhs, auto a_rhs) { return a_lhs->first < a_rhs->first; });
+
+        T tmp;
+        tmp.reserve(items.size());
+
+        for (auto e : items)
+            tmp.emplace(*e);
+
+        a_ar << tmp;
+    }
+
+    auto ISerialization::GetSectionStats(BlockSection a_section) -> statsEntry_t&
+    {
+        switch (a_section)
+        {
+        case BlockSection::GlobalNode:
+            return m_stats.globalNode;
+        case BlockSection::ActorPhysics:
+            return m_stats.actorPhysics;
+        case BlockSection::ActorNode:
+            return m_stats.actorNode;
+        case BlockSection::RacePhysics:
+            return m_stats.racePhysics;
+        case BlockSection::RaceNode:
+            return m_stats.raceNode;
+        default:
+            return m_stats.globalPhysics;
+        }
+    }
+
+    template <class Tf>
+    void ISerialization::PrepareBlock(
+        std::uint32_t a_id,
+        std::uint32_t a_count,
+        Tf a_func)
+    {
+        auto& scratch = m_blockScratch;
+        scratch.clear();
+
+        IConfigSchema::Writer out(scratch);
+        IConfigSchema::BlockWriter ar(out);
+
+        a_func(ar);
+
+        auto hash = HashBlock(scratch);
+
+        m_blockOrder.emplace_back(a_id);
+
+        m_blockStats.total++;
+        m_blockStats.raw += scratch.size();
+
+        auto it = m_blockCache.find(a_id);
+        if (it != m_blockCache.end())
+        {
+            auto& e = it->second;
+
+            if (e.hash == hash &&
+                e.count == a_count &&
+                e.schema == IConfigSchema::VERSION &&
+                e.codec == m_encode.codec &&
+                e.level == m_encode.level &&
+                !e.data.empty())
+            {
+                m_blockStats.reused++;
+                return;
+            }
+        }
+
+        auto& job = m_encode.jobs.emplace_back();
+
+        job.id = a_id;
+        job.count = a_count;
+        job.hash = hash;
+        job.raw.swap(scratch);
+        job.failed = false;
+    }
+
+    template <class T>
+    void ISerialization::PrepareHolderBlocks(
+        BlockSection a_section,
+        const T& a_data)
+    {
+        PerfTimer pt;
+        pt.Start();
+
+        // sorted so unchanged buckets serialize to identical bytes
+        stl::vector<const typename T::value_type*> buckets[NUM_BLOCK_BUCKETS];
+
+        for (const auto& e : a_data)
+            buckets[GetBlockBucket(static_cast<std::uint64_t>(e.first), NUM_BLOCK_BUCKETS)].emplace_back(std::addressof(e));
+
+        for (std::uint32_t i = 0; i < NUM_BLOCK_BUCKETS; i++)
+        {
+            auto& b = buckets[i];
+            if (b.empty())
+                continue;
+
+            std::sort(b.begin(), b.end(),
+                [](auto a_lhs, auto a_rhs) { return a_lhs->first < a_rhs->first; });
+
+            PrepareBlock(MakeBlockId(a_section, i), static_cast<std::uint32_t>(b.size()),
+                [&](auto& a_ar)
+                {
+                    for (auto e : b)
+                    {
+                        a_ar << e->first;
+                        SaveSortedMap(a_ar, e->second);
+                    }
+                });
+        }
+
+        GetSectionStats(a_section) = {
+            pt.Stop(),
+            a_data.size()
+        };
+    }
+
+    size_t ISerialization::RunEncodeJobs()
+    {
+        size_t n(0);
+
+        for (;;)
+        {
+            auto i = m_encode.next.fetch_add(1);
+            if (i >= m_encode.jobs.size())
+                break;
+
+            auto& job = m_encode.jobs[i];
+
+            try
+            {
+                Codec::Encode(m_encode.codec, m_encode.level, job.raw.data(), job.raw.size(), job.encoded);
+            }
+            catch (const std::exception& e)
+            {
+                Error("%s: [%.8X]: %s", __FUNCTION__, job.id, e.what());
+                job.failed = true;
+            }
+
+            n++;
+        }
+
+        return n;
+    }
+
+    bool ISerialization::BlockSerializeBegin(Codec::Type a_codec, int a_level)
+    {
+        m_blockOrder.clear();
+        m_blockStats = { 0, 0, 0, 0, 0, 0 };
+
+        m_encode.jobs.clear();
+        m_encode.next.store(0);
+        m_encode.codec = a_codec;
+        m_encode.level = a_level;
+
+        try
+        {
+            PerfTimer pt;
+
+            pt.Start();
+            PrepareBlock(MakeBlockId(BlockSection::GlobalPhysics, 0), 1,
+                [](auto& a_ar) { SaveSortedMap(a_ar, IConfig::GetGlobalPhysics()); });
+            m_stats.globalPhysics.time = pt.Stop();
+
+            pt.Start();
+            PrepareBlock(MakeBlockId(BlockSection::GlobalNode, 0), 1,
+                [](auto& a_ar) { SaveSortedMap(a_ar, IConfig::GetGlobalNode()); });
+            m_stats.globalNode.time = pt.Stop();
+
+            PrepareHolderBlocks(BlockSection::ActorPhysics, IConfig::GetActorPhysicsHolder());
+            PrepareHolderBlocks(BlockSection::ActorNode, IConfig::GetActorNodeHolder());
+            PrepareHolderBlocks(BlockSection::RacePhysics, IConfig::GetRacePhysicsHolder());
+            PrepareHolderBlocks(BlockSection::RaceNode, IConfig::GetRaceNodeHolder());
+        }
+        catch (const std::exception& e)
+        {
+            Error("%s: %s", __FUNCTION__, e.what());
+            m_blockOrder.clear();
+            m_encode.jobs.clear();
+            return false;
+        }
+
+        auto numWorkers = std::min(m_encode.jobs.size(), static_cast<size_t>(m_encodePool.GetNumThreads()));
+
+        for (size_t i = 0; i < numWorkers; i++)
+        {
+            // whatever isn't picked up is encoded in BlockSerializeEnd
+            if (!m_encodePool.Push([this] { RunEncodeJobs(); }))
+                break;
+        }
+
+        return true;
+    }
+
+    size_t ISerialization::BlockSerializeEnd()
+    {
+        // anything the pool hasn't started yet is encoded here
+        m_blockStats.encodedSync = RunEncodeJobs();
+        m_encodePool.Wait();
+
+        bool failed(false);
+
+        for (const auto& e : m_encode.jobs)
+            failed |= e.failed;
+
+        if (failed)
+        {
+            m_encode.jobs.clear();
+            m_blockOrder.clear();
+            return 0;
+        }
+
+        for (auto& e : m_encode.jobs)
+        {
+            auto& c = m_blockCache[e.id];
+
+            c.data.swap(e.encoded);
+            c.hash = e.hash;
+            c.count = e.count;
+            c.schema = IConfigSchema::VERSION;
+            c.codec = m_encode.codec;
+            c.level = m_encode.level;
+        }
+
+        m_encode.jobs.clear();
+
+        for (auto id : m_blockOrder)
+            m_blockStats.encoded += m_blockCache.at(id).data.size();
+
+        // drop blocks for buckets that emptied out
+        for (auto it = m_blockCache.begin(); it != m_blockCache.end();)
+        {
+            if (std::find(m_blockOrder.begin(), m_blockOrder.end(), it->first) == m_blockOrder.end())
+                it = m_blockCache.erase(it);
+            else
+                ++it;
+        }
+
+        return m_blockOrder.size();
+    }
+
+    bool ISerialization::BlockSerializeWrite(SKSESerializationInterface* intfc)
+    {
+        auto num = static_cast<std::uint32_t>(m_blockOrder.size());
+
+        if (!intfc->WriteRecordData(&num, sizeof(num)))
+            return false;
+
+        for (auto id : m_blockOrder)
+        {
+            auto& e = m_blockCache.at(id);
+
+            blockHeader_t header{ id, e.count, e.hash, static_cast<std::uint32_t>(e.data.size()), e.schema };
+
+            if (!intfc->WriteRecordData(&header, sizeof(header)))
+                return false;
+
+            if (!intfc->WriteRecordData(e.data.data(), header.size))
+                return false;
+        }
+
+        return true;
+    }
+
+    template <class Ta>
+    bool ISerialization::ReadBlock(
+        Ta& a_in,
+        BlockSection a_section,
+        std::uint32_t a_count,
+        configHolders_t& a_out)
+    {
+        switch (a_section)
+        {
+        case BlockSection::GlobalPhysics:
+            a_in >> a_out.globalPhysics;
+            break;
+        case BlockSection::GlobalNode:
+            a_in >> a_out.globalNode;
+            break;
+        case BlockSection::ActorPhysics:
+            for (std::uint32_t i = 0; i < a_count; i++)
+            {
+                Game::ObjectHandle handle;
+                a_in >> handle;
+                a_in >> a_out.actorPhysics[handle];
+            }
+            break;
+        case BlockSection::ActorNode:
+            for (std::uint32_t i = 0; i < a_count; i++)
+            {
+                Game::ObjectHandle handle;
+                a_in >> handle;
+                a_in >> a_out.actorNode[handle];
+            }
+            break;
+        case BlockSection::RacePhysics:
+            for (std::uint32_t i = 0; i < a_count; i++)
+            {
+                Game::FormID formid;
+                a_in >> formid;
+                a_in >> a_out.racePhysics[formid];
+            }
+            break;
+        case BlockSection::RaceNode:
+            for (std::uint32_t i = 0; i < a_count; i++)
+            {
+                Game::FormID formid;
+                a_in >> formid;
+                a_in >> a_out.raceNode[formid];
+            }
+            break;
+        default:
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t ISerialization::BlockSerializeLoad(SKSESerializationInterface* intfc, Codec::Type a_codec, int a_level)
+    {
+        ClearBlockCache();
+
+        m_stats = stats_t();
+        m_blockStats = { 0, 0, 0, 0, 0, 0 };
+
+        IConfigSchema::ResetReadStats();
+
+        try
+        {
+            std::uint32_t num;
+            if (intfc->ReadRecordData(&num, sizeof(num)) != sizeof(num))
+                throw std::exception("Couldn't read block count");
+
+            configHolders_t data;
+
+            size_t total(0);
+
+            for (std::uint32_t i = 0; i < num; i++)
+            {
+                blockHeader_t header;
+                if (intfc->ReadRecordData(&header, sizeof(header)) != sizeof(header))
+                    throw std::exception("Couldn't read block header");
+
+                auto& e = m_blockCache[header.id];
+
+                e.data.resize(header.size);
+                if (intfc->ReadRecordData(e.data.data(), header.size) != header.size)
+                    throw std::exception("Couldn't read block data");
+
+                Codec::Decode(e.data.data(), e.data.size(), m_blockScratch, std::addressof(e.codec));
+
+                if (HashBlock(m_blockScratch) != header.hash)
+                    throw std::exception("Block hash mismatch");
+
+                // reusable on the next save only if the codec settings match
+                e.hash = header.hash;
+                e.count = header.count;
+                e.schema = header.schema;
+                e.level = e.codec == a_codec ? a_level : -1;
+
+                PerfTimer pt;
+                pt.Start();
+
+                auto section = static_cast<BlockSection>(header.id >> 16);
+
+                bool result;
+
+                if (header.schema == IConfigSchema::VERSION)
+                {
+                    IConfigSchema::Reader in(m_blockScratch.data(), m_blockScratch.size());
+                    IConfigSchema::BlockReader ar(in);
+
+                    result = ReadBlock(ar, section, header.count, data);
+                }
+                else if (header.schema == 0)
+                {
+                    // boost archive, written again in the flat schema on the next save
+                    boost::iostreams::stream<boost::iostreams::array_source> in(
+                        m_blockScratch.data(), m_blockScratch.size());
+
+                    boost::archive::binary_iarchive ar(in, boost::archive::no_header);
+
+                    result = ReadBlock(ar, section, header.count, data);
+
+                    m_blockStats.legacy++;
+                }
+                else
+                {
+                    Warning("%s: block %.8X: unsupported schema version %u", __FUNCTION__, header.id, header.schema);
+                    m_blockCache.erase(header.id);
+                    continue;
+                }
+
+                if (!result)
+                {
+                    Warning("%s: unknown block section %u", __FUNCTION__, header.id >> 16);
+                    m_blockCache.erase(header.id);
+                    continue;
+                }
+
+                auto& stats = GetSectionStats(section);
+                stats.time += pt.Stop();
+
+                m_blockStats.total++;
+                m_blockStats.raw += m_blockScratch.size();
+                m_blockStats.encoded += e.data.size();
+
+                total += header.count;
+            }
+
+            auto schemaStats = IConfigSchema::GetReadStats();
+
+            if (schemaStats.unknownFields)
+                Debug("%s: %zu unknown field(s) skipped", __FUNCTION__, schemaStats.unknownFields);
+
+            if (schemaStats.rejected)
+                Warning("%s: %zu invalid value(s) replaced with defaults", __FUNCTION__, schemaStats.rejected);
+
+            m_stats.actorPhysics.num = data.actorPhysics.size();
+            m_stats.actorNode.num = data.actorNode.size();
+            m_stats.racePhysics.num = data.racePhysics.size();
+            m_stats.raceNode.num = data.raceNode.size();
+
+            IConfig::SetGlobalPhysics(std::move(data.globalPhysics));
+            IConfig::SetGlobalNode(std::move(data.globalNode));
+
+            actorConfigComponentsHolder_t actorPhysics;
+            MoveActorConfig(intfc, data.actorPhysics, actorPhysics);
+            IConfig::SetActorPhysicsConfigHolder(std::move(actorPhysics));
+
+            actorConfigNodesHolder_t actorNode;
+            MoveActorConfig(intfc, data.actorNode, actorNode);
+            IConfig::SetActorNodeHolder(std::move(actorNode));
+
+            raceConfigComponentsHolder_t racePhysics;
+            MoveRaceConfig(intfc, data.racePhysics, racePhysics);
+            IConfig::SetRacePhysicsHolder(std::move(racePhysics));
+
+            raceConfigNodesHolder_t raceNode;
+            MoveRaceConfig(intfc, data.raceNode, raceNode);
+            IConfig::SetRaceNodeHolder(std::move(raceNode));
+
+            return total;
+        }
+        catch (const std::exception& e)
+        {
+            Error("%s: %s", __FUNCTION__, e.what());
+            ClearBlockCache();
+            return 0;
+        }
+    }
+
+    void ISerialization::ClearBlockCache()
+    {
+        m_blockCache.clear();
+        m_blockOrder.clear();
+    }
+
 }
\ No newline at end of file
@@ -1,31 +1,5 @@
 #pragma once
 
-namespace Serialization
-{
-    template<>
-    bool Parser<CBP::configComponents_t>::Parse(const Json::Value& a_in, CBP::configComponents_t& a_outData) const;
-    template<>
-    void Parser<CBP::configComponents_t>::Create(const CBP::configComponents_t& a_data, Json::Value& a_out) const;
-
-    template<>
-    bool Parser<CBP::configNodes_t>::Parse(const Json::Value& a_in, CBP::configNodes_t& a_out) const;
-    template<>
-    void Parser<CBP::configNodes_t>::Create(const CBP::configNodes_t& a_data, Json::Value& a_out) const;
-
-
-    template<>
-    bool Parser<CBP::nodeMap_t>::Parse(const Json::Value& a_in, CBP::nodeMap_t& a_out) const;
-    template<>
-    void Parser<CBP::configGroupMap_t>::Create(const CBP::configGroupMap_t& a_data, Json::Value& a_out) const;
-
-    template<>
-    void Parser<CBP::configComponents_t>::GetDefault(CBP::configComponents_t& a_out) const;
-    template<>
-    void Parser<CBP::configNodes_t>::GetDefault(CBP::configNodes_t& a_out) const;
-    template<>
-    void Parser<CBP::nodeMap_t>::GetDefault(CBP::nodeMap_t& a_out) const;
-}
-
 namespace CBP
 {
     struct importInfo_t
@@ -71,29 +45,115 @@ namespace CBP
             statsEntry_t raceNode;
         };
 
+        ~ISerialization() noexcept;
+
         void LoadGlobalConfig();
         bool SaveGlobalConfig();
 
-        size_t LoadActorProfiles(SKSESerializationInterface* intfc, std::stringstream& a_data);
+        // Parse* only read the json and may run off the main thread, group and
+        // node keys are checked against the live config by Filter* which has
+        // to be called under the driver lock
+        static void ParseGlobalConfig(const Json::Value& a_root, configGlobal_t& a_out);
+        static void FilterGlobalConfig(configGlobal_t& a_config);
+        static void CreateGlobalConfig(const configGlobal_t& a_in, Json::Value& a_out);
+
+        size_t LoadActorProfiles(SKSESerializationInterface* intfc, std::istream& a_data);
         size_t SerializeActorProfiles(std::stringstream& a_out);
 
-        size_t LoadGlobalProfile(SKSESerializationInterface* intfc, std::stringstream& a_data);
+        size_t LoadGlobalProfile(SKSESerializationInterface* intfc, std::istream& a_data);
         size_t SerializeGlobalProfile(std::stringstream& a_out);
 
         bool LoadDefaultProfile();
         bool SaveToDefaultGlobalProfile();
 
-        size_t LoadRaceProfiles(SKSESerializationInterface* intfc, std::stringstream& a_data);
+        size_t LoadRaceProfiles(SKSESerializationInterface* intfc, std::istream& a_data);
         size_t SerializeRaceProfiles(std::stringstream& a_out);
 
         void LoadCollisionGroups();
         bool SaveCollisionGroups();
 
+        static void ParseCollisionGroups(
+            const Json::Value& a_root,
+            collisionGroups_t& a_groups,
+            nodeCollisionGroupMap_t& a_nodeMap);
+        static void FilterCollisionGroups(nodeCollisionGroupMap_t& a_nodeMap);
+
         bool Import(SKSESerializationInterface* intfc, const fs::path& a_path, ImportFlags a_flags);
         bool Export(const fs::path& a_path);
 
         bool GetImportInfo(const fs::path& a_path, importInfo_t& a_out) const;
 
+        enum class AsyncOp : uint32_t
+        {
+            None = 0,
+            Import,
+            Export
+        };
+
+        enum class AsyncState : uint32_t
+        {
+            Idle = 0,
+            Running,
+            Finished,
+            Failed
+        };
+
+        struct asyncStatus_t
+        {
+            AsyncOp op;
+            AsyncState state;
+            size_t done;
+            size_t total;
+        };
+
+        // Import/export on a worker thread. Exports write a snapshot taken on
+        // the calling thread. a_onDone is queued once the job stops running and
+        // should call CompleteAsync from the thread that owns the config, which
+        // applies parsed import data unless CancelAsync was called meanwhile.
+        bool ImportAsync(const fs::path& a_path, ImportFlags a_flags, TaskDelegate* a_onDone);
+        bool ExportAsync(const fs::path& a_path, TaskDelegate* a_onDone);
+
+        [[nodiscard]] asyncStatus_t GetAsyncStatus() const;
+        bool CompleteAsync();
+
+        // pending import data gets dropped instead of applied
+        void CancelAsync();
+
+        // outcome of the last completed a_op, cleared once taken
+        [[nodiscard]] bool TakeAsyncResult(AsyncOp a_op, bool& a_result);
+
+#ifdef _CBP_ENABLE_DEBUG
+        struct benchEntry_t
+        {
+            std::string name;
+            size_t entries;
+            double time;
+            size_t bytes;
+            // working set at the end of the phase minus at its start,
+            // the phase's output is still alive when sampled
+            long long workingSetDelta;
+        };
+
+        struct benchResult_t
+        {
+            std::uint32_t actors;
+            std::uint32_t groups;
+            stl::vector<benchEntry_t> entries;
+        };
+
+        // Runs a_actors synthetic actors with a_groups physics and node
+        // entries each through every serialization path, then times armor
+        // override merges, and writes a CSV report. Live config is left
+        // alone, a_scratch holds the export and is removed afterwards. Call
+        // under the driver lock.
+        bool RunBenchmark(
+            std::uint32_t a_actors,
+            std::uint32_t a_groups,
+            const fs::path& a_scratch,
+            const fs::path& a_report,
+            benchResult_t& a_out);
+#endif
+
         SKMP_FORCEINLINE void MarkForSave(Group a_grp) {
             m_pendingSave[a_grp] = true;
         }
@@ -105,15 +165,65 @@ namespace CBP
         bool SavePending();
 
         size_t BinSerializeSave(boost::archive::binary_oarchive& a_out);
-        size_t BinSerializeLoad(SKSESerializationInterface* intfc, std::stringstream& a_in);
+        size_t BinSerializeLoad(SKSESerializationInterface* intfc, std::istream& a_in);
+
+        struct blockStats_t
+        {
+            size_t total;
+            size_t reused;
+            size_t raw;
+            size_t encoded;
+            size_t legacy;
+            size_t encodedSync;
+        };
+
+        // Holders are split into independently encoded blocks. A block whose
+        // serialized content hash matches the cached one is written without
+        // being encoded again. Loading primes the cache. Blocks are written
+        // in the flat schema (IConfigSchema), boost archive blocks from older
+        // saves still load and are converted on the next save.
+        //
+        // BlockSerializeBegin serializes every block into its own buffer on
+        // the calling thread, which is the snapshot, and hands the changed
+        // ones to the encode pool. BlockSerializeEnd encodes whatever the
+        // pool hasn't picked up yet itself, waits for the rest and commits
+        // the results to the cache. End must follow a successful Begin.
+        bool BlockSerializeBegin(Codec::Type a_codec, int a_level);
+        size_t BlockSerializeEnd();
+        bool BlockSerializeWrite(SKSESerializationInterface* intfc);
+        size_t BlockSerializeLoad(SKSESerializationInterface* intfc, Codec::Type a_codec, int a_level);
+
+        void ClearBlockCache();
 
         const auto& GetStats() {
             return m_stats;
         }
 
+        [[nodiscard]] SKMP_FORCEINLINE const auto& GetBlockStats() const {
+            return m_blockStats;
+        }
+
         FN_NAMEPROC("Serialization")
     private:
 
+        struct configHolders_t
+        {
+            configComponents_t globalPhysics;
+            configNodes_t globalNode;
+
+            actorConfigComponentsHolder_t actorPhysics;
+            actorConfigNodesHolder_t actorNode;
+
+            raceConfigComponentsHolder_t racePhysics;
+            raceConfigNodesHolder_t raceNode;
+        };
+
+        struct asyncProgress_t
+        {
+            std::atomic<size_t> done{ 0 };
+            std::atomic<size_t> total{ 0 };
+        };
+
         void ResolvePluginName(Game::FormID a_formid, Json::Value& a_out);
         bool ResolvePluginFormID(const Json::Value& a_root, Game::FormID a_in, Game::FormID& a_out);
         bool ResolvePluginHandle(const Json::Value& a_root, Game::ObjectHandle a_in, Game::ObjectHandle& a_out);
@@ -137,7 +247,94 @@ namespace CBP
         size_t BinSerializeActorPhysics(boost::archive::binary_iarchive& a_in, actorConfigComponentsHolder_t& a_out);
         size_t BinSerializeActorNode(boost::archive::binary_iarchive& a_in, actorConfigNodesHolder_t& a_out);
 
-        void ReadImportData(const fs::path& a_path, Json::Value& a_out) const;
+        enum class BlockSection : std::uint16_t
+        {
+            GlobalPhysics = 0,
+            GlobalNode,
+            ActorPhysics,
+            ActorNode,
+            RacePhysics,
+            RaceNode,
+            Max
+        };
+
+        static constexpr std::uint32_t NUM_BLOCK_BUCKETS = 32;
+
+        struct blockHeader_t
+        {
+            std::uint32_t id;
+            std::uint32_t count;
+            std::uint64_t hash;
+            std::uint32_t size;
+            std::uint32_t schema; // 0 = boost archive
+        };
+
+        static_assert(sizeof(blockHeader_t) == 24);
+
+        struct cachedBlock_t
+        {
+            std::uint64_t hash{ 0 };
+            std::uint32_t count{ 0 };
+            std::uint32_t schema{ 0 };
+            Codec::Type codec{ Codec::Type::Gzip };
+            int level{ -1 };
+            stl::vector<char> data;
+        };
+
+        SKMP_FORCEINLINE static constexpr std::uint32_t MakeBlockId(BlockSection a_section, std::uint32_t a_bucket) {
+            return (static_cast<std::uint32_t>(a_section) << 16) | a_bucket;
+        }
+
+        struct encodeJob_t
+        {
+            std::uint32_t id;
+            std::uint32_t count;
+            std::uint64_t hash;
+            stl::vector<char> raw;
+            stl::vector<char> encoded;
+            bool failed;
+        };
+
+        template <class Tf>
+        void PrepareBlock(std::uint32_t a_id, std::uint32_t a_count, Tf a_func);
+
+        template <class T>
+        void PrepareHolderBlocks(BlockSection a_section, const T& a_data);
+
+        // claims and encodes jobs until none are left, returns the number done
+        size_t RunEncodeJobs();
+
+        statsEntry_t& GetSectionStats(BlockSection a_section);
+
+        template <class Ta>
+        bool ReadBlock(Ta& a_in, BlockSection a_section, std::uint32_t a_count, configHolders_t& a_out);
+
+        void ReadImport(
+            SKSESerializationInterface* intfc,
+            const fs::path& a_path,
+            ImportFlags a_flags,
+            configHolders_t& a_out,
+            asyncProgress_t* a_progress);
+
+        void ApplyImport(configHolders_t& a_data, ImportFlags a_flags);
+
+        void TakeSnapshot(configHolders_t& a_out) const;
+        void WriteExport(const fs::path& a_path, const configHolders_t& a_data, asyncProgress_t* a_progress);
+
+        bool _LoadActorEntry(
+            SKSESerializationInterface* intfc,
+            const std::string& a_key,
+            const Json::Value& a_entry,
+            actorConfigComponentsHolder_t& a_actorConfigComponents,
+            actorConfigNodesHolder_t& a_nodeData,
+            bool a_updateMaps);
+
+        bool _LoadRaceEntry(
+            SKSESerializationInterface* intfc,
+            const std::string& a_key,
+            const Json::Value& a_entry,
+            raceConfigComponentsHolder_t& a_raceConfigComponents,
+            raceConfigNodesHolder_t& a_nodeData);
 
         size_t _LoadActorProfiles(
             SKSESerializationInterface* intfc,
@@ -169,6 +366,35 @@ namespace CBP
 
         stats_t m_stats;
 
+        stl::unordered_map<std::uint32_t, cachedBlock_t> m_blockCache;
+        stl::vector<std::uint32_t> m_blockOrder;
+        stl::vector<char> m_blockScratch;
+        blockStats_t m_blockStats;
+
+        struct
+        {
+            stl::vector<encodeJob_t> jobs;
+            std::atomic<size_t> next{ 0 };
+            Codec::Type codec{ Codec::Type::Gzip };
+            int level{ -1 };
+        } m_encode;
+
+        ThreadPool m_encodePool;
+
+        struct
+        {
+            std::thread thread;
+            std::atomic<AsyncOp> op{ AsyncOp::None };
+            std::atomic<AsyncState> state{ AsyncState::Idle };
+            std::atomic<bool> cancelled{ false };
+            asyncProgress_t progress;
+            ImportFlags flags{ ImportFlags::None };
+            configHolders_t data;
+            except::descriptor except;
+            AsyncOp resultOp{ AsyncOp::None };
+            bool result{ false };
+        } m_async;
+
         bool m_pendingSave[Group::kNumGroups];
 
         Serialization::Parser<configComponents_t> m_componentParser;
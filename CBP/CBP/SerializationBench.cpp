@@ -0,0 +1,415 @@
+#include "pch.h"
+
+#ifdef _CBP_ENABLE_DEBUG
+
+#include <Psapi.h>
+
+namespace CBP
+{
+    // synthetic handles, keeps clear of real load order indices
+    static constexpr std::uint64_t BENCH_HANDLE_BASE = 0x0000FFFF00000000ULL;
+
+    // actors wearing overridden armor in the merge phases
+    static constexpr std::uint32_t BENCH_AO_ACTORS = 300;
+
+    static long long GetWorkingSet()
+    {
+        PROCESS_MEMORY_COUNTERS pmc;
+
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), std::addressof(pmc), sizeof(pmc)))
+            return 0;
+
+        return static_cast<long long>(pmc.WorkingSetSize);
+    }
+
+    static void SynthesizeHolders(
+        std::uint32_t a_actors,
+        std::uint32_t a_groups,
+        actorConfigComponentsHolder_t& a_physics,
+        actorConfigNodesHolder_t& a_nodes)
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        char buf[32];
+
+        for (std::uint32_t i = 0; i < a_actors; i++)
+        {
+            Game::ObjectHandle handle(BENCH_HANDLE_BASE + i);
+
+            auto& physics = a_physics[handle];
+            auto& nodes = a_nodes[handle];
+
+            for (std::uint32_t j = 0; j < a_groups; j++)
+            {
+                _snprintf_s(buf, _TRUNCATE, "group%u", j);
+                auto& c = physics[buf];
+
+                // vary the values so the codecs don't see a single repeating record
+                auto base = reinterpret_cast<char*>(std::addressof(c));
+                for (std::size_t k = 0; k < vec.size(); k++)
+                    *reinterpret_cast<float*>(base + vec[k].second.offset) +=
+                        static_cast<float>((i + j * 7 + k * 13) % 97) * 0.01f;
+
+                _snprintf_s(buf, _TRUNCATE, "node%u", j);
+                auto& n = nodes[buf];
+
+                n.bl.b.motion.female = ((i + j) & 1) == 0;
+                n.bl.b.collisions.male = ((i + j) & 2) == 0;
+                n.fp.f32.nodeScale = 1.0f + static_cast<float>((i + j) % 10) * 0.05f;
+            }
+        }
+    }
+
+    // Every loaded config group gets a few Set/Mul ops, roughly what a
+    // compiled override file produces
+    static void SynthesizeArmorOverride(armorOverrideDescriptor_t& a_out)
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        std::uint32_t k(0);
+
+        for (const auto& e : IConfig::GetConfigGroups())
+        {
+            auto group = IConfig::GetConfigGroupId(e);
+            if (group == INVALID_CONFIG_GROUP_ID)
+                continue;
+
+            for (std::uint32_t i = 0; i < 4; i++, k++)
+            {
+                a_out.ops.emplace_back(armorOverrideOp_t{
+                    group,
+                    static_cast<std::uint32_t>(vec[k % vec.size()].second.offset),
+                    (k & 1) ? ArmorOverrideOp::Mul : ArmorOverrideOp::Set,
+                    (k & 1) ? 1.1f : 0.5f });
+            }
+        }
+    }
+
+    // GetActorPhysicsAO over BENCH_AO_ACTORS synthetic actors with armor
+    // overrides, first with nothing cached then again with every merge
+    // cached. The overrides and cache entries are removed afterwards, the
+    // handles' version stamps stay behind.
+    template <class Tb, class Tr>
+    static void BenchArmorOverrides(Tb& a_begin, Tr& a_record)
+    {
+        armorOverrideDescriptor_t desc;
+        SynthesizeArmorOverride(desc);
+
+        auto cleanup = [&]
+        {
+            for (std::uint32_t i = 0; i < BENCH_AO_ACTORS; i++)
+            {
+                Game::ObjectHandle handle(BENCH_HANDLE_BASE + i);
+
+                IConfig::RemoveArmorOverride(handle);
+                IConfig::RemoveMergedCacheEntry(handle);
+            }
+        };
+
+        for (std::uint32_t i = 0; i < BENCH_AO_ACTORS; i++)
+        {
+            Game::ObjectHandle handle(BENCH_HANDLE_BASE + i);
+
+            IConfig::SetArmorOverride(handle, desc);
+            IConfig::RemoveMergedCacheEntry(handle);
+        }
+
+        try
+        {
+            for (int pass = 0; pass < 2; pass++)
+            {
+                a_begin();
+
+                for (std::uint32_t i = 0; i < BENCH_AO_ACTORS; i++)
+                    static_cast<void>(IConfig::GetActorPhysicsAO(Game::ObjectHandle(BENCH_HANDLE_BASE + i)));
+
+                a_record(pass == 0 ? "ao_merge_cold" : "ao_merge_warm", BENCH_AO_ACTORS, 0);
+            }
+        }
+        catch (...)
+        {
+            cleanup();
+            throw;
+        }
+
+        cleanup();
+    }
+
+    bool ISerialization::RunBenchmark(
+        std::uint32_t a_actors,
+        std::uint32_t a_groups,
+        const fs::path& a_scratch,
+        const fs::path& a_report,
+        benchResult_t& a_out)
+    {
+        a_out.actors = a_actors;
+        a_out.groups = a_groups;
+        a_out.entries.clear();
+
+        try
+        {
+            if (a_actors == 0 || a_groups == 0)
+                throw std::exception("Nothing to do");
+
+            PerfTimer pt;
+            long long ws(0);
+
+            auto begin = [&]
+            {
+                ws = GetWorkingSet();
+                pt.Start();
+            };
+
+            auto record = [&](std::string a_name, size_t a_entries, size_t a_bytes)
+            {
+                auto time = pt.Stop();
+                a_out.entries.push_back({ std::move(a_name), a_entries, time, a_bytes, GetWorkingSet() - ws });
+            };
+
+            auto check = [&](const char* a_name, size_t a_physics, size_t a_nodes)
+            {
+                if (a_physics != a_actors || a_nodes != a_actors)
+                {
+                    Error("%s: round trip mismatch (%zu/%zu, expected %u)",
+                        a_name, a_physics, a_nodes, a_actors);
+
+                    throw std::exception("Round trip mismatch");
+                }
+            };
+
+            configHolders_t data;
+
+            begin();
+            SynthesizeHolders(a_actors, a_groups, data.actorPhysics, data.actorNode);
+            record("synthesize", a_actors, 0);
+
+            // JSON: per-entry values as written by export and the profile store
+
+            stl::vector<Json::Value> values;
+            values.reserve(a_actors);
+
+            begin();
+            for (const auto& e : data.actorPhysics)
+            {
+                auto& v = values.emplace_back();
+                m_componentParser.Create(e.second, v);
+                m_nodeParser.Create(data.actorNode[e.first], v);
+            }
+            record("json_create", a_actors, 0);
+
+            stl::vector<std::string> texts;
+            texts.reserve(a_actors);
+
+            {
+                Json::StreamWriterBuilder builder;
+                builder["indentation"] = "";
+
+                std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+                size_t bytes(0);
+
+                begin();
+                for (const auto& e : values)
+                {
+                    std::ostringstream ss;
+                    writer->write(e, std::addressof(ss));
+
+                    auto& s = texts.emplace_back(ss.str());
+                    bytes += s.size();
+                }
+                record("json_write", a_actors, bytes);
+            }
+
+            values.swap(decltype(values)());
+
+            {
+                actorConfigComponentsHolder_t physics;
+                actorConfigNodesHolder_t nodes;
+
+                size_t bytes(0);
+                std::uint64_t i(0);
+
+                begin();
+                for (const auto& e : texts)
+                {
+                    Json::Value v;
+                    Serialization::ParseRange(e.data(), e.data() + e.size(), v);
+
+                    Game::ObjectHandle handle(BENCH_HANDLE_BASE + i++);
+
+                    if (!m_componentParser.Parse(v, physics[handle]) ||
+                        !m_nodeParser.Parse(v, nodes[handle]))
+                    {
+                        throw std::exception("JSON parse failed");
+                    }
+
+                    bytes += e.size();
+                }
+                record("json_parse", a_actors, bytes);
+
+                check("json_parse", physics.size(), nodes.size());
+            }
+
+            texts.swap(decltype(texts)());
+
+            // boost archive, the co-save format prior to the block schema
+
+            {
+                std::stringstream ss;
+
+                begin();
+                {
+                    boost::archive::binary_oarchive ar(ss);
+                    ar << data.actorPhysics;
+                    ar << data.actorNode;
+                }
+                auto bytes = static_cast<size_t>(ss.tellp());
+                record("archive_save", a_actors, bytes);
+
+                actorConfigComponentsHolder_t physics;
+                actorConfigNodesHolder_t nodes;
+
+                begin();
+                {
+                    boost::archive::binary_iarchive ar(ss);
+                    ar >> physics;
+                    ar >> nodes;
+                }
+                record("archive_load", a_actors, bytes);
+
+                check("archive_load", physics.size(), nodes.size());
+            }
+
+            // flat block schema as written by BlockSerializeBegin, unbucketed
+
+            stl::vector<char> block;
+
+            {
+                IConfigSchema::Writer out(block);
+
+                begin();
+                {
+                    IConfigSchema::BlockWriter ar(out);
+                    for (const auto& e : data.actorPhysics)
+                    {
+                        ar << e.first;
+                        ar << e.second;
+                    }
+                }
+
+                auto split = block.size();
+
+                {
+                    IConfigSchema::BlockWriter ar(out);
+                    for (const auto& e : data.actorNode)
+                    {
+                        ar << e.first;
+                        ar << e.second;
+                    }
+                }
+                record("schema_write", a_actors, block.size());
+
+                configHolders_t tmp;
+
+                begin();
+                {
+                    IConfigSchema::Reader in(block.data(), split);
+                    IConfigSchema::BlockReader ar(in);
+
+                    for (std::uint32_t i = 0; i < a_actors; i++)
+                    {
+                        Game::ObjectHandle handle;
+                        ar >> handle;
+                        ar >> tmp.actorPhysics[handle];
+                    }
+                }
+                {
+                    IConfigSchema::Reader in(block.data() + split, block.size() - split);
+                    IConfigSchema::BlockReader ar(in);
+
+                    for (std::uint32_t i = 0; i < a_actors; i++)
+                    {
+                        Game::ObjectHandle handle;
+                        ar >> handle;
+                        ar >> tmp.actorNode[handle];
+                    }
+                }
+                record("schema_read", a_actors, block.size());
+
+                check("schema_read", tmp.actorPhysics.size(), tmp.actorNode.size());
+            }
+
+            for (auto type : { Codec::Type::Gzip, Codec::Type::Zstd, Codec::Type::LZ4 })
+            {
+                std::string name(Codec::GetName(type));
+
+                stl::vector<char> encoded, decoded;
+
+                begin();
+                Codec::Encode(type, -1, block.data(), block.size(), encoded);
+                record("encode_" + name, a_actors, encoded.size());
+
+                begin();
+                Codec::Decode(encoded.data(), encoded.size(), decoded);
+                record("decode_" + name, a_actors, decoded.size());
+
+                if (decoded != block)
+                    throw std::exception("Codec round trip mismatch");
+            }
+
+            block.swap(decltype(block)());
+
+            // export/import through the same code the UI uses
+
+            begin();
+            WriteExport(a_scratch, data, nullptr);
+            auto exportSize = static_cast<size_t>(fs::file_size(a_scratch));
+            record("export", a_actors, exportSize);
+
+            {
+                configHolders_t tmp;
+
+                begin();
+                ReadImport(nullptr, a_scratch, ImportFlags::Actors, tmp, nullptr);
+                record("import", a_actors, exportSize);
+
+                check("import", tmp.actorPhysics.size(), tmp.actorNode.size());
+            }
+
+            std::error_code ec;
+            fs::remove(a_scratch, ec);
+
+            BenchArmorOverrides(begin, record);
+
+            Serialization::WriteStream(a_report, [&](std::ofstream& a_stream)
+                {
+                    a_stream << "phase,actors,groups,seconds,entries_per_s,bytes,mb_per_s,working_set_delta_kb\n";
+
+                    for (const auto& e : a_out.entries)
+                    {
+                        a_stream << e.name << ',' << a_actors << ',' << a_groups << ',' << e.time << ','
+                            << (e.time > 0.0 ? static_cast<double>(e.entries) / e.time : 0.0) << ','
+                            << e.bytes << ','
+                            << (e.time > 0.0 ? static_cast<double>(e.bytes) / e.time / (1024.0 * 1024.0) : 0.0) << ','
+                            << e.workingSetDelta / 1024 << '\n';
+                    }
+                });
+
+            for (const auto& e : a_out.entries)
+                Debug("%s: %s: %u x %u: %fs, %zu bytes", __FUNCTION__, e.name.c_str(), a_actors, a_groups, e.time, e.bytes);
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            std::error_code ec;
+            fs::remove(a_scratch, ec);
+
+            m_lastException = e;
+            Error("%s: %s", __FUNCTION__, e.what());
+            return false;
+        }
+    }
+}
+
+#endif
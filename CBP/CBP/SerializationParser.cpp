@@ -0,0 +1,415 @@
+#include "pch.h"
+
+namespace Serialization
+{
+
+    static const std::string s_keyMaxOffset("maxoffset");
+
+    template<>
+    bool Parser<CBP::configComponents_t>::Parse(const Json::Value& a_in, CBP::configComponents_t& a_outData) const
+    {
+        uint32_t version;
+        if (!ParseVersion(a_in, "data_version", version)) {
+            Error("Bad version data");
+            return false;
+        }
+
+        if (!a_in.isMember("data"))
+            return false;
+
+        auto& data = a_in["data"];
+
+        if (data.empty())
+            return true;
+
+        if (!data.isObject()) {
+            Error("Expected an object");
+            return false;
+        }
+
+        for (auto it1 = data.begin(); it1 != data.end(); ++it1)
+        {
+            std::string configGroup(it1.key().asString());
+
+            if (configGroup.empty()) {
+                Error("Empty config group name");
+                return false;
+            }
+
+            auto& e = a_outData.try_emplace(configGroup).first->second;
+
+            if (!it1->isNull())
+            {
+                if (!it1->isObject()) {
+                    Error("Bad sim component data, expected object");
+                    return false;
+                }
+
+                const Json::Value* physData;
+                if (version == 0) {
+                    physData = std::addressof(*it1);
+                }
+                else
+                {
+                    auto& v = (*it1)["phys"];
+
+                    if (v.empty()) {
+                        Error("%s: Missing physics data", configGroup.c_str());
+                        return false;
+                    }
+
+                    if (!v.isObject()) {
+                        Error("%s: Invalid physics data", configGroup.c_str());
+                        return false;
+                    }
+
+                    physData = std::addressof(v);
+                }
+
+                if (version < 3)
+                {
+                    for (auto it2 = physData->begin(); it2 != physData->end(); ++it2)
+                    {
+                        if (!it2->isNumeric()) {
+                            Error("(%s) Bad value type, expected number: %d", configGroup.c_str(), Enum::Underlying(it2->type()));
+                            return false;
+                        }
+
+                        std::string valName(it2.key().asString());
+
+                        if (version < 2 && StrHelpers::icompare(valName, s_keyMaxOffset) == 0)
+                        {
+                            float v = it2->asFloat();
+                            float tv[3]{ v, v, v };
+                            e.Set("mox", tv, 3);
+                        }
+                        else
+                        {
+                            auto ik = CBP::configComponent32_t::oldKeyMap.find(valName);
+                            if (ik == CBP::configComponent32_t::oldKeyMap.end()) {
+                                //Warning("(%s) Unknown value: %s", configGroup.c_str(), valName.c_str());
+                                continue;
+                            }
+
+                            ASSERT(e.Set(ik->second, it2->asFloat()));
+                        }
+                    }
+                }
+                else
+                {
+                    for (auto& desc : CBP::configComponent32_t::descMap)
+                    {
+                        auto& v = (*physData)[desc.first];
+
+                        if (!v.isNumeric()) {
+                            if (!v.isNull()) {
+                                Warning("(%s) (%s) Bad value type, expected number: %d",
+                                    configGroup.c_str(), desc.first.c_str(), Enum::Underlying(v.type()));
+                            }
+                            continue;
+                        }
+
+                        e.Set(desc.second, v.asFloat());
+                    }
+                }
+
+                auto& ex = (*it1)["ex"];
+
+                if (!ex.empty())
+                {
+                    auto s = static_cast<uint32_t>(ex.get("cs", 0).asUInt());
+
+                    switch (s)
+                    {
+                    case Enum::Underlying(CBP::ColliderShapeType::Sphere):
+                    case Enum::Underlying(CBP::ColliderShapeType::Capsule):
+                    case Enum::Underlying(CBP::ColliderShapeType::Box):
+                    case Enum::Underlying(CBP::ColliderShapeType::Cone):
+                    case Enum::Underlying(CBP::ColliderShapeType::Tetrahedron):
+                    case Enum::Underlying(CBP::ColliderShapeType::Cylinder):
+                    case Enum::Underlying(CBP::ColliderShapeType::Mesh):
+                    case Enum::Underlying(CBP::ColliderShapeType::ConvexHull):
+                        e.SetColShape(static_cast<CBP::ColliderShapeType>(s));
+                        break;
+                    default:
+                        Warning("(%s) Unknown collision shape specifier: %u", configGroup.c_str(), s);
+                    }
+
+                    e.ex.colMesh = ex.get("cm", "").asString();
+                }
+            }
+        }
+
+        return true;
+    }
+
+    template<>
+    void Parser<CBP::configComponents_t>::Create(const CBP::configComponents_t& a_data, Json::Value& a_out) const
+    {
+        auto& data = a_out["data"];
+
+        for (const auto& v : a_data) {
+            auto& simComponent = data[v.first];
+
+            auto& phys = simComponent["phys"];
+
+            auto baseaddr = reinterpret_cast<uintptr_t>(std::addressof(v.second));
+
+            for (const auto& e : v.second.descMap)
+                phys[e.first] = *reinterpret_cast<float*>(baseaddr + e.second.offset);
+
+            auto& ex = simComponent["ex"];
+
+            ex["cs"] = Enum::Underlying(v.second.ex.colShape);
+            ex["cm"] = v.second.ex.colMesh;
+        }
+
+        a_out["data_version"] = Json::Value::UInt(3);
+    }
+
+    template<>
+    bool Parser<CBP::configNodes_t>::Parse(const Json::Value& a_in, CBP::configNodes_t& a_out) const
+    {
+        uint32_t version;
+
+        if (!ParseVersion(a_in, "nodes_version", version)) {
+            Error("Bad version data");
+            return false;
+        }
+
+        if (!a_in.isMember("nodes"))
+            return false;
+
+        auto& data = a_in["nodes"];
+
+        if (data.empty())
+            return true;
+
+        if (!data.isObject()) {
+            Error("root: expected an object");
+            return false;
+        }
+
+        for (auto it = data.begin(); it != data.end(); ++it)
+        {
+            if (it->empty())
+                continue;
+
+            if (!it->isObject())
+            {
+                Error("Node entry not an object");
+                continue;
+            }
+
+            std::string k(it.key().asString());
+
+            if (k.empty())
+            {
+                Error("Zero length node name");
+                return false;
+            }
+
+            auto& nc = a_out.try_emplace(k).first->second;
+
+            if (version < 1)
+            {
+                nc.bl.b.motion.female = it->get("femaleMovement", false).asBool();
+                nc.bl.b.collisions.female = it->get("femaleCollisions", false).asBool();
+                nc.bl.b.motion.male = it->get("maleMovement", false).asBool();
+                nc.bl.b.collisions.male = it->get("maleCollisions", false).asBool();
+
+                auto& offsetMin = (*it)["offsetMin"];
+
+                if (!offsetMin.empty()) {
+                    if (!ParseFloatArray(offsetMin, nc.fp.f32.colOffsetMin, ARRAYSIZE(nc.fp.f32.colOffsetMin))) {
+                        Error("Couldn't parse offsetMin");
+                        return false;
+                    }
+                }
+
+                auto& offsetMax = (*it)["offsetMax"];
+
+                if (!offsetMax.empty()) {
+                    if (!ParseFloatArray(offsetMax, nc.fp.f32.colOffsetMax, ARRAYSIZE(nc.fp.f32.colOffsetMax))) {
+                        Error("Couldn't parse offsetMax");
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                nc.bl.b.motion.female = it->get("fm", false).asBool();
+                nc.bl.b.collisions.female = it->get("fc", false).asBool();
+                nc.bl.b.motion.male = it->get("mm", false).asBool();
+                nc.bl.b.collisions.male = it->get("mc", false).asBool();
+
+                auto& offsetMin = (*it)["o-"];
+
+                if (!offsetMin.empty()) {
+                    if (!ParseFloatArray(offsetMin, nc.fp.f32.colOffsetMin, ARRAYSIZE(nc.fp.f32.colOffsetMin))) {
+                        Error("Couldn't parse offsetMin");
+                        return false;
+                    }
+                }
+
+                auto& offsetMax = (*it)["o+"];
+
+                if (!offsetMax.empty()) {
+                    if (!ParseFloatArray(offsetMax, nc.fp.f32.colOffsetMax, ARRAYSIZE(nc.fp.f32.colOffsetMax))) {
+                        Error("Couldn't parse offsetMax");
+                        return false;
+                    }
+                }
+
+                if (version >= 2) {
+                    auto& rot = (*it)["r"];
+
+                    if (!rot.empty()) {
+                        if (!ParseFloatArray(rot, nc.fp.f32.colRot, ARRAYSIZE(nc.fp.f32.colRot))) {
+                            Error("Couldn't parse colRot");
+                            return false;
+                        }
+                    }
+
+                    if (version >= 3)
+                    {
+                        nc.bl.b.boneCast = it->get("b", false).asBool();
+                        nc.fp.f32.bcSimplifyTarget = it->get("bt", 1.0f).asFloat();
+                        nc.fp.f32.bcSimplifyTargetError = it->get("be", 0.02f).asFloat();
+                        nc.fp.f32.bcWeightThreshold = it->get("bw", 0.0f).asFloat();
+                        nc.ex.bcShape = it->get("bs", "").asString();
+                    }
+                }
+
+                nc.fp.f32.nodeScale = std::clamp(it->get("s", 1.0f).asFloat(), 0.0f, 20.0f);
+                nc.bl.b.overrideScale = it->get("o", false).asBool();
+            }
+        }
+
+        return true;
+    }
+
+    template<>
+    void Parser<CBP::configNodes_t>::Create(const CBP::configNodes_t& a_data, Json::Value& a_out) const
+    {
+        auto& data = a_out["nodes"];
+
+        for (const auto& e : a_data)
+        {
+            auto& n = data[e.first];
+
+            n["fm"] = e.second.bl.b.motion.female;
+            n["fc"] = e.second.bl.b.collisions.female;
+            n["mm"] = e.second.bl.b.motion.male;
+            n["mc"] = e.second.bl.b.collisions.male;
+
+            auto& offmin = n["o-"];
+
+            offmin[0] = e.second.fp.f32.colOffsetMin[0];
+            offmin[1] = e.second.fp.f32.colOffsetMin[1];
+            offmin[2] = e.second.fp.f32.colOffsetMin[2];
+
+            auto& offmax = n["o+"];
+
+            offmax[0] = e.second.fp.f32.colOffsetMax[0];
+            offmax[1] = e.second.fp.f32.colOffsetMax[1];
+            offmax[2] = e.second.fp.f32.colOffsetMax[2];
+
+            auto& rot = n["r"];
+
+            rot[0] = e.second.fp.f32.colRot[0];
+            rot[1] = e.second.fp.f32.colRot[1];
+            rot[2] = e.second.fp.f32.colRot[2];
+
+            n["s"] = e.second.fp.f32.nodeScale;
+            n["o"] = e.second.bl.b.overrideScale;
+
+            n["b"] = e.second.bl.b.boneCast;
+            n["bt"] = e.second.fp.f32.bcSimplifyTarget;
+            n["be"] = e.second.fp.f32.bcSimplifyTargetError;
+            n["bw"] = e.second.fp.f32.bcWeightThreshold;
+            n["bs"] = e.second.ex.bcShape;
+        }
+
+        a_out["nodes_version"] = Json::Value::UInt(3);
+    }
+
+
+    template<>
+    bool Parser<CBP::nodeMap_t>::Parse(const Json::Value& a_in, CBP::nodeMap_t& a_out) const
+    {
+        if (a_in.empty())
+        {
+            Error("Empty node map");
+            return false;
+        }
+
+        if (!a_in.isObject())
+        {
+            Error("Unexpected data");
+            return false;
+        }
+
+        for (auto it = a_in.begin(); it != a_in.end(); ++it)
+        {
+            if (!it->isArray())
+            {
+                Error("Expected array");
+                return false;
+            }
+
+            std::string configGroup(it.key().asString());
+            if (configGroup.empty())
+            {
+                Error("Zero length config group string");
+                return false;
+            }
+
+            for (auto& v : *it)
+            {
+                if (!v.isString())
+                {
+                    Error("Expected string");
+                    return false;
+                }
+
+                std::string k(v.asString());
+                if (k.empty())
+                {
+                    Error("Zero length node name string");
+                    return false;
+                }
+
+                a_out.insert_or_assign(k, configGroup);
+            }
+        }
+
+        return true;
+    }
+
+    template<>
+    void Parser<CBP::configGroupMap_t>::Create(const CBP::configGroupMap_t& a_data, Json::Value& a_out) const
+    {
+        for (const auto& e : a_data)
+        {
+            auto& l = a_out[e.first];
+
+            for (const auto& f : e.second)
+            {
+                l.append(f);
+            }
+        }
+    }
+
+    template<>
+    void Parser<CBP::configComponents_t>::GetDefault(CBP::configComponents_t& a_out) const
+    {
+        a_out = CBP::configComponents_t();
+    }
+
+    template<>
+    void Parser<CBP::configNodes_t>::GetDefault(CBP::configNodes_t& a_out) const
+    {
+        a_out = CBP::configNodes_t();
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace Serialization
+{
+    template<>
+    bool Parser<CBP::configComponents_t>::Parse(const Json::Value& a_in, CBP::configComponents_t& a_outData) const;
+    template<>
+    void Parser<CBP::configComponents_t>::Create(const CBP::configComponents_t& a_data, Json::Value& a_out) const;
+
+    template<>
+    bool Parser<CBP::configNodes_t>::Parse(const Json::Value& a_in, CBP::configNodes_t& a_out) const;
+    template<>
+    void Parser<CBP::configNodes_t>::Create(const CBP::configNodes_t& a_data, Json::Value& a_out) const;
+
+
+    template<>
+    bool Parser<CBP::nodeMap_t>::Parse(const Json::Value& a_in, CBP::nodeMap_t& a_out) const;
+    template<>
+    void Parser<CBP::configGroupMap_t>::Create(const CBP::configGroupMap_t& a_data, Json::Value& a_out) const;
+
+    template<>
+    void Parser<CBP::configComponents_t>::GetDefault(CBP::configComponents_t& a_out) const;
+    template<>
+    void Parser<CBP::configNodes_t>::GetDefault(CBP::configNodes_t& a_out) const;
+    template<>
+    void Parser<CBP::nodeMap_t>::GetDefault(CBP::nodeMap_t& a_out) const;
+}
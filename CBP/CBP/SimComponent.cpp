@@ -337,7 +337,8 @@ namespace CBP
         m_doPositionScaling(false),
         m_doRotationScaling(false),
         m_offsetParent(false),
-        m_bonecast(false)
+        m_bonecast(false),
+        m_meshUpdateID(0)
     {
     }
 
@@ -346,6 +347,29 @@ namespace CBP
         Destroy();
     }
 
+    // Also true when creation failed on a mesh that has since been added
+    // or reloaded, failures are only retried once the file changes
+    bool Collider::HasStaleMesh() const
+    {
+        if (m_bonecast || m_meshShape.empty())
+            return false;
+
+        if (m_created &&
+            m_shape != ColliderShapeType::Mesh &&
+            m_shape != ColliderShapeType::ConvexHull)
+        {
+            return false;
+        }
+
+        auto& pm = ProfileManagerCollider::GetSingleton();
+
+        auto it = pm.Find(m_meshShape);
+        if (it == pm.End())
+            return m_meshUpdateID != 0;
+
+        return it->second.GetUpdateID() != m_meshUpdateID;
+    }
+
     bool Collider::Create(const configNode_t& a_nodeConf, ColliderShapeType a_shape)
     {
         if (m_created)
@@ -371,8 +395,11 @@ namespace CBP
                                 return true;
                         }
                         else {
-                            if (StrHelpers::icompare(m_parent.m_conf.ex.colMesh, m_meshShape) == 0)
+                            if (StrHelpers::icompare(m_parent.m_conf.ex.colMesh, m_meshShape) == 0 &&
+                                !HasStaleMesh())
+                            {
                                 return true;
+                            }
                         }
                     }
                 }
@@ -441,27 +468,38 @@ namespace CBP
             }
             else 
             {
-                if (m_parent.m_conf.ex.colMesh.empty())
+                // kept on failure as well, see HasStaleMesh
+                m_meshShape = m_parent.m_conf.ex.colMesh;
+                m_meshUpdateID = 0;
+
+                if (m_meshShape.empty())
                 {
                     delete collider;
                     return false;
                 }
 
-                const auto& pm = ProfileManagerCollider::GetSingleton();
+                auto& pm = ProfileManagerCollider::GetSingleton();
 
-                auto it = pm.Find(m_parent.m_conf.ex.colMesh);
+                auto it = pm.Find(m_meshShape);
                 if (it == pm.End())
                 {
                     Warning("%s: couldn't find mesh",
-                        m_parent.m_conf.ex.colMesh.c_str());
+                        m_meshShape.c_str());
 
                     delete collider;
                     return false;
                 }
 
-                m_meshShape = m_parent.m_conf.ex.colMesh;
+                m_meshUpdateID = it->second.GetUpdateID();
 
-                m_colliderData = std::make_unique<ColliderData>(it->second.Data());
+                auto data = it->second.GetColliderData();
+                if (!data)
+                {
+                    delete collider;
+                    return false;
+                }
+
+                m_colliderData = std::make_unique<ColliderData>(*data);
             }
 
             if (a_shape == ColliderShapeType::Mesh)
@@ -472,7 +510,7 @@ namespace CBP
             else
             {
                 m_colshape = new CollisionShapeConvexHull(
-                    collider, m_colliderData->m_hullPoints, m_colliderData->m_numIndices, m_parent.m_colExtent);
+                    collider, m_colliderData->m_hullPoints, m_colliderData->m_numHullPoints, m_parent.m_colExtent);
 
             }
         }
@@ -672,6 +710,7 @@ namespace CBP
         m_parent(a_parent),
         m_nodeName(a_nodeName),
         m_configGroupName(a_configGroupName),
+        m_configGroupId(IConfig::GetConfigGroupId(a_configGroupName)),
         m_oldWorldPos(
             a_obj->m_worldTransform.pos.x,
             a_obj->m_worldTransform.pos.y,
@@ -689,6 +728,8 @@ namespace CBP
         m_motion(a_movement),
         m_velocity(0.0f, 0.0f, 0.0f),
         m_virtld(0.0f, 0.0f, 0.0f),
+        m_colWeight(0.0f),
+        m_configured(false),
         m_colRad(1.0f),
         m_colHeight(0.001f),
         m_nodeScale(1.0f),
@@ -722,38 +763,149 @@ namespace CBP
     }
 
     void SimComponent::ColUpdateWeightData(
-        Actor* a_actor,
+        float a_weight,
         const configComponent16_t& a_config,
         const configNode_t& a_nodeConf)
     {
-        float weight = std::clamp(Game::GetActorWeight(a_actor), 0.0f, 100.0f);
-
-        m_colRad = std::clamp(mmw(weight, a_config.fp.f32.colSphereRadMin, a_config.fp.f32.colSphereRadMax), 0.001f, 1000.0f);
-        m_colHeight = std::clamp(mmw(weight, a_config.fp.f32.colHeightMin, a_config.fp.f32.colHeightMax), 0.001f, 1000.0f);
+        m_colRad = std::clamp(mmw(a_weight, a_config.fp.f32.colSphereRadMin, a_config.fp.f32.colSphereRadMax), 0.001f, 1000.0f);
+        m_colHeight = std::clamp(mmw(a_weight, a_config.fp.f32.colHeightMin, a_config.fp.f32.colHeightMax), 0.001f, 1000.0f);
         m_colOffset.setValue(
-            mmw(weight, a_config.fp.f32.colOffsetMin[0] + a_nodeConf.fp.f32.colOffsetMin[0], a_config.fp.f32.colOffsetMax[0] + a_nodeConf.fp.f32.colOffsetMax[0]),
-            mmw(weight, a_config.fp.f32.colOffsetMin[1] + a_nodeConf.fp.f32.colOffsetMin[1], a_config.fp.f32.colOffsetMax[1] + a_nodeConf.fp.f32.colOffsetMax[1]),
-            mmw(weight, a_config.fp.f32.colOffsetMin[2] + a_nodeConf.fp.f32.colOffsetMin[2], a_config.fp.f32.colOffsetMax[2] + a_nodeConf.fp.f32.colOffsetMax[2])
+            mmw(a_weight, a_config.fp.f32.colOffsetMin[0] + a_nodeConf.fp.f32.colOffsetMin[0], a_config.fp.f32.colOffsetMax[0] + a_nodeConf.fp.f32.colOffsetMax[0]),
+            mmw(a_weight, a_config.fp.f32.colOffsetMin[1] + a_nodeConf.fp.f32.colOffsetMin[1], a_config.fp.f32.colOffsetMax[1] + a_nodeConf.fp.f32.colOffsetMax[1]),
+            mmw(a_weight, a_config.fp.f32.colOffsetMin[2] + a_nodeConf.fp.f32.colOffsetMin[2], a_config.fp.f32.colOffsetMax[2] + a_nodeConf.fp.f32.colOffsetMax[2])
         );
 
         m_colExtent.setValue(
-            std::clamp(mmw(weight, a_config.fp.f32.colExtentMin[0], a_config.fp.f32.colExtentMax[0]), 0.0f, 1000.0f),
-            std::clamp(mmw(weight, a_config.fp.f32.colExtentMin[1], a_config.fp.f32.colExtentMax[1]), 0.0f, 1000.0f),
-            std::clamp(mmw(weight, a_config.fp.f32.colExtentMin[2], a_config.fp.f32.colExtentMax[2]), 0.0f, 1000.0f)
+            std::clamp(mmw(a_weight, a_config.fp.f32.colExtentMin[0], a_config.fp.f32.colExtentMax[0]), 0.0f, 1000.0f),
+            std::clamp(mmw(a_weight, a_config.fp.f32.colExtentMin[1], a_config.fp.f32.colExtentMax[1]), 0.0f, 1000.0f),
+            std::clamp(mmw(a_weight, a_config.fp.f32.colExtentMin[2], a_config.fp.f32.colExtentMax[2]), 0.0f, 1000.0f)
         );
     }
 
-    void SimComponent::UpdateConfig(
+    template <class T>
+    SKMP_FORCEINLINE static bool ArrayDiffers(const T(&a_lhs)[3], const T(&a_rhs)[3])
+    {
+        return a_lhs[0] != a_rhs[0] || a_lhs[1] != a_rhs[1] || a_lhs[2] != a_rhs[2];
+    }
+
+    ConfigChangeFlags SimComponent::GetConfigChanges(
+        const configComponent32_t* a_physConf,
+        const configNode_t& a_nodeConf,
+        bool a_collisions,
+        bool a_movement,
+        float a_weight) const
+    {
+        if (!m_configured)
+            return ConfigChangeFlags::All;
+
+        auto result(ConfigChangeFlags::None);
+
+        if (a_movement != m_motion)
+            result |= ConfigChangeFlags::Motion;
+
+        if (a_collisions != m_collisions || a_weight != m_colWeight)
+            result |= ConfigChangeFlags::Collider;
+
+        if (a_physConf != nullptr)
+        {
+            auto& n = a_physConf->fp.f32;
+            auto& o = m_conf.fp.f32;
+
+            // clamped values on our side may flag motion spuriously, which is harmless
+            if (std::memcmp(std::addressof(n), std::addressof(o), sizeof(physicsDataF32_t)) != 0)
+                result |= ConfigChangeFlags::Motion;
+
+            if (a_physConf->ex.colShape != m_conf.ex.colShape ||
+                StrHelpers::icompare(a_physConf->ex.colMesh, m_conf.ex.colMesh) != 0 ||
+                n.colSphereRadMin != o.colSphereRadMin ||
+                n.colSphereRadMax != o.colSphereRadMax ||
+                n.colHeightMin != o.colHeightMin ||
+                n.colHeightMax != o.colHeightMax ||
+                ArrayDiffers(n.colExtentMin, o.colExtentMin) ||
+                ArrayDiffers(n.colExtentMax, o.colExtentMax))
+            {
+                result |= ConfigChangeFlags::ColliderShape;
+            }
+
+            if (n.colPositionScale != o.colPositionScale ||
+                n.colRotationScale != o.colRotationScale ||
+                ArrayDiffers(n.colOffsetMin, o.colOffsetMin) ||
+                ArrayDiffers(n.colOffsetMax, o.colOffsetMax) ||
+                ArrayDiffers(n.colRot, o.colRot))
+            {
+                result |= ConfigChangeFlags::ColliderTransform;
+            }
+        }
+
+        auto& nf = a_nodeConf.fp.f32;
+
+        if (a_nodeConf.bl.b.boneCast != m_nodeState.boneCast)
+            result |= ConfigChangeFlags::ColliderShape;
+
+        // bonecast data can change without a config change, Collider::Create checks the update id
+        if (a_nodeConf.bl.b.boneCast && m_collider.IsCreated() && m_collider.IsBoneCast())
+            result |= ConfigChangeFlags::ColliderShape;
+
+        // same for mesh files reloaded from disk
+        if (m_collider.HasStaleMesh())
+            result |= ConfigChangeFlags::ColliderShape;
+
+        if (a_nodeConf.bl.b.offsetParent != m_nodeState.offsetParent ||
+            ArrayDiffers(nf.colOffsetMin, m_nodeState.colOffsetMin) ||
+            ArrayDiffers(nf.colOffsetMax, m_nodeState.colOffsetMax) ||
+            ArrayDiffers(nf.colRot, m_nodeState.colRot))
+        {
+            result |= ConfigChangeFlags::ColliderTransform;
+        }
+
+        if (a_nodeConf.bl.b.overrideScale != m_nodeState.overrideScale ||
+            (a_nodeConf.bl.b.overrideScale && nf.nodeScale != m_nodeState.nodeScale))
+        {
+            result |= ConfigChangeFlags::NodeScale;
+        }
+
+        return result;
+    }
+
+    ConfigChangeFlags SimComponent::UpdateConfig(
         Actor* a_actor,
         const configComponent32_t* a_physConf,
         const configNode_t& a_nodeConf,
         bool a_collisions,
         bool a_movement) noexcept
     {
+        float weight = std::clamp(Game::GetActorWeight(a_actor), 0.0f, 100.0f);
+
+        auto changes = GetConfigChanges(
+            a_physConf,
+            a_nodeConf,
+            a_collisions,
+            a_movement,
+            weight);
+
+        if (changes == ConfigChangeFlags::None)
+            return changes;
+
         if (a_physConf != nullptr)
             m_conf = *a_physConf;
 
         m_collisions = a_collisions;
+        m_colWeight = weight;
+        m_configured = true;
+
+        auto& nf = a_nodeConf.fp.f32;
+
+        for (int i = 0; i < 3; i++)
+        {
+            m_nodeState.colOffsetMin[i] = nf.colOffsetMin[i];
+            m_nodeState.colOffsetMax[i] = nf.colOffsetMax[i];
+            m_nodeState.colRot[i] = nf.colRot[i];
+        }
+
+        m_nodeState.nodeScale = nf.nodeScale;
+        m_nodeState.overrideScale = a_nodeConf.bl.b.overrideScale;
+        m_nodeState.offsetParent = a_nodeConf.bl.b.offsetParent;
+        m_nodeState.boneCast = a_nodeConf.bl.b.boneCast;
 
         if (a_movement != m_motion)
         {
@@ -761,11 +913,19 @@ namespace CBP
             m_applyForceQueue.swap(decltype(m_applyForceQueue)());
         }
 
-        if (a_collisions)
+        if (!a_collisions)
+        {
+            m_collider.Destroy();
+        }
+        else if ((changes & ConfigChangeFlags::Collider) != ConfigChangeFlags::None)
         {
-            ColUpdateWeightData(a_actor, m_conf, a_nodeConf);
+            ColUpdateWeightData(weight, m_conf, a_nodeConf);
+
+            bool created = (changes & ConfigChangeFlags::ColliderShape) != ConfigChangeFlags::None ?
+                m_collider.Create(a_nodeConf, m_conf.ex.colShape) :
+                m_collider.IsCreated();
 
-            if (m_collider.Create(a_nodeConf, m_conf.ex.colShape))
+            if (created)
             {
                 m_collider.SetOffset(
                     m_colOffset,
@@ -806,10 +966,27 @@ namespace CBP
                 }
             }
         }
-        else {
-            m_collider.Destroy();
+
+        if ((changes & ConfigChangeFlags::Motion) != ConfigChangeFlags::None)
+            UpdateMotionConfig();
+
+        if ((changes & ConfigChangeFlags::NodeScale) != ConfigChangeFlags::None)
+            UpdateNodeScale(a_nodeConf);
+
+        if ((changes & (ConfigChangeFlags::Collider | ConfigChangeFlags::NodeScale)) != ConfigChangeFlags::None)
+        {
+            m_obj->UpdateWorldData(&m_updateCtx);
+
+            SIMDFillParent();
+
+            m_collider.Update();
         }
 
+        return changes;
+    }
+
+    void SimComponent::UpdateMotionConfig()
+    {
         m_cogOffset.setValue(m_conf.fp.f32.cogOffset[0], m_conf.fp.f32.cogOffset[1], m_conf.fp.f32.cogOffset[2]);
         m_gravityCorrection.setZ(m_conf.fp.f32.gravityCorrection);
 
@@ -852,7 +1029,10 @@ namespace CBP
         m_linearScale.setValue(m_conf.fp.f32.linear[0], m_conf.fp.f32.linear[1], m_conf.fp.f32.linear[2]);
 
         m_gravForce = m_conf.fp.f32.gravityBias * m_conf.fp.f32.mass;
+    }
 
+    void SimComponent::UpdateNodeScale(const configNode_t& a_nodeConf)
+    {
         if (a_nodeConf.bl.b.overrideScale)
         {
             if (!m_hasScaleOverride)
@@ -873,12 +1053,6 @@ namespace CBP
                 m_hasScaleOverride = false;
             }
         }
-
-        m_obj->UpdateWorldData(&m_updateCtx);
-
-        SIMDFillParent();
-
-        m_collider.Update();
     }
 
     void SimComponent::Reset()
@@ -19,6 +19,20 @@ namespace CBP
     };
 #endif
 
+    enum class ConfigChangeFlags : uint32_t
+    {
+        None = 0,
+        Motion = 1U << 0,
+        ColliderShape = 1U << 1,
+        ColliderTransform = 1U << 2,
+        NodeScale = 1U << 3,
+
+        Collider = ColliderShape | ColliderTransform,
+        All = Motion | ColliderShape | ColliderTransform | NodeScale
+    };
+
+    DEFINE_ENUM_CLASS_BITWISE(ConfigChangeFlags);
+
     
     class SKMP_ALIGN(16) CollisionShape
     {
@@ -278,6 +292,9 @@ namespace CBP
             return m_bonecast;
         }
 
+        // the mesh profile was reloaded or removed since the shape was built
+        [[nodiscard]] bool HasStaleMesh() const;
+
         [[nodiscard]] SKMP_FORCEINLINE const auto& GetSphereOffset() const {
             return m_bodyOffset;
         }
@@ -333,12 +350,25 @@ namespace CBP
         bool m_offsetParent;
 
         std::string m_meshShape;
+        std::uint64_t m_meshUpdateID;
 
         SimComponent& m_parent;
     };
 
     class SKMP_ALIGN(16) SimComponent
     {
+        // node config inputs from the last update, used for change detection
+        struct nodeConfState_t
+        {
+            float colOffsetMin[3];
+            float colOffsetMax[3];
+            float colRot[3];
+            float nodeScale;
+            bool overrideScale;
+            bool offsetParent;
+            bool boneCast;
+        };
+
         struct SKMP_ALIGN(16) Force
         {
             Force(
@@ -359,10 +389,20 @@ namespace CBP
     private:
 
         void ColUpdateWeightData(
-            Actor * a_actor,
+            float a_weight,
             const configComponent16_t & a_config,
             const configNode_t & a_nodeConf);
 
+        void UpdateMotionConfig();
+        void UpdateNodeScale(const configNode_t & a_nodeConf);
+
+        [[nodiscard]] ConfigChangeFlags GetConfigChanges(
+            const configComponent32_t * a_physConf,
+            const configNode_t & a_nodeConf,
+            bool a_collisions,
+            bool a_movement,
+            float a_weight) const;
+
         SKMP_FORCEINLINE void ClampVelocity();
 
         SKMP_FORCEINLINE void ConstrainMotion(
@@ -399,7 +439,7 @@ namespace CBP
         SimComponent& operator=(const SimComponent&) = delete;
         SimComponent& operator=(SimComponent&&) = delete;
 
-        void UpdateConfig(
+        ConfigChangeFlags UpdateConfig(
             Actor * a_actor,
             const configComponent32_t * a_physConf,
             const configNode_t & a_nodeConf,
@@ -437,10 +477,18 @@ namespace CBP
             return m_configGroupName;
         }
 
+        [[nodiscard]] SKMP_FORCEINLINE auto GetConfigGroupId() const {
+            return m_configGroupId;
+        }
+
         [[nodiscard]] SKMP_FORCEINLINE const auto& GetNodeName() const {
             return m_nodeName;
         }
 
+        [[nodiscard]] SKMP_FORCEINLINE auto GetCollisionGroupId() const {
+            return m_groupId;
+        }
+
         [[nodiscard]] SKMP_FORCEINLINE bool IsSameGroup(const SimComponent & a_rhs) const
         {
             return a_rhs.m_groupId != 0 && m_groupId != 0 &&
@@ -538,6 +586,10 @@ namespace CBP
 
         configComponent16_t m_conf;
 
+        nodeConfState_t m_nodeState;
+        float m_colWeight;
+        bool m_configured;
+
         float m_colRad;
         float m_colHeight;
         float m_nodeScale;
@@ -560,6 +612,7 @@ namespace CBP
 
         std::string m_nodeName;
         std::string m_configGroupName;
+        configGroupId_t m_configGroupId;
 
         std::queue<Force, std::deque<Force, mem::aligned_allocator<Force, 16>>> m_applyForceQueue;
 
@@ -8,7 +8,7 @@ namespace CBP
         Game::ObjectHandle a_handle,
         Actor* a_actor,
         char a_sex,
-        const configComponents_t& a_config,
+        const configComponentsCompiled_t& a_config,
         const nodeMap_t& a_nodeMap,
         bool a_collisions,
         nodeDescList_t& a_out)
@@ -42,7 +42,7 @@ namespace CBP
             if (!collisions && !movement)
                 continue;
 
-            auto it = a_config.find(b.second);
+            auto physConf = a_config.Get(b.second);
 
             a_out.emplace_back(
                 b.first,
@@ -50,7 +50,7 @@ namespace CBP
                 b.second,
                 a_collisions && collisions,
                 movement,
-                it != a_config.end() ? it->second : IConfig::GetDefaultPhysics(),
+                physConf ? *physConf : IConfig::GetDefaultPhysics(),
                 nodeConf
             );
         }
@@ -147,11 +147,13 @@ namespace CBP
             m_objList[i]->Reset();
     }
 
-    void SimObject::UpdateConfig(
+    configUpdateResult_t SimObject::UpdateConfig(
         Actor* a_actor,
         bool a_collisions,
-        const configComponents_t& a_config)
+        const configComponentsCompiled_t& a_config)
     {
+        configUpdateResult_t result;
+
         auto& nodeConfig = IConfig::GetActorNode(m_handle);
 
         auto count = m_objList.size();
@@ -159,7 +161,7 @@ namespace CBP
         {
             auto p = m_objList[i];
 
-            auto& confGroup = p->GetConfigGroupName();
+            auto confGroup = p->GetConfigGroupId();
 
             if (!IConfig::IsValidGroup(confGroup))
                 continue;
@@ -170,17 +172,23 @@ namespace CBP
             bool collisions, movement;
             nodeConf.Get(m_sex, collisions, movement);
 
-            auto itc = a_config.find(confGroup);
-            auto& physConf = itc != a_config.end() ? itc->second : IConfig::GetDefaultPhysics();
+            auto physConf = a_config.Get(confGroup);
 
-            p->UpdateConfig(
+            auto changes = p->UpdateConfig(
                 a_actor,
-                std::addressof(physConf),
+                physConf ? physConf : std::addressof(IConfig::GetDefaultPhysics()),
                 nodeConf,
                 a_collisions && collisions,
                 movement
             );
+
+            if ((changes & (ConfigChangeFlags::Collider | ConfigChangeFlags::NodeScale)) != ConfigChangeFlags::None)
+                result.performed++;
+            else
+                result.skipped++;
         }
+
+        return result;
     }
 
     void SimObject::ApplyForce(
@@ -34,6 +34,12 @@ namespace CBP
 
     typedef stl::vector<nodeDesc_t> nodeDescList_t;
 
+    struct configUpdateResult_t
+    {
+        uint32_t performed{ 0 };
+        uint32_t skipped{ 0 };
+    };
+
     class SimObject
     {
         //typedef stl::imap<std::string, SimComponent> thingMap_t;
@@ -60,7 +66,7 @@ namespace CBP
         SKMP_FORCEINLINE void UpdateMotion(float a_timeStep);
         SKMP_FORCEINLINE void UpdateVelocity();
 
-        void UpdateConfig(Actor* a_actor, bool a_collisions, const configComponents_t& a_config);
+        configUpdateResult_t UpdateConfig(Actor* a_actor, bool a_collisions, const configComponentsCompiled_t& a_config);
         void Reset();
         //bool ValidateNodes(Actor* a_actor);
 
@@ -74,7 +80,7 @@ namespace CBP
             Game::ObjectHandle a_handle,
             Actor* a_actor,
             char a_sex,
-            const configComponents_t& a_config,
+            const configComponentsCompiled_t& a_config,
             const nodeMap_t& a_nodeMap,
             bool a_collisions,
             nodeDescList_t& a_out)
@@ -221,6 +221,8 @@ namespace CBP
                 );
             }
         }
+
+        IConfig::BumpPhysicsVersion(ConfigClass::kConfigTemplate);
     }
 
     template <typename T>
@@ -278,6 +280,8 @@ namespace CBP
                 ++itfm;
             }
         }
+
+        IConfig::BumpPhysicsVersion(ConfigClass::kConfigTemplate);
     }
 
     bool ITemplate::LoadPluginData()
@@ -449,6 +453,8 @@ namespace CBP
             //gLog.Debug("!! 0x%X", it->second->GetPartialIndex());
         }
 
+        IConfig::BumpPhysicsVersion(ConfigClass::kConfigTemplate);
+
         return true;
     }
 }
\ No newline at end of file
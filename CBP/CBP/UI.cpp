@@ -26,6 +26,8 @@ namespace CBP
         auto& nodeConfig = IConfig::GetOrCreateRaceNode(a_formid);
         nodeConfig.insert_or_assign(a_node, a_data);
 
+        IConfig::MarkPruneDirtyAll();
+
         if (a_reset)
             DCBP::ResetActors();
         else
@@ -308,6 +310,68 @@ namespace CBP
         MarkChanged();
     }
 
+    void UIRaceEditorNode::DrawBoneCastSample(
+        Game::FormID a_formid,
+        const std::string& a_nodeName,
+        configNode_t& a_conf)
+    {
+        if (a_formid == Game::FormID(0))
+            return;
+
+        const float width = ImGui::GetWindowContentRegionMax().x;
+
+        if (IBoneCast::IsBatchRunning())
+        {
+            size_t done, total;
+            IBoneCast::GetBatchProgress(done, total);
+
+            ImGui::TextWrapped("Rebuilding: %zu/%zu", done, total);
+        }
+        else
+        {
+            bool disabled = a_conf.ex.bcShape.empty();
+
+            if (disabled)
+            {
+                ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+                ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+            }
+
+            ImGui::SameLine(width - GetNextTextOffset("Sample all", true) - 4.0f);
+            if (ButtonRight("Sample all"))
+            {
+                stl::vector<BoneCastCache::key_t> keys;
+
+                for (const auto& e : IData::GetActorCache())
+                {
+                    if (!e.second.active || e.second.race != a_formid)
+                        continue;
+
+                    auto& nodeConfig = IConfig::GetActorNode(e.first);
+                    auto itn = nodeConfig.find(a_nodeName);
+                    if (itn == nodeConfig.end() || !itn->second.bl.b.boneCast)
+                        continue;
+
+                    keys.emplace_back(e.first, a_nodeName);
+                }
+
+                if (!keys.empty())
+                    DTasks::AddTask<BoneCastBatchCreateTask0>(std::move(keys));
+            }
+
+            if (disabled)
+            {
+                ImGui::PopStyleVar();
+                ImGui::PopItemFlag();
+
+                if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+                    ImGui::SetTooltip("No shape selected");
+            }
+        }
+
+        ImGui::Spacing();
+    }
+
     void UIRaceEditorNode::Draw(bool* a_active)
     {
         auto& globalConfig = IConfig::GetGlobal();
@@ -824,6 +888,23 @@ namespace CBP
                         );
                     }
 
+                    if (ImGui::MenuItem("Compact"))
+                    {
+                        m_popup.push(
+                            UIPopupType::Confirm,
+                            "Compact",
+                            "This will remove actor physics records identical to their race, template or global config. Those values will follow later changes to that config. Are you sure?"
+                        ).call([&](...)
+                            {
+                                auto num = IConfig::CompactActorPhysics();
+                                Debug("%zu compacted", num);
+
+                                if (num > 0)
+                                    QueueListUpdateAll();
+                            }
+                        );
+                    }
+
                     if (a_entry->first != Game::ObjectHandle(0))
                     {
                         ImGui::Separator();
@@ -944,7 +1025,7 @@ namespace CBP
                     ImGui::SameLine(wcm.x - GetNextTextOffset("Edit", true));
                     if (ButtonRight("Edit"))
                     {
-                        m_armorOverride.SetCurrentOverrides(armorOverrides->first);
+                        m_armorOverride.SetCurrentOverrides(armorOverrides->paths);
                         m_state.windows.armorOverride = true;
                     }
                 }
@@ -1102,6 +1183,7 @@ namespace CBP
                 }
 
                 Checkbox("Controller stats", &globalConfig.general.controllerStats);
+                Checkbox("Prune inactive records on save", &globalConfig.general.autoPrune);
 
                 ImGui::Spacing();
 
@@ -1581,6 +1663,8 @@ namespace CBP
             auto& nodeConfig = IConfig::GetOrCreateActorNode(a_handle);
             nodeConfig.insert_or_assign(a_node, a_data);
 
+            IConfig::MarkPruneDirtyNode(a_handle, a_node);
+
             if (a_reset)
                 DCBP::ResetActors();
             else
@@ -1592,6 +1676,8 @@ namespace CBP
             auto& nodeConfig = IConfig::GetGlobalNode();
             nodeConfig.insert_or_assign(a_node, a_data);
 
+            IConfig::MarkPruneDirtyAll();
+
             if (a_reset)
                 DCBP::ResetActors();
             else
@@ -1649,8 +1735,7 @@ namespace CBP
         if (globalConfig.ui.actor.clampValues)
             *a_val = std::clamp(*a_val, a_desc.second.min, a_desc.second.max);
 
-        auto& actorConf = IConfig::GetOrCreateActorPhysics(a_handle);
-        auto& entry = actorConf[a_pair.first];
+        auto& entry = IConfig::GetOrCreateActorPhysics(a_handle, a_pair.first);
 
         entry.Set(a_desc.second, a_val);
 
@@ -1666,6 +1751,14 @@ namespace CBP
             entry.Set(a_desc.second.counterpart, mval);
         }
 
+        // propagation only touches groups present in the actor's delta
+        VisitPropagateTargets(a_pair.first,
+            [&](const std::string& a_group) {
+                IConfig::GetOrCreateActorPhysics(a_handle, a_group);
+            });
+
+        auto& actorConf = IConfig::GetActorPhysicsDelta(a_handle);
+
         DoOnChangePropagation(a_data, std::addressof(actorConf), a_pair, a_desc, a_val, sync, mval);
 
         DCBP::DispatchActorTask(
@@ -1678,8 +1771,7 @@ namespace CBP
         configComponentsValue_t& a_pair,
         const componentValueDescMap_t::vec_value_type& a_desc)
     {
-        auto& actorConf = IConfig::GetOrCreateActorPhysics(a_handle);
-        auto& entry = actorConf[a_pair.first];
+        auto& entry = IConfig::GetOrCreateActorPhysics(a_handle, a_pair.first);
 
         entry.ex.colShape = a_pair.second.ex.colShape;
         entry.ex.colMesh = a_pair.second.ex.colMesh;
@@ -1693,10 +1785,9 @@ namespace CBP
         configComponents_t& a_data,
         configComponentsValue_t& a_pair)
     {
-        auto& actorConf = IConfig::GetOrCreateActorPhysics(a_handle);
-        actorConf[a_pair.first] = a_pair.second;
+        IConfig::GetOrCreateActorPhysics(a_handle, a_pair.first) = a_pair.second;
 
-        /*Propagate(a_data, std::addressof(actorConf), a_pair,
+        /*Propagate(a_data, std::addressof(IConfig::GetActorPhysicsDelta(a_handle)), a_pair,
             [&](configComponent32_t& a_v, const configPropagate_t& a_p) {
                 a_v = a_pair.second;
             });*/
@@ -1739,6 +1830,8 @@ namespace CBP
             auto& nodeConfig = IConfig::GetOrCreateActorNode(a_handle);
             nodeConfig.insert_or_assign(a_node, a_data);
 
+            IConfig::MarkPruneDirtyNode(a_handle, a_node);
+
             if (a_reset)
                 DCBP::ResetActors();
             else
@@ -1843,7 +1936,7 @@ namespace CBP
         if (globalConfig.ui.actor.clampValues)
             *a_val = std::clamp(*a_val, a_desc.second.min, a_desc.second.max);
 
-        auto& conf = IConfig::GetGlobalPhysics();
+        auto& conf = IConfig::ModifyGlobalPhysics();
         auto& entry = conf[a_pair.first];
 
         entry.Set(a_desc.second, a_val);
@@ -1871,7 +1964,7 @@ namespace CBP
         configComponentsValue_t& a_pair,
         const componentValueDescMap_t::vec_value_type&)
     {
-        auto& conf = IConfig::GetGlobalPhysics();
+        auto& conf = IConfig::ModifyGlobalPhysics();
         auto& entry = conf[a_pair.first];
 
         entry.ex.colShape = a_pair.second.ex.colShape;
@@ -1885,7 +1978,7 @@ namespace CBP
         configComponents_t& a_data,
         configComponentsValue_t& a_pair)
     {
-        auto& conf = IConfig::GetGlobalPhysics();
+        auto& conf = IConfig::ModifyGlobalPhysics();
         conf[a_pair.first] = a_pair.second;
 
         /*Propagate(a_data, std::addressof(conf), a_pair,
@@ -1930,6 +2023,8 @@ namespace CBP
             auto& nodeConfig = IConfig::GetGlobalNode();
             nodeConfig.insert_or_assign(a_node, a_data);
 
+            IConfig::MarkPruneDirtyAll();
+
             if (a_reset)
                 DCBP::ResetActors();
             else
@@ -2198,6 +2293,10 @@ namespace CBP
                 ImGui::Text("Actors:");
                 ImGui::Text("UI:");
                 ImGui::Text("BoneCast cache:");
+                ImGui::Text("BoneCast writes:");
+                HelpMarker(MiscHelpText::boneCastWrites);
+                ImGui::Text("Config rebuilds:");
+                HelpMarker(MiscHelpText::configUpdates);
 #if defined(SKMP_MEMDBG)
                 ImGui::Text("Mem:");
 #endif
@@ -2221,6 +2320,12 @@ namespace CBP
                 ImGui::Text("%u", stats.avgActorCount);
                 ImGui::Text("%lld \xC2\xB5s", DUI::GetPerf());
                 ImGui::Text("%zu kb", IBoneCast::GetCacheSize() / size_t(1024));
+
+                auto ws = IBoneCast::GetWriteStats();
+                ImGui::Text("%zu/%zu, %llu (%lld \xC2\xB5s)", ws.queued, ws.peakQueued, ws.written, ws.lastLatency);
+
+                auto& cs = profiler.GetConfigUpdateStats();
+                ImGui::Text("%llu / %llu skipped", cs.performed, cs.skipped);
 #if defined(SKMP_MEMDBG)
                 ImGui::Text("%llu ", mem::g_allocatedSize.load());
 #endif
@@ -2261,8 +2366,96 @@ namespace CBP
                     ImGui::Spacing();
                 }
 
+                static const std::string ihKey("Stats#Instructions");
+
+                if (CollapsingHeader(ihKey, "Instructions"))
+                {
+                    auto controller = DCBP::GetController();
+
+                    auto& is = controller->GetInstructionStats();
+                    auto& qs = controller->GetInstructionQueueStats();
+
+                    ImGui::TextWrapped("Queue: %llu, %llu overflowed, peak batch %zu (%lld \xC2\xB5s)",
+                        qs.pushed, qs.overflowed, qs.peakBatch, controller->GetLastDrainTime());
+                    HelpMarker(MiscHelpText::instructionQueue);
+
+                    ImGui::TextWrapped("Received / executed");
+                    HelpMarker(MiscHelpText::instructions);
+
+                    ImGui::Columns(2, nullptr, false);
+
+                    for (uint32_t i = 0; i < Enum::Underlying(ControllerInstruction::Action::Max); i++)
+                    {
+                        if (!is.received[i])
+                            continue;
+
+                        ImGui::Text("%s:", ControllerInstruction::GetActionName(
+                            static_cast<ControllerInstruction::Action>(i)));
+                        ImGui::NextColumn();
+                        ImGui::Text("%llu / %llu", is.received[i], is.executed[i]);
+                        ImGui::NextColumn();
+                    }
+
+                    ImGui::Columns(1);
+                }
+
+                ImGui::Separator();
+            }
+
+#ifdef _CBP_ENABLE_DEBUG
+            static const std::string shKey("Stats#Serialization");
+
+            if (CollapsingHeader(shKey, "Serialization benchmark"))
+            {
+                ImGui::PushItemWidth(ImGui::GetFontSize() * -8.0f);
+
+                if (ImGui::InputInt("Actors", &m_benchActors))
+                    m_benchActors = std::clamp(m_benchActors, 1, 100000);
+
+                if (ImGui::InputInt("Groups", &m_benchGroups))
+                    m_benchGroups = std::clamp(m_benchGroups, 1, 256);
+
+                ImGui::PopItemWidth();
+
+                if (ImGui::Button("Run"))
+                {
+                    if (!DCBP::RunSerializationBenchmark(
+                        static_cast<std::uint32_t>(m_benchActors),
+                        static_cast<std::uint32_t>(m_benchGroups),
+                        m_benchResult))
+                    {
+                        ImGui::OpenPopup("Benchmark failed");
+                    }
+                }
+                HelpMarker(MiscHelpText::serializationBench);
+
+                if (!m_benchResult.entries.empty())
+                {
+                    ImGui::Columns(4, nullptr, false);
+
+                    for (const auto& e : m_benchResult.entries)
+                    {
+                        ImGui::Text("%s:", e.name.c_str());
+                        ImGui::NextColumn();
+                        ImGui::Text("%.2f ms", e.time * 1000.0);
+                        ImGui::NextColumn();
+                        ImGui::Text("%zu kb", e.bytes / size_t(1024));
+                        ImGui::NextColumn();
+                        ImGui::Text("%+lld kb ws", e.workingSetDelta / 1024);
+                        ImGui::NextColumn();
+                    }
+
+                    ImGui::Columns(1);
+                }
+
+                UICommon::MessageDialog(
+                    "Benchmark failed",
+                    "The last exception was:\n\n%s",
+                    DCBP::GetLastSerializationException().what());
+
                 ImGui::Separator();
             }
+#endif
 
             static const std::string chKey("Stats#Settings");
 
@@ -2520,6 +2713,16 @@ namespace CBP
         }
     }
 
+    static void DrawAsyncProgress(const ISerialization::asyncStatus_t& a_status)
+    {
+        char buf[64];
+        _snprintf_s(buf, _TRUNCATE, "%zu/%zu", a_status.done, a_status.total);
+
+        ImGui::ProgressBar(a_status.total ?
+            static_cast<float>(a_status.done) / static_cast<float>(a_status.total) : 0.0f,
+            ImVec2(ImGui::GetFontSize() * 20.0f, 0.0f), buf);
+    }
+
     bool UIDialogImport::Draw(bool* a_active)
     {
         auto& io = ImGui::GetIO();
@@ -2589,32 +2792,47 @@ namespace CBP
 
             ImGui::Separator();
 
-            if (ImGui::Button("Import", ImVec2(120, 0)))
+            // completed (applied) by the driver, the dialog only reports it
+            bool result;
+            if (DCBP::TakeAsyncIOResult(ISerialization::AsyncOp::Import, result))
+            {
+                if (result) {
+                    *a_active = false;
+                    res = true;
+                }
+                else
+                    ImGui::OpenPopup("Import failed");
+            }
+
+            auto status = DCBP::GetAsyncIOStatus();
+
+            if (status.op == ISerialization::AsyncOp::Import)
+                DrawAsyncProgress(status);
+            else
             {
-                if (selected && selected->m_infoResult)
+                if (ImGui::Button("Import", ImVec2(120, 0)))
                 {
-                    ISerialization::ImportFlags flags(ISerialization::ImportFlags::None);
-
-                    if (globalConfig.ui.import.global)
-                        flags |= ISerialization::ImportFlags::Global;
-                    if (globalConfig.ui.import.actors)
-                        flags |= ISerialization::ImportFlags::Actors;
-                    if (globalConfig.ui.import.races)
-                        flags |= ISerialization::ImportFlags::Races;
-
-                    if (DCBP::ImportData(selected->m_path, flags)) {
-                        *a_active = false;
-                        res = true;
+                    if (selected && selected->m_infoResult)
+                    {
+                        ISerialization::ImportFlags flags(ISerialization::ImportFlags::None);
+
+                        if (globalConfig.ui.import.global)
+                            flags |= ISerialization::ImportFlags::Global;
+                        if (globalConfig.ui.import.actors)
+                            flags |= ISerialization::ImportFlags::Actors;
+                        if (globalConfig.ui.import.races)
+                            flags |= ISerialization::ImportFlags::Races;
+
+                        if (!DCBP::ImportData(selected->m_path, flags))
+                            ImGui::OpenPopup("Import failed");
                     }
-                    else
-                        ImGui::OpenPopup("Import failed");
                 }
-            }
 
-            ImGui::SetItemDefaultFocus();
-            ImGui::SameLine();
-            if (ImGui::Button("Cancel", ImVec2(120, 0)))
-                *a_active = false;
+                ImGui::SetItemDefaultFocus();
+                ImGui::SameLine();
+                if (ImGui::Button("Cancel", ImVec2(120, 0)))
+                    *a_active = false;
+            }
 
             UICommon::MessageDialog(
                 "Import failed",
@@ -2634,6 +2852,10 @@ namespace CBP
 
         ImGui::End();
 
+        // stay open until the parsed data has been applied
+        if (DCBP::GetAsyncIOStatus().op == ISerialization::AsyncOp::Import)
+            *a_active = true;
+
         ImGui::PopID();
 
         return res;
@@ -2656,13 +2878,13 @@ namespace CBP
         m_buf[0] = 0x0;
     }
 
-    bool UIDialogExport::OnFileInput()
+    void UIDialogExport::OnFileInput()
     {
         if (!std::regex_match(m_buf, m_rFileCheck))
         {
             m_buf[0] = 0x0;
             ImGui::OpenPopup("Illegal filename");
-            return false;
+            return;
         }
 
         auto& driverConf = DCBP::GetDriverConfig();
@@ -2680,15 +2902,11 @@ namespace CBP
             else
                 ImGui::OpenPopup("Overwrite");
 
-            return false;
+            return;
         }
 
-        if (!DCBP::ExportData(m_lastTargetPath)) {
+        if (!DCBP::ExportData(m_lastTargetPath))
             ImGui::OpenPopup("Export failed");
-            return false;
-        }
-
-        return true;
     }
 
     bool UIDialogExport::Draw()
@@ -2700,17 +2918,43 @@ namespace CBP
         ImGui::PushID(static_cast<const void*>(this));
 
         if (UICommon::TextInputDialog("Export to file", "Enter filename", m_buf, sizeof(m_buf), globalConfig.ui.fontScale))
-            res = OnFileInput();
+            OnFileInput();
 
         if (UICommon::ConfirmDialog(
             "Overwrite",
             "File already exists, do you want to overwrite?\n"))
         {
-            res = DCBP::ExportData(m_lastTargetPath);
+            if (!DCBP::ExportData(m_lastTargetPath))
+                ImGui::OpenPopup("Export failed");
+        }
+
+        bool result;
+        if (DCBP::TakeAsyncIOResult(ISerialization::AsyncOp::Export, result))
+        {
+            res = result;
             if (!res)
                 ImGui::OpenPopup("Export failed");
         }
 
+        auto status = DCBP::GetAsyncIOStatus();
+
+        if (status.op == ISerialization::AsyncOp::Export)
+        {
+            auto& io = ImGui::GetIO();
+
+            ImVec2 center(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f);
+            ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+
+            if (ImGui::Begin("Exporting##CBP", nullptr,
+                ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse))
+            {
+                ImGui::SetWindowFontScale(globalConfig.ui.fontScale);
+                DrawAsyncProgress(status);
+            }
+
+            ImGui::End();
+        }
+
         UICommon::MessageDialog(
             "Illegal filename",
             "Filename contains illegal characters");
@@ -178,6 +178,11 @@ namespace CBP
             const std::string& a_node,
             const configNode_t& a_data,
             bool a_reset);
+
+        virtual void DrawBoneCastSample(
+            Game::FormID a_formid,
+            const std::string& a_nodeName,
+            configNode_t& a_conf);
     };
 
     class UIRaceEditorPhysics :
@@ -299,6 +304,12 @@ namespace CBP
 
         UIPlot m_plotUpdateTime;
         UIPlot m_plotFramerate;
+
+#ifdef _CBP_ENABLE_DEBUG
+        int m_benchActors = 1000;
+        int m_benchGroups = 8;
+        ISerialization::benchResult_t m_benchResult{ 0, 0 };
+#endif
     };
 
 #ifdef _CBP_ENABLE_DEBUG
@@ -377,7 +388,7 @@ namespace CBP
 
     private:
 
-        bool OnFileInput();
+        void OnFileInput();
 
         fs::path m_path;
         fs::path m_lastTargetPath;
@@ -35,7 +35,12 @@ namespace CBP
         dataFilterNode,
         frameTimer,
         timePerFrame,
-        rotation
+        rotation,
+        boneCastWrites,
+        configUpdates,
+        instructions,
+        instructionQueue,
+        serializationBench
     };
 
     typedef std::pair<const std::string, configComponents_t> actorEntryPhysConf_t;
@@ -27,12 +27,15 @@ namespace CBP
             auto& data1 = it->second.m_data.first;
             auto& data2 = it->second.m_data.second;
 
-            ImGui::TextWrapped("Vertices: %zu, Indices: %zu / %zu, Mem: %zu kb", 
+            ImGui::TextWrapped("Vertices: %zu, Indices: %zu / %zu, Mem: %zu kb (unpacked: %zu kb)", 
                 data1.m_vertices.size(), 
                 data2.m_indices.size(), 
                 data1.m_indices.size(), 
-                it->second.m_size / size_t(1024));
+                it->second.m_size / size_t(1024),
+                it->second.m_data.GetUnpackedSize() / size_t(1024));
 
+            if (IBoneCast::IsSimplifyPending(a_handle, a_nodeName))
+                ImGui::TextWrapped("Simplifying..");
         }
         else {
             ImGui::TextWrapped("No shape data exists");
@@ -73,9 +76,18 @@ namespace CBP
 
             //ImGui::Indent();
 
+            bool active(false);
+
             changed |= ImGui::SliderFloat("Weight threshold", &a_conf.fp.f32.bcWeightThreshold, 0.0f, 1.0001f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+            active |= ImGui::IsItemActive();
             changed |= ImGui::SliderFloat("Simplify target", &a_conf.fp.f32.bcSimplifyTarget, 0.0f, 1.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+            active |= ImGui::IsItemActive();
             changed |= ImGui::SliderFloat("Simplify target error", &a_conf.fp.f32.bcSimplifyTargetError, 0.001f, 0.1f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
+            active |= ImGui::IsItemActive();
+
+            if (active)
+                IBoneCast::MarkInteractive();
+
             changed |= ImGui::InputText("Shape name", std::addressof(a_conf.ex.bcShape));
 
             //ImGui::Unindent();
@@ -61,6 +61,26 @@ namespace CBP
             const configComponentsValue_t& a_pair,
             propagateFunc_t a_func) const;
 
+        template <class Tf>
+        void VisitPropagateTargets(
+            const std::string& a_group,
+            Tf a_func) const
+        {
+            const auto& globalConfig = IConfig::GetGlobal();
+
+            auto itm = globalConfig.ui.propagate.find(ID);
+            if (itm == globalConfig.ui.propagate.end())
+                return;
+
+            auto it = itm->second.find(a_group);
+            if (it == itm->second.end())
+                return;
+
+            for (auto& e : it->second)
+                if (e.second.enabled)
+                    a_func(e.first);
+        }
+
         [[nodiscard]] virtual std::string GetGCSID(
             const std::string& a_name) const;
 
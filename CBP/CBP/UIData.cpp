@@ -28,7 +28,12 @@ namespace CBP
         {MiscHelpText::dataFilterNode, "Filter by node name. Press enter to apply."},
         {MiscHelpText::frameTimer, "Skyrim's frame timer, affected by time modifier."},
         {MiscHelpText::timePerFrame, "Amount of time the physics simulation consumes per frame (in microseconds)."},
-        {MiscHelpText::rotation, "Collider rotation in degrees around the X, Y and Z axes respectively."}
+        {MiscHelpText::rotation, "Collider rotation in degrees around the X, Y and Z axes respectively."},
+        {MiscHelpText::boneCastWrites, "Queued / peak queued bonecast writes, total written and average latency of the last batch (queue to commit)."},
+        {MiscHelpText::configUpdates, "Components whose collider or node transform was rebuilt on a config update / components where nothing relevant changed and the rebuild was skipped."},
+        {MiscHelpText::instructions, "Controller instructions queued per action versus those actually executed after duplicates and instructions superseded by a reset or an *All variant were dropped."},
+        {MiscHelpText::instructionQueue, "Instructions passed through the controller queue, how many of them spilled past the ring into the locked overflow path, the largest batch drained in a single frame and how long the last drain took."},
+        {MiscHelpText::serializationBench, "Runs synthetic actors through JSON, the old archive format, the co-save block schema, each codec and export/import, times armor override merges for 300 actors with a cold and a warm cache, recording time, size and working set change per phase, then writes Cache\\SerializationBench.csv. Debug builds only, the game stalls while it runs."}
         });
 
     const keyDesc_t UIBase::m_comboKeyDesc({
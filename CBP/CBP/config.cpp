@@ -5,11 +5,16 @@ namespace CBP
     configComponents_t IConfig::physicsGlobalConfig;
     //configComponents_t IConfig::physicsGlobalConfigDefaults;
     actorConfigComponentsHolder_t IConfig::actorConfHolder;
+    IConfig::resolvedActorConf_t IConfig::resolvedActorConf;
+    IConfig::pruneDirty_t IConfig::pruneDirty;
     raceConfigComponentsHolder_t IConfig::raceConfHolder;
     configGlobal_t IConfig::globalConfig;
     IConfig::vKey_t IConfig::validConfGroups;
     nodeMap_t IConfig::nodeMap;
     configGroupMap_t IConfig::configGroupMap;
+    stl::iunordered_map<std::string, configGroupId_t> IConfig::configGroupIdMap;
+    stl::vector<std::string> IConfig::configGroupNames;
+    stl::vector<uint8_t> IConfig::validGroupIds;
 
     collisionGroups_t IConfig::collisionGroups;
     nodeCollisionGroupMap_t IConfig::nodeCollisionGroupMap;
@@ -21,6 +26,15 @@ namespace CBP
 
     armorOverrides_t IConfig::armorOverrides;
     mergedConfCache_t IConfig::mergedConfCache;
+    compiledLayerCache_t IConfig::compiledLayerCache;
+    IConfig::mergedCacheStats_t IConfig::mergedCacheStats;
+
+    uint64_t IConfig::layerVersionCounter(0);
+    uint64_t IConfig::globalPhysicsVersion(0);
+    uint64_t IConfig::templatePhysicsVersion(0);
+    IConfig::versionStamps_t<Game::FormID> IConfig::racePhysicsVersion;
+    IConfig::versionStamps_t<Game::ObjectHandle> IConfig::actorPhysicsVersion;
+    IConfig::versionStamps_t<Game::ObjectHandle> IConfig::armorOverrideVersion;
 
     configNodes_t IConfig::templateBaseNodeHolder;
     configComponents_t IConfig::templateBasePhysicsHolder;
@@ -106,11 +120,30 @@ namespace CBP
             configGroupMap[v.second].emplace_back(v.first);
         }
 
+        std::fill(validGroupIds.begin(), validGroupIds.end(), uint8_t(0));
+
         for (const auto& v : validConfGroups)
         {
             templateBasePhysicsHolder.try_emplace(v);
             physicsGlobalConfig.try_emplace(v);
+            validGroupIds[InternConfigGroup(v)] = 1;
         }
+
+        BumpPhysicsVersion(ConfigClass::kConfigGlobal);
+    }
+
+    configGroupId_t IConfig::InternConfigGroup(const std::string& a_group)
+    {
+        auto r = configGroupIdMap.try_emplace(
+            a_group, static_cast<configGroupId_t>(configGroupNames.size()));
+
+        if (r.second)
+        {
+            configGroupNames.emplace_back(a_group);
+            validGroupIds.emplace_back(uint8_t(0));
+        }
+
+        return r.first->second;
     }
 
     bool IConfig::AddNode(
@@ -130,6 +163,9 @@ namespace CBP
         templateBasePhysicsHolder.try_emplace(a_confGroup);
         physicsGlobalConfig.try_emplace(a_confGroup);
         configGroupMap[a_confGroup].emplace_back(a_node);
+        validGroupIds[InternConfigGroup(a_confGroup)] = 1;
+
+        BumpPhysicsVersion(ConfigClass::kConfigGlobal);
 
         if (a_save)
             return SaveNodeMap(configGroupMap);
@@ -159,8 +195,14 @@ namespace CBP
         if (it != itc->second.end())
             itc->second.erase(it);
 
+        MarkPruneDirtyAll();
+
         if (itc->second.empty())
         {
+            auto id = GetConfigGroupId(confGroup);
+            if (id != INVALID_CONFIG_GROUP_ID)
+                validGroupIds[id] = 0;
+
             validConfGroups.erase(confGroup);
             templateBasePhysicsHolder.erase(confGroup);
             configGroupMap.erase(itc);
@@ -217,14 +259,37 @@ namespace CBP
         return ConfigClass::kConfigGlobal;
     }
 
+    void IConfig::BumpPhysicsVersion(ConfigClass a_class) noexcept
+    {
+        switch (a_class)
+        {
+        case ConfigClass::kConfigGlobal:
+            globalPhysicsVersion = ++layerVersionCounter;
+            break;
+        case ConfigClass::kConfigTemplate:
+            templatePhysicsVersion = ++layerVersionCounter;
+            break;
+        case ConfigClass::kConfigRace:
+            racePhysicsVersion.BumpAll();
+            break;
+        case ConfigClass::kConfigActor:
+            actorPhysicsVersion.BumpAll();
+            break;
+        }
+    }
+
     void IConfig::SetActorPhysics(Game::ObjectHandle a_handle, const configComponents_t& a_conf)
     {
+        actorPhysicsVersion.Bump(a_handle);
         actorConfHolder.insert_or_assign(a_handle, a_conf);
+        MarkPruneDirty(a_handle);
     }
 
     void IConfig::SetActorPhysics(Game::ObjectHandle a_handle, configComponents_t&& a_conf)
     {
+        actorPhysicsVersion.Bump(a_handle);
         actorConfHolder.insert_or_assign(a_handle, std::move(a_conf));
+        MarkPruneDirty(a_handle);
     }
 
     bool IConfig::GetGlobalNode(const std::string& a_node, configNode_t& a_out)
@@ -323,104 +388,245 @@ namespace CBP
     void IConfig::SetActorNode(Game::ObjectHandle a_handle, const configNodes_t& a_conf)
     {
         actorNodeConfigHolder.insert_or_assign(a_handle, a_conf);
+        MarkPruneDirty(a_handle);
     }
 
     void IConfig::SetActorNode(Game::ObjectHandle a_handle, configNodes_t&& a_conf)
     {
         actorNodeConfigHolder.insert_or_assign(a_handle, std::move(a_conf));
+        MarkPruneDirty(a_handle);
     }
 
+    // race nodes apply to every actor of the race without its own node config
     void IConfig::SetRaceNode(Game::FormID a_handle, const configNodes_t& a_conf)
     {
         raceNodeConfigHolder.insert_or_assign(a_handle, a_conf);
+        MarkPruneDirtyAll();
     }
 
     void IConfig::SetRaceNode(Game::FormID a_handle, configNodes_t&& a_conf)
     {
         raceNodeConfigHolder.insert_or_assign(a_handle, std::move(a_conf));
+        MarkPruneDirtyAll();
+    }
+
+    configComponent32_t& IConfig::GetOrCreateActorPhysics(Game::ObjectHandle a_handle, const std::string& a_group)
+    {
+        actorPhysicsVersion.Bump(a_handle);
+
+        auto& delta = actorConfHolder[a_handle];
+
+        auto it = delta.find(a_group);
+        if (it != delta.end())
+            return it->second;
+
+        MarkPruneDirty(a_handle, a_group);
+
+        ConfigClass tmp;
+        auto& parent = GetActorPhysicsParent(a_handle, tmp);
+
+        auto itp = parent.find(a_group);
+        if (itp != parent.end())
+            return delta.emplace(a_group, itp->second).first->second;
+
+        return delta[a_group];
     }
 
-    configComponents_t& IConfig::GetOrCreateActorPhysics(Game::ObjectHandle a_handle)
+    configComponents_t& IConfig::GetActorPhysicsDelta(Game::ObjectHandle a_handle)
+    {
+        actorPhysicsVersion.Bump(a_handle);
+        return actorConfHolder[a_handle];
+    }
+
+    const configComponents_t& IConfig::GetActorPhysics(Game::ObjectHandle a_handle)
+    {
+        ConfigClass tmp;
+        return GetActorPhysics(a_handle, tmp);
+    }
+
+    const configComponents_t& IConfig::GetActorPhysics(Game::ObjectHandle a_handle, ConfigClass& a_class)
     {
         auto ita = actorConfHolder.find(a_handle);
-        if (ita != actorConfHolder.end())
-            return ita->second;
+        if (ita == actorConfHolder.end())
+            return GetActorPhysicsParent(a_handle, a_class);
 
-        auto ac = IData::GetActorRefInfo(a_handle);
-        if (ac)
-        {
-            if (ac->race.first) {
-                auto itr = raceConfHolder.find(ac->race.second);
-                if (itr != raceConfHolder.end())
-                    return (actorConfHolder[a_handle] = itr->second);
-            }
+        a_class = ConfigClass::kConfigActor;
 
-            auto profile = ITemplate::GetProfile<PhysicsProfile>(ac);
-            if (profile)
-                return (actorConfHolder[a_handle] = profile->Data());
+        ConfigClass pcl;
+        uint64_t parentVersion;
+        auto& parent = GetActorPhysicsParent(a_handle, pcl, parentVersion);
+
+        auto version = actorPhysicsVersion.Get(a_handle);
 
+        auto& e = resolvedActorConf;
+
+        if (e.handle != a_handle ||
+            e.parent != std::addressof(parent) ||
+            e.parentVersion != parentVersion ||
+            e.version != version)
+        {
+            e.handle = a_handle;
+            e.parent = std::addressof(parent);
+            e.parentVersion = parentVersion;
+            e.version = version;
+            e.conf = parent;
+
+            for (const auto& g : ita->second)
+                e.conf.insert_or_assign(g.first, g.second);
         }
 
-        return (actorConfHolder[a_handle] = physicsGlobalConfig);
+        return e.conf;
     }
 
-    const configComponents_t& IConfig::GetActorPhysics(Game::ObjectHandle a_handle)
+    const configComponent32_t* IConfig::GetActorPhysics(Game::ObjectHandle a_handle, const std::string& a_group)
     {
         auto ita = actorConfHolder.find(a_handle);
         if (ita != actorConfHolder.end())
-            return ita->second;
+        {
+            auto it = ita->second.find(a_group);
+            if (it != ita->second.end())
+                return std::addressof(it->second);
+        }
+
+        ConfigClass tmp;
+        auto& parent = GetActorPhysicsParent(a_handle, tmp);
 
+        auto it = parent.find(a_group);
+        if (it != parent.end())
+            return std::addressof(it->second);
+
+        return nullptr;
+    }
+
+    const configComponents_t& IConfig::GetActorPhysicsParent(Game::ObjectHandle a_handle, ConfigClass& a_class)
+    {
+        uint64_t tmp;
+        return GetActorPhysicsParent(a_handle, a_class, tmp);
+    }
+
+    const configComponents_t& IConfig::GetActorPhysicsParent(
+        Game::ObjectHandle a_handle,
+        ConfigClass& a_class,
+        uint64_t& a_version)
+    {
         auto ac = IData::GetActorRefInfo(a_handle);
         if (ac)
         {
             if (ac->race.first) {
                 auto itr = raceConfHolder.find(ac->race.second);
                 if (itr != raceConfHolder.end())
+                {
+                    a_class = ConfigClass::kConfigRace;
+                    a_version = racePhysicsVersion.Get(itr->first);
                     return itr->second;
+                }
             }
 
             auto profile = ITemplate::GetProfile<PhysicsProfile>(ac);
             if (profile)
+            {
+                a_class = ConfigClass::kConfigTemplate;
+                a_version = templatePhysicsVersion;
                 return profile->Data();
+            }
         }
 
+        a_class = ConfigClass::kConfigGlobal;
+        a_version = globalPhysicsVersion;
         return physicsGlobalConfig;
     }
 
-    const configComponents_t& IConfig::GetActorPhysicsAO(Game::ObjectHandle handle)
+    const configComponentsCompiled_t& IConfig::GetActorPhysicsAO(Game::ObjectHandle handle)
     {
-        auto& conf = GetActorPhysics(handle);
+        ConfigClass cl;
+        uint64_t parentVersion;
+        auto& parent = GetActorPhysicsParent(handle, cl, parentVersion);
+
+        auto ita = actorConfHolder.find(handle);
+        auto delta = ita != actorConfHolder.end() ? std::addressof(ita->second) : nullptr;
 
         auto it = armorOverrides.find(handle);
-        if (it == armorOverrides.end())
-            return conf;
+        auto overrides = it != armorOverrides.end() ? std::addressof(it->second) : nullptr;
+
+        auto baseVersion = actorPhysicsVersion.Get(handle);
+        auto overrideVersion = armorOverrideVersion.Get(handle);
 
-        auto& me = (mergedConfCache[handle] = conf);
+        auto& entry = mergedConfCache[handle];
 
-        for (const auto& components : it->second.second)
+        // storage and all contributing layers unchanged since the last merge
+        if (entry.base == delta &&
+            entry.parent == std::addressof(parent) &&
+            entry.overrides == overrides &&
+            entry.baseVersion == baseVersion &&
+            entry.parentVersion == parentVersion &&
+            entry.overrideVersion == overrideVersion)
         {
-            auto itc = me.find(components.first);
-            if (itc == me.end())
+            mergedCacheStats.hits++;
+            return entry.conf;
+        }
+
+        mergedCacheStats.rebuilds++;
+
+        entry.base = delta;
+        entry.parent = std::addressof(parent);
+        entry.overrides = overrides;
+        entry.baseVersion = baseVersion;
+        entry.parentVersion = parentVersion;
+        entry.overrideVersion = overrideVersion;
+
+        auto& me = entry.conf;
+
+        // only the actor's own groups and those touched by overrides are copied
+        me.Reset(std::addressof(GetCompiledLayer(parent, parentVersion)));
+
+        if (delta)
+            me.Overlay(*delta);
+
+        if (!overrides)
+            return me;
+
+        for (const auto& e : overrides->ops)
+        {
+            auto c = me.Override(e.group);
+            if (!c)
                 continue;
 
-            for (const auto& values : components.second) {
-                switch (values.second.first)
-                {
-                case 0:
-                    itc->second.Set(values.first, values.second.second);
-                    break;
-                case 1:
-                    itc->second.Mul(values.first, values.second.second);
-                    break;
-                }
+            auto v = reinterpret_cast<float*>(reinterpret_cast<uintptr_t>(c) + e.offset);
+
+            switch (e.op)
+            {
+            case ArmorOverrideOp::Set:
+                *v = e.value;
+                break;
+            case ArmorOverrideOp::Mul:
+                *v *= e.value;
+                break;
             }
         }
 
         return me;
     }
 
+    const configComponentsCompiled_t& IConfig::GetCompiledLayer(
+        const configComponents_t& a_layer,
+        uint64_t a_version)
+    {
+        auto r = compiledLayerCache.try_emplace(std::addressof(a_layer));
+        auto& e = r.first->second;
+
+        if (r.second || e.version != a_version)
+        {
+            e.version = a_version;
+            e.conf.Compile(a_layer);
+        }
+
+        return e.conf;
+    }
+
     configComponents_t& IConfig::GetOrCreateRacePhysics(Game::FormID a_formid)
     {
+        racePhysicsVersion.Bump(a_formid);
+
         auto it = raceConfHolder.find(a_formid);
         if (it != raceConfHolder.end()) {
             return it->second;
@@ -440,11 +646,13 @@ namespace CBP
 
     void IConfig::SetRacePhysics(Game::FormID a_handle, const configComponents_t& a_conf)
     {
+        racePhysicsVersion.Bump(a_handle);
         raceConfHolder.insert_or_assign(a_handle, a_conf);
     }
 
     void IConfig::SetRacePhysics(Game::FormID a_handle, configComponents_t&& a_conf)
     {
+        racePhysicsVersion.Bump(a_handle);
         raceConfHolder.insert_or_assign(a_handle, std::move(a_conf));
     }
 
@@ -472,6 +680,66 @@ namespace CBP
         CopyImpl(a_lhs, a_rhs);*/
     }
 
+    void configComponentsCompiled_t::Compile(const configComponents_t& a_in)
+    {
+        Reset();
+        Overlay(a_in);
+    }
+
+    void configComponentsCompiled_t::Reset(const configComponentsCompiled_t* a_parent)
+    {
+        m_parent = a_parent;
+        m_data.clear();
+        std::fill(m_slots.begin(), m_slots.end(), uint32_t(0));
+    }
+
+    void configComponentsCompiled_t::Overlay(const configComponents_t& a_in)
+    {
+        for (const auto& e : a_in)
+        {
+            auto id = IConfig::GetConfigGroupId(e.first);
+            if (id == INVALID_CONFIG_GROUP_ID)
+                continue;
+
+            Emplace(id) = e.second;
+        }
+    }
+
+    configComponent32_t* configComponentsCompiled_t::Override(configGroupId_t a_id)
+    {
+        if (a_id < m_slots.size() && m_slots[a_id])
+            return std::addressof(m_data[m_slots[a_id] - 1]);
+
+        auto p = m_parent ? m_parent->Get(a_id) : nullptr;
+        if (!p)
+            return nullptr;
+
+        auto& r = Emplace(a_id);
+        r = *p;
+
+        return std::addressof(r);
+    }
+
+    configComponent32_t& configComponentsCompiled_t::Emplace(configGroupId_t a_id)
+    {
+        if (a_id >= m_slots.size())
+            m_slots.resize(a_id + 1, uint32_t(0));
+
+        auto& slot = m_slots[a_id];
+        if (!slot)
+        {
+            m_data.emplace_back();
+            slot = static_cast<uint32_t>(m_data.size());
+        }
+
+        return m_data[slot - 1];
+    }
+
+    const configComponent32_t* configComponentsCompiled_t::Get(const std::string& a_group) const
+    {
+        return Get(IConfig::GetConfigGroupId(a_group));
+    }
+
     template <typename T>
     void IConfig::CopyImpl(const T& a_lhs, T& a_rhs)
     {
@@ -488,8 +756,8 @@ namespace CBP
         if (!entry)
             return nullptr;
 
-        auto its = entry->second.find(a_sk);
-        if (its != entry->second.end())
+        auto its = entry->entries.find(a_sk);
+        if (its != entry->entries.end())
             return std::addressof(its->second);
 
         return nullptr;
@@ -539,13 +807,168 @@ namespace CBP
         return n;
     }
 
+    std::size_t IConfig::CompactActorPhysics()
+    {
+        auto before = GetActorPhysicsStats();
+
+        std::size_t n(0);
+
+        for (auto& e : actorConfHolder)
+        {
+            // parent can't be resolved reliably until the actor is cached
+            if (!IData::GetActorRefInfo(e.first))
+                continue;
+
+            ConfigClass tmp;
+            auto& parent = GetActorPhysicsParent(e.first, tmp);
+
+            std::size_t c(0);
+
+            auto it = e.second.begin();
+            while (it != e.second.end())
+            {
+                auto itp = parent.find(it->first);
+                if (itp != parent.end() && it->second.Equals(itp->second))
+                {
+                    it = e.second.erase(it);
+                    c++;
+                }
+                else
+                    ++it;
+            }
+
+            if (c)
+            {
+                actorPhysicsVersion.Bump(e.first);
+                n += c;
+            }
+        }
+
+        if (n)
+        {
+            auto after = GetActorPhysicsStats();
+
+            log.Debug("%s: %zu actor(s), %zu -> %zu group(s), %zu -> %zu kb",
+                __FUNCTION__, after.actors, before.groups, after.groups,
+                before.bytes / 1024, after.bytes / 1024);
+        }
+
+        return n;
+    }
+
+    auto IConfig::GetActorPhysicsStats() -> actorPhysicsStats_t
+    {
+        actorPhysicsStats_t r{ actorConfHolder.size(), 0, 0 };
+
+        for (const auto& e : actorConfHolder)
+        {
+            r.groups += e.second.size();
+
+            for (const auto& g : e.second)
+                r.bytes += sizeof(g) + g.first.capacity() + g.second.ex.colMesh.capacity();
+        }
+
+        r.bytes += r.actors * sizeof(actorConfigComponentsHolder_t::value_type);
+
+        return r;
+    }
+
+    void IConfig::MarkPruneDirty(Game::ObjectHandle a_handle)
+    {
+        auto& e = pruneDirty.actors[a_handle];
+
+        e.all = true;
+        e.groups.clear();
+    }
+
+    void IConfig::MarkPruneDirty(Game::ObjectHandle a_handle, const std::string& a_group)
+    {
+        auto& e = pruneDirty.actors[a_handle];
+        if (!e.all)
+            e.groups.emplace(a_group);
+    }
+
+    void IConfig::MarkPruneDirtyNode(Game::ObjectHandle a_handle, const std::string& a_node)
+    {
+        auto it = nodeMap.find(a_node);
+        if (it != nodeMap.end())
+            MarkPruneDirty(a_handle, it->second);
+        else
+            MarkPruneDirty(a_handle);
+    }
+
+    size_t IConfig::PruneDirty()
+    {
+        if (pruneDirty.all)
+            return PruneAll();
+
+        if (pruneDirty.actors.empty())
+            return 0;
+
+        size_t n(0);
+
+        auto& cgmap = GetConfigGroupMap();
+
+        for (const auto& e : pruneDirty.actors)
+        {
+            auto ita = actorConfHolder.find(e.first);
+            if (ita == actorConfHolder.end())
+                continue;
+
+            auto& nodeConf = GetActorNode(e.first);
+
+            std::size_t c(0);
+
+            if (e.second.all)
+                c = PruneComponent(nodeConf, ita->second);
+            else
+            {
+                for (const auto& g : e.second.groups)
+                {
+                    auto itc = ita->second.find(g);
+                    if (itc == ita->second.end())
+                        continue;
+
+                    auto itg = cgmap.find(g);
+                    if (itg != cgmap.end() && HasEnabledNodeConfig(nodeConf, *itg))
+                        continue;
+
+                    ita->second.erase(itc);
+                    c++;
+                }
+            }
+
+            if (c)
+            {
+                actorPhysicsVersion.Bump(e.first);
+                n += c;
+            }
+        }
+
+        pruneDirty.actors.clear();
+
+        return n;
+    }
+
     size_t IConfig::PruneAll()
     {
         size_t n;
 
+        ClearPruneDirty();
+
         n = PruneInactivePhysics();
         n += PruneInactiveRace();
-        n += PruneComponent(GetGlobalNode(), GetGlobalPhysics());
+        n += PruneGlobalPhysics();
+
+        return n;
+    }
+
+    size_t IConfig::PruneGlobalPhysics()
+    {
+        auto n = PruneComponent(GetGlobalNode(), physicsGlobalConfig);
+
+        if (n)
+            BumpPhysicsVersion(ConfigClass::kConfigGlobal);
 
         return n;
     }
@@ -555,17 +978,20 @@ namespace CBP
         size_t n(0);
 
         if (a_handle == Game::ObjectHandle(0))
-            n += PruneComponent(GetGlobalNode(), GetGlobalPhysics());
+            n += PruneGlobalPhysics();
         else
         {
-            auto& data = GetActorPhysicsHolder();
-
-            auto it = data.find(a_handle);
-            if (it != data.end())
+            auto it = actorConfHolder.find(a_handle);
+            if (it != actorConfHolder.end())
             {
                 auto& nodeConf = GetActorNode(a_handle);
                 n += PruneComponent(nodeConf, it->second);
+
+                if (n)
+                    actorPhysicsVersion.Bump(a_handle);
             }
+
+            pruneDirty.actors.erase(a_handle);
         }
 
         return n;
@@ -575,12 +1001,16 @@ namespace CBP
     {
         size_t n(0);
 
-        auto& data = GetActorPhysicsHolder();
-
-        for (auto& e : data)
+        for (auto& e : actorConfHolder)
         {
             auto& nodeConf = GetActorNode(e.first);
-            n += PruneComponent(nodeConf, e.second);
+
+            auto c = PruneComponent(nodeConf, e.second);
+            if (c)
+            {
+                actorPhysicsVersion.Bump(e.first);
+                n += c;
+            }
         }
 
         return n;
@@ -590,12 +1020,16 @@ namespace CBP
     {
         size_t n(0);
 
-        auto& data = GetRacePhysicsHolder();
-
-        for (auto& e : data)
+        for (auto& e : raceConfHolder)
         {
             auto& nodeConf = GetRaceNode(e.first);
-            n += PruneComponent(nodeConf, e.second);
+
+            auto c = PruneComponent(nodeConf, e.second);
+            if (c)
+            {
+                racePhysicsVersion.Bump(e.first);
+                n += c;
+            }
         }
 
         return n;
@@ -99,6 +99,7 @@ namespace CBP
             bool femaleOnly = true;
             bool armorOverrides = true;
             bool controllerStats = false;
+            bool autoPrune = false;
         } general;
 
         struct
@@ -266,6 +267,13 @@ namespace CBP
     typedef iKVStorage<std::string, const componentValueDesc_t> componentValueDescMap_t;
     typedef KVStorage<ColliderShapeType, const colliderDesc_t> colliderDescMap_t;
 
+    // interned value keys (index into descMap) and config group names
+    typedef uint32_t configValueId_t;
+    typedef uint32_t configGroupId_t;
+
+    constexpr configValueId_t INVALID_CONFIG_VALUE_ID = std::numeric_limits<configValueId_t>::max();
+    constexpr configGroupId_t INVALID_CONFIG_GROUP_ID = std::numeric_limits<configGroupId_t>::max();
+
     struct physicsDataF32_t
     {
         float stiffness;
@@ -664,6 +672,35 @@ namespace CBP
             return *reinterpret_cast<float*>(addr);
         }
 
+        [[nodiscard]] SKMP_FORCEINLINE static configValueId_t GetValueId(const std::string& a_key)
+        {
+            auto it = valueIdMap.find(a_key);
+            if (it != valueIdMap.end())
+                return it->second;
+
+            return INVALID_CONFIG_VALUE_ID;
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE static const componentValueDesc_t& GetValueDesc(configValueId_t a_id) {
+            return descMap.getvec()[a_id].second;
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE float Get(configValueId_t a_id) const
+        {
+            auto addr = reinterpret_cast<uintptr_t>(this) + GetValueDesc(a_id).offset;
+            return *reinterpret_cast<const float*>(addr);
+        }
+
+        SKMP_FORCEINLINE void Set(configValueId_t a_id, float a_value)
+        {
+            Set(GetValueDesc(a_id), a_value);
+        }
+
+        SKMP_FORCEINLINE void Mul(configValueId_t a_id, float a_multiplier)
+        {
+            *GetAddress(GetValueDesc(a_id)) *= a_multiplier;
+        }
+
         SKMP_FORCEINLINE void SetColShape(ColliderShapeType a_shape) {
             ex.colShape = a_shape;
         }
@@ -676,10 +713,18 @@ namespace CBP
 
         configComponent32_t() = default;
 
+        [[nodiscard]] SKMP_FORCEINLINE bool Equals(const configComponent32_t& a_rhs) const
+        {
+            return std::memcmp(std::addressof(fp), std::addressof(a_rhs.fp), sizeof(fp)) == 0 &&
+                ex.colShape == a_rhs.ex.colShape &&
+                ex.colMesh == a_rhs.ex.colMesh;
+        }
+
         physicsData32_t fp;
         physicsDataExtra_t ex;
 
         static const componentValueDescMap_t descMap;
+        static const stl::iunordered_map<std::string, configValueId_t> valueIdMap;
         static const colliderDescMap_t colDescMap;
         static const stl::iunordered_map<std::string, std::string> oldKeyMap;
 
@@ -876,10 +921,77 @@ namespace CBP
     typedef stl::set<uint64_t> collisionGroups_t;
     typedef stl::imap<std::string, uint64_t> nodeCollisionGroupMap_t;
 
-    typedef std::pair<stl::iset<std::string>, armorCacheEntry_t> armorOverrideDescriptor_t;
+    static_assert(std::is_same_v<configGroupId_t, decltype(armorOverrideOp_t::group)>);
+
+    struct armorOverrideDescriptor_t
+    {
+        stl::iset<std::string> paths;
+        armorCacheEntry_t entries;  // merged source data, for the UI
+        armorOverrideOps_t ops;
+    };
+
     typedef stl::unordered_map<Game::ObjectHandle, armorOverrideDescriptor_t> armorOverrides_t;
 
-    typedef stl::unordered_map<Game::ObjectHandle, configComponents_t> mergedConfCache_t;
+    // Resolved physics config indexed by interned group id. Only holds the
+    // groups set on it, lookups fall through to the parent for the rest.
+    class configComponentsCompiled_t
+    {
+    public:
+
+        void Compile(const configComponents_t& a_in);
+        void Reset(const configComponentsCompiled_t* a_parent = nullptr);
+        void Overlay(const configComponents_t& a_in);
+
+        // copies the group from the parent on first write
+        [[nodiscard]] configComponent32_t* Override(configGroupId_t a_id);
+
+        [[nodiscard]] SKMP_FORCEINLINE const configComponent32_t* Get(configGroupId_t a_id) const noexcept
+        {
+            if (a_id < m_slots.size() && m_slots[a_id])
+                return std::addressof(m_data[m_slots[a_id] - 1]);
+
+            return m_parent ? m_parent->Get(a_id) : nullptr;
+        }
+
+        [[nodiscard]] const configComponent32_t* Get(const std::string& a_group) const;
+
+        SKMP_FORCEINLINE void Clear() noexcept
+        {
+            m_parent = nullptr;
+            m_data.clear();
+            m_slots.clear();
+        }
+
+    private:
+        configComponent32_t& Emplace(configGroupId_t a_id);
+
+        const configComponentsCompiled_t* m_parent{ nullptr };
+        stl::vector<configComponent32_t> m_data;
+        // group id -> index into m_data + 1, 0 if not held
+        stl::vector<uint32_t> m_slots;
+    };
+
+    struct mergedConfCacheEntry_t
+    {
+        const configComponents_t* base{ nullptr };
+        const configComponents_t* parent{ nullptr };
+        const armorOverrideDescriptor_t* overrides{ nullptr };
+        uint64_t baseVersion{ 0 };
+        uint64_t parentVersion{ 0 };
+        uint64_t overrideVersion{ 0 };
+        configComponentsCompiled_t conf;
+    };
+
+    typedef stl::unordered_map<Game::ObjectHandle, mergedConfCacheEntry_t> mergedConfCache_t;
+
+    // parent layers compiled once and shared by the actors resolving to them
+    struct compiledLayerEntry_t
+    {
+        uint64_t version{ 0 };
+        configComponentsCompiled_t conf;
+    };
+
+    typedef stl::unordered_map<const configComponents_t*, compiledLayerEntry_t> compiledLayerCache_t;
 
     struct SKMP_ALIGN(32) nodeDataF32_t
     {
@@ -1252,20 +1364,50 @@ namespace CBP
     public:
         typedef stl::iunordered_set<std::string> vKey_t;
 
+        struct mergedCacheStats_t
+        {
+            uint64_t hits{ 0 };
+            uint64_t rebuilds{ 0 };
+        };
+
+        struct actorPhysicsStats_t
+        {
+            std::size_t actors;
+            std::size_t groups;
+            std::size_t bytes;
+        };
+
         static void Initialize();
 
         [[nodiscard]] static ConfigClass GetActorPhysicsClass(Game::ObjectHandle a_handle);
         [[nodiscard]] static ConfigClass GetActorNodeClass(Game::ObjectHandle a_handle);
 
-        // Not guaranteed to be actual actor conf storage
+        // Not guaranteed to be actual actor conf storage. Actor entries only hold
+        // the groups that were changed, the rest is resolved from the parent layer.
+        // Only the last resolved actor is kept, copy the result if it's needed
+        // past the next call.
         [[nodiscard]] static const configComponents_t& GetActorPhysics(Game::ObjectHandle handle);
+        [[nodiscard]] static const configComponents_t& GetActorPhysics(Game::ObjectHandle handle, ConfigClass& a_class);
+
+        // resolves a single group without building the full view
+        [[nodiscard]] static const configComponent32_t* GetActorPhysics(Game::ObjectHandle handle, const std::string& a_group);
+        [[nodiscard]] static const configComponents_t& GetActorPhysicsParent(Game::ObjectHandle handle, ConfigClass& a_class);
 
-        [[nodiscard]] static const configComponents_t& GetActorPhysicsAO(Game::ObjectHandle handle);
-        [[nodiscard]] static configComponents_t& GetOrCreateActorPhysics(Game::ObjectHandle handle);
+        [[nodiscard]] static const configComponentsCompiled_t& GetActorPhysicsAO(Game::ObjectHandle handle);
+
+        // copies only the requested group from the parent layer on first write
+        static configComponent32_t& GetOrCreateActorPhysics(Game::ObjectHandle handle, const std::string& a_group);
+        [[nodiscard]] static configComponents_t& GetActorPhysicsDelta(Game::ObjectHandle handle);
+
+        // Drops actor groups identical to the parent layer, those follow later
+        // edits to the parent afterwards. Only run on request.
+        static std::size_t CompactActorPhysics();
+        [[nodiscard]] static actorPhysicsStats_t GetActorPhysicsStats();
         static void SetActorPhysics(Game::ObjectHandle a_handle, const configComponents_t& a_conf);
         static void SetActorPhysics(Game::ObjectHandle a_handle, configComponents_t&& a_conf);
 
-        SKMP_FORCEINLINE static decltype(auto) EraseActorPhysics(Game::ObjectHandle handle) noexcept {
+        SKMP_FORCEINLINE static decltype(auto) EraseActorPhysics(Game::ObjectHandle handle) {
+            actorPhysicsVersion.Bump(handle);
             return actorConfHolder.erase(handle);
         }
 
@@ -1275,55 +1417,75 @@ namespace CBP
         [[nodiscard]] static configComponents_t& GetOrCreateRacePhysics(Game::FormID a_formid);
         static void SetRacePhysics(Game::FormID a_formid, const configComponents_t& a_conf);
         static void SetRacePhysics(Game::FormID a_formid, configComponents_t&& a_conf);
-        SKMP_FORCEINLINE static decltype(auto) EraseRacePhysics(Game::FormID handle) noexcept {
+        SKMP_FORCEINLINE static decltype(auto) EraseRacePhysics(Game::FormID handle) {
+            racePhysicsVersion.Bump(handle);
             return raceConfHolder.erase(handle);
         }
 
-        [[nodiscard]] SKMP_FORCEINLINE static auto& GetGlobalPhysics() noexcept {
+        [[nodiscard]] SKMP_FORCEINLINE static const auto& GetGlobalPhysics() noexcept {
+            return physicsGlobalConfig;
+        }
+
+        // for writes only, counts as a modification of the layer
+        [[nodiscard]] SKMP_FORCEINLINE static auto& ModifyGlobalPhysics() noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigGlobal);
             return physicsGlobalConfig;
         }
 
         SKMP_FORCEINLINE static void SetGlobalPhysics(const configComponents_t& a_rhs) noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigGlobal);
             physicsGlobalConfig = a_rhs;
         }
 
         SKMP_FORCEINLINE static void SetGlobalPhysics(configComponents_t&& a_rhs) noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigGlobal);
             physicsGlobalConfig = std::move(a_rhs);
         }
 
-        [[nodiscard]] SKMP_FORCEINLINE static auto& GetActorPhysicsHolder() noexcept {
+        [[nodiscard]] SKMP_FORCEINLINE static const auto& GetActorPhysicsHolder() noexcept {
             return actorConfHolder;
         }
 
         SKMP_FORCEINLINE static void SetActorPhysicsConfigHolder(actorConfigComponentsHolder_t&& a_rhs) noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigActor);
             actorConfHolder = std::move(a_rhs);
+            MarkPruneDirtyAll();
         }
 
-        [[nodiscard]] SKMP_FORCEINLINE static auto& GetRacePhysicsHolder() noexcept {
+        [[nodiscard]] SKMP_FORCEINLINE static const auto& GetRacePhysicsHolder() noexcept {
             return raceConfHolder;
         }
 
         SKMP_FORCEINLINE static void SetRacePhysicsHolder(raceConfigComponentsHolder_t&& a_rhs) noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigRace);
             raceConfHolder = std::move(a_rhs);
+            MarkPruneDirtyAll();
         }
 
         SKMP_FORCEINLINE static void SetRaceNodeHolder(raceConfigNodesHolder_t&& a_rhs) noexcept {
             raceNodeConfigHolder = std::move(a_rhs);
+            MarkPruneDirtyAll();
         }
 
         SKMP_FORCEINLINE static void ClearActorPhysicsHolder() noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigActor);
             actorConfHolder.clear();
+            resolvedActorConf.conf.clear();
         }
         
         SKMP_FORCEINLINE static void ReleaseActorPhysicsHolder() noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigActor);
             actorConfHolder.swap(decltype(actorConfHolder)());
+            resolvedActorConf = resolvedActorConf_t();
         }
 
         SKMP_FORCEINLINE static void ClearRacePhysicsHolder() noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigRace);
             raceConfHolder.clear();
         }
         
         SKMP_FORCEINLINE static void ReleaseRacePhysicsHolder() noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigRace);
             raceConfHolder.swap(decltype(raceConfHolder)());
         }
 
@@ -1344,6 +1506,7 @@ namespace CBP
         }
 
         SKMP_FORCEINLINE static void ClearGlobalPhysics() noexcept {
+            BumpPhysicsVersion(ConfigClass::kConfigGlobal);
             physicsGlobalConfig.clear();
         }
 
@@ -1359,6 +1522,25 @@ namespace CBP
             return validConfGroups.contains(a_key);
         }
 
+        [[nodiscard]] SKMP_FORCEINLINE static bool IsValidGroup(configGroupId_t a_id) noexcept {
+            return a_id < validGroupIds.size() && validGroupIds[a_id];
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE static configGroupId_t GetConfigGroupId(const std::string& a_group)
+        {
+            auto it = configGroupIdMap.find(a_group);
+            if (it != configGroupIdMap.end())
+                return it->second;
+
+            return INVALID_CONFIG_GROUP_ID;
+        }
+
+        static configGroupId_t InternConfigGroup(const std::string& a_group);
+
+        [[nodiscard]] SKMP_FORCEINLINE static const auto& GetConfigGroupName(configGroupId_t a_id) {
+            return configGroupNames[a_id];
+        }
+
         [[nodiscard]] SKMP_FORCEINLINE static const auto& GetConfigGroups() noexcept {
             return validConfGroups;
         }
@@ -1410,10 +1592,12 @@ namespace CBP
 
         SKMP_FORCEINLINE static void SetGlobalNode(const configNodes_t& a_rhs) noexcept {
             nodeGlobalConfig = a_rhs;
+            MarkPruneDirtyAll();
         }
 
         SKMP_FORCEINLINE static void SetGlobalNode(configNodes_t&& a_rhs) noexcept {
             nodeGlobalConfig = std::move(a_rhs);
+            MarkPruneDirtyAll();
         }
 
         SKMP_FORCEINLINE static void ClearGlobalNode() noexcept {
@@ -1432,6 +1616,7 @@ namespace CBP
 
         SKMP_FORCEINLINE static void SetActorNodeHolder(actorConfigNodesHolder_t&& a_rhs) {
             actorNodeConfigHolder = std::move(a_rhs);
+            MarkPruneDirtyAll();
         }
 
         static const configNodes_t& GetActorNode(Game::ObjectHandle a_handle);
@@ -1444,12 +1629,14 @@ namespace CBP
         static void SetRaceNode(Game::FormID a_handle, const configNodes_t& a_conf);
         static void SetRaceNode(Game::FormID a_handle, configNodes_t&& a_conf);
 
-        SKMP_FORCEINLINE static void EraseActorNode(Game::ObjectHandle a_formid) noexcept {
+        SKMP_FORCEINLINE static void EraseActorNode(Game::ObjectHandle a_formid) {
             actorNodeConfigHolder.erase(a_formid);
+            MarkPruneDirty(a_formid);
         }
 
         SKMP_FORCEINLINE static void EraseRaceNode(Game::FormID a_formid) noexcept {
             raceNodeConfigHolder.erase(a_formid);
+            MarkPruneDirtyAll();
         }
 
         SKMP_FORCEINLINE static void ClearActorNodeHolder() noexcept {
@@ -1493,15 +1680,17 @@ namespace CBP
 
         static void SetArmorOverride(Game::ObjectHandle a_handle, const armorOverrideDescriptor_t& a_entry)
         {
+            armorOverrideVersion.Bump(a_handle);
             armorOverrides.insert_or_assign(a_handle, a_entry);
         }
 
         static void SetArmorOverride(Game::ObjectHandle a_handle, armorOverrideDescriptor_t&& a_entry)
         {
+            armorOverrideVersion.Bump(a_handle);
             armorOverrides.insert_or_assign(a_handle, std::move(a_entry));
         }
 
-        [[nodiscard]] static armorOverrideDescriptor_t* GetArmorOverrides(Game::ObjectHandle a_handle)
+        [[nodiscard]] static const armorOverrideDescriptor_t* GetArmorOverrides(Game::ObjectHandle a_handle)
         {
             auto it = armorOverrides.find(a_handle);
             if (it != armorOverrides.end())
@@ -1510,15 +1699,35 @@ namespace CBP
             return nullptr;
         }
 
-        SKMP_FORCEINLINE static bool RemoveArmorOverride(Game::ObjectHandle a_handle) noexcept {
-            return armorOverrides.erase(a_handle) == armorOverrides_t::size_type(1);
+        // for writes only, counts as a modification of the actor's overrides
+        [[nodiscard]] static armorOverrideDescriptor_t* ModifyArmorOverrides(Game::ObjectHandle a_handle)
+        {
+            auto it = armorOverrides.find(a_handle);
+            if (it != armorOverrides.end())
+            {
+                armorOverrideVersion.Bump(a_handle);
+                return std::addressof(it->second);
+            }
+
+            return nullptr;
+        }
+
+        static bool RemoveArmorOverride(Game::ObjectHandle a_handle)
+        {
+            if (armorOverrides.erase(a_handle) != armorOverrides_t::size_type(1))
+                return false;
+
+            armorOverrideVersion.Bump(a_handle);
+            return true;
         }
 
         SKMP_FORCEINLINE static void ClearArmorOverrides() noexcept {
+            armorOverrideVersion.BumpAll();
             armorOverrides.clear();
         }
         
         SKMP_FORCEINLINE static void ReleaseArmorOverrides() noexcept {
+            armorOverrideVersion.BumpAll();
             armorOverrides.swap(decltype(armorOverrides)());
         }
 
@@ -1550,21 +1759,45 @@ namespace CBP
 
         SKMP_FORCEINLINE static void ReleaseMergedCache() noexcept {
             mergedConfCache.swap(decltype(mergedConfCache)());
+            compiledLayerCache.swap(decltype(compiledLayerCache)());
         }
 
         SKMP_FORCEINLINE static void RemoveMergedCacheEntry(Game::ObjectHandle a_handle) noexcept {
             mergedConfCache.erase(a_handle);
         }
 
-        SKMP_FORCEINLINE static void ClearMergedCacheThreshold(mergedConfCache_t::size_type a_threshold = 200) noexcept {
-            if (mergedConfCache.size() > a_threshold)
-                ReleaseMergedCache();
+        // invalidates every entry of the layer
+        static void BumpPhysicsVersion(ConfigClass a_class) noexcept;
+
+        [[nodiscard]] SKMP_FORCEINLINE static const auto& GetMergedCacheStats() noexcept {
+            return mergedCacheStats;
+        }
+
+        SKMP_FORCEINLINE static void ResetMergedCacheStats() noexcept {
+            mergedCacheStats = mergedCacheStats_t();
         }
 
         static size_t PruneAll();
         static size_t PruneActorPhysics(Game::ObjectHandle a_handle);
         static size_t PruneInactivePhysics();
         static size_t PruneInactiveRace();
+        static size_t PruneGlobalPhysics();
+
+        // only revisits what changed since the last prune
+        static size_t PruneDirty();
+
+        static void MarkPruneDirty(Game::ObjectHandle a_handle);
+        static void MarkPruneDirty(Game::ObjectHandle a_handle, const std::string& a_group);
+        static void MarkPruneDirtyNode(Game::ObjectHandle a_handle, const std::string& a_node);
+
+        SKMP_FORCEINLINE static void MarkPruneDirtyAll() noexcept {
+            pruneDirty.all = true;
+        }
+
+        SKMP_FORCEINLINE static void ClearPruneDirty() noexcept {
+            pruneDirty.all = false;
+            pruneDirty.actors.clear();
+        }
 
         SKMP_FORCEINLINE static const auto& GetDefaultPhysics() {
             return defaultPhysicsConfig;
@@ -1589,8 +1822,61 @@ namespace CBP
         template <typename T>
         SKMP_FORCEINLINE static void CopyImpl(const T& a_lhs, T& a_rhs);
 
+        static const configComponents_t& GetActorPhysicsParent(Game::ObjectHandle a_handle, ConfigClass& a_class, uint64_t& a_version);
+        static const configComponentsCompiled_t& GetCompiledLayer(const configComponents_t& a_layer, uint64_t a_version);
+
+        // Per-key modification stamps. Keys that were never bumped share the
+        // epoch, bumping the whole layer moves the epoch past every key.
+        template <class K>
+        class versionStamps_t
+        {
+        public:
+            [[nodiscard]] SKMP_FORCEINLINE uint64_t Get(const K& a_key) const
+            {
+                auto it = m_entries.find(a_key);
+                return it != m_entries.end() ? it->second : m_epoch;
+            }
+
+            SKMP_FORCEINLINE void Bump(const K& a_key) {
+                m_entries.insert_or_assign(a_key, ++layerVersionCounter);
+            }
+
+            SKMP_FORCEINLINE void BumpAll() noexcept
+            {
+                m_epoch = ++layerVersionCounter;
+                m_entries.clear();
+            }
+
+        private:
+            uint64_t m_epoch{ 0 };
+            stl::unordered_map<K, uint64_t> m_entries;
+        };
+
+        struct resolvedActorConf_t
+        {
+            Game::ObjectHandle handle{ 0 };
+            const configComponents_t* parent{ nullptr };
+            uint64_t parentVersion{ 0 };
+            uint64_t version{ 0 };
+            configComponents_t conf;
+        };
+
+        struct pruneDirtyEntry_t
+        {
+            bool all{ false };
+            stl::unordered_set<std::string> groups;
+        };
+
+        struct pruneDirty_t
+        {
+            bool all{ false };
+            stl::unordered_map<Game::ObjectHandle, pruneDirtyEntry_t> actors;
+        };
+
         static configComponents_t physicsGlobalConfig;
         static actorConfigComponentsHolder_t actorConfHolder;
+        static resolvedActorConf_t resolvedActorConf;
+        static pruneDirty_t pruneDirty;
         static raceConfigComponentsHolder_t raceConfHolder;
         static configGlobal_t globalConfig;
         static vKey_t validConfGroups;
@@ -1598,6 +1884,11 @@ namespace CBP
         static nodeMap_t nodeMap;
         static configGroupMap_t configGroupMap;
 
+        // ids are never reused so components holding one stay valid
+        static stl::iunordered_map<std::string, configGroupId_t> configGroupIdMap;
+        static stl::vector<std::string> configGroupNames;
+        static stl::vector<uint8_t> validGroupIds;
+
         static collisionGroups_t collisionGroups;
         static nodeCollisionGroupMap_t nodeCollisionGroupMap;
 
@@ -1607,6 +1898,15 @@ namespace CBP
 
         static armorOverrides_t armorOverrides;
         static mergedConfCache_t mergedConfCache;
+        static compiledLayerCache_t compiledLayerCache;
+        static mergedCacheStats_t mergedCacheStats;
+
+        static uint64_t layerVersionCounter;
+        static uint64_t globalPhysicsVersion;
+        static uint64_t templatePhysicsVersion;
+        static versionStamps_t<Game::FormID> racePhysicsVersion;
+        static versionStamps_t<Game::ObjectHandle> actorPhysicsVersion;
+        static versionStamps_t<Game::ObjectHandle> armorOverrideVersion;
 
         static combinedData_t defaultProfileStorage;
 
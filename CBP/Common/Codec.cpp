@@ -0,0 +1,242 @@
+#include "pch.h"
+
+#include <zstd.h>
+#include <lz4.h>
+
+namespace Codec
+{
+    // don't trust the gzip trailer or a header's rawSize past this when
+    // sizing the output, a corrupt block would otherwise allocate gigabytes
+    static constexpr std::size_t MAX_RESERVE = 1024 * 1024 * 256;
+
+    bool IsAvailable(Type a_type)
+    {
+        switch (a_type)
+        {
+        case Type::Gzip:
+        case Type::Zstd:
+        case Type::LZ4:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    const char* GetName(Type a_type)
+    {
+        switch (a_type)
+        {
+        case Type::Gzip:
+            return "gzip";
+        case Type::Zstd:
+            return "zstd";
+        case Type::LZ4:
+            return "lz4";
+        default:
+            return "unknown";
+        }
+    }
+
+    bool Parse(const std::string& a_name, Type& a_out)
+    {
+        if (_stricmp(a_name.c_str(), "gzip") == 0)
+            a_out = Type::Gzip;
+        else if (_stricmp(a_name.c_str(), "zstd") == 0)
+            a_out = Type::Zstd;
+        else if (_stricmp(a_name.c_str(), "lz4") == 0)
+            a_out = Type::LZ4;
+        else
+            return false;
+
+        return true;
+    }
+
+    bool HasHeader(const char* a_data, std::size_t a_size)
+    {
+        if (a_size < sizeof(header_t))
+            return false;
+
+        std::uint32_t magic;
+        std::memcpy(std::addressof(magic), a_data, sizeof(magic));
+
+        return magic == HEADER_MAGIC;
+    }
+
+    static void GzipEncode(int a_level, const char* a_data, std::size_t a_size, stl::vector<char>& a_out)
+    {
+        using namespace boost::iostreams;
+
+        filtering_streambuf<input> in;
+        in.push(gzip_compressor(gzip_params(a_level), 1024 * 64));
+        in.push(array_source(a_data, a_size));
+        copy(in, boost::iostreams::back_inserter(a_out), 1024 * 64);
+    }
+
+    static void GzipDecode(const char* a_data, std::size_t a_size, stl::vector<char>& a_out)
+    {
+        // trailer holds the inflated size (mod 2^32)
+        if (a_size >= 18)
+        {
+            std::uint32_t isize;
+            std::memcpy(std::addressof(isize), a_data + a_size - sizeof(isize), sizeof(isize));
+
+            if (isize <= MAX_RESERVE)
+                a_out.reserve(isize);
+        }
+
+        using namespace boost::iostreams;
+
+        filtering_streambuf<input> in;
+        in.push(gzip_decompressor(zlib::default_window_bits, 1024 * 64));
+        in.push(array_source(a_data, a_size));
+        copy(in, boost::iostreams::back_inserter(a_out), 1024 * 64);
+    }
+
+    void Encode(Type a_type, int a_level, const char* a_data, std::size_t a_size, stl::vector<char>& a_out)
+    {
+        a_out.clear();
+
+        if (a_type == Type::Gzip)
+        {
+            GzipEncode(a_level, a_data, a_size, a_out);
+            return;
+        }
+
+        // Decode refuses anything larger
+        if (a_size > MAX_RESERVE)
+            throw std::exception("Input too large");
+
+        header_t header{ HEADER_MAGIC, HEADER_VERSION, static_cast<std::uint8_t>(a_type), 0, a_size };
+
+        std::size_t bound;
+
+        switch (a_type)
+        {
+        case Type::Zstd:
+            bound = ZSTD_compressBound(a_size);
+            break;
+        case Type::LZ4:
+            if (a_size > LZ4_MAX_INPUT_SIZE)
+                throw std::exception("lz4: input too large");
+            bound = static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(a_size)));
+            break;
+        default:
+            throw std::exception("Codec not available");
+        }
+
+        a_out.resize(sizeof(header) + bound);
+        std::memcpy(a_out.data(), std::addressof(header), sizeof(header));
+
+        auto dst = a_out.data() + sizeof(header);
+        std::size_t length;
+
+        switch (a_type)
+        {
+        case Type::Zstd:
+        {
+            auto r = ZSTD_compress(dst, bound, a_data, a_size,
+                std::clamp(a_level, 1, ZSTD_maxCLevel()));
+
+            if (ZSTD_isError(r))
+                throw std::exception(ZSTD_getErrorName(r));
+
+            length = r;
+        }
+        break;
+        case Type::LZ4:
+        {
+            auto r = LZ4_compress_default(a_data, dst,
+                static_cast<int>(a_size), static_cast<int>(bound));
+
+            if (r <= 0)
+                throw std::exception("lz4: compression failed");
+
+            length = static_cast<std::size_t>(r);
+        }
+        break;
+        default:
+            throw std::exception("Codec not available");
+        }
+
+        a_out.resize(sizeof(header) + length);
+    }
+
+    void Decode(const char* a_data, std::size_t a_size, stl::vector<char>& a_out, Type* a_type)
+    {
+        a_out.clear();
+
+        if (!HasHeader(a_data, a_size))
+        {
+            if (a_type)
+                *a_type = Type::Gzip;
+
+            GzipDecode(a_data, a_size, a_out);
+            return;
+        }
+
+        header_t header;
+        std::memcpy(std::addressof(header), a_data, sizeof(header));
+
+        if (header.version != HEADER_VERSION)
+            throw std::exception("Unsupported codec header version");
+
+        auto type = static_cast<Type>(header.type);
+
+        if (a_type)
+            *a_type = type;
+
+        if (!IsAvailable(type))
+            throw std::exception("Codec not available");
+
+        if (header.rawSize > MAX_RESERVE)
+            throw std::exception("Block too large");
+
+        auto src = a_data + sizeof(header);
+        auto srcSize = a_size - sizeof(header);
+
+        switch (type)
+        {
+        case Type::Zstd:
+        {
+            // the frame records its own size, both have to agree
+            auto frameSize = ZSTD_getFrameContentSize(src, srcSize);
+
+            if (frameSize == ZSTD_CONTENTSIZE_ERROR)
+                throw std::exception("zstd: bad frame");
+
+            if (frameSize != ZSTD_CONTENTSIZE_UNKNOWN &&
+                frameSize != header.rawSize)
+            {
+                throw std::exception("zstd: size mismatch");
+            }
+
+            a_out.resize(static_cast<std::size_t>(header.rawSize));
+
+            auto r = ZSTD_decompress(a_out.data(), a_out.size(), src, srcSize);
+            if (ZSTD_isError(r))
+                throw std::exception(ZSTD_getErrorName(r));
+
+            if (r != a_out.size())
+                throw std::exception("zstd: size mismatch");
+        }
+        break;
+        case Type::LZ4:
+        {
+            // lz4 can't expand a byte into more than 255
+            if (header.rawSize > static_cast<std::uint64_t>(srcSize) * 255)
+                throw std::exception("lz4: size mismatch");
+
+            a_out.resize(static_cast<std::size_t>(header.rawSize));
+
+            auto r = LZ4_decompress_safe(src, a_out.data(),
+                static_cast<int>(srcSize), static_cast<int>(a_out.size()));
+
+            if (r < 0 || static_cast<std::size_t>(r) != a_out.size())
+                throw std::exception("lz4: decompression failed");
+        }
+        break;
+        default:
+            throw std::exception("Codec not available");
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+namespace Codec
+{
+    enum class Type : std::uint8_t
+    {
+        Gzip = 0,
+        Zstd = 1,
+        LZ4 = 2
+    };
+
+    // Non-gzip blocks start with this header, gzip output is written
+    // without it so older builds can still read it. Data without the
+    // header is always treated as gzip.
+    struct header_t
+    {
+        std::uint32_t magic;
+        std::uint8_t version;
+        std::uint8_t type;
+        std::uint16_t reserved;
+        std::uint64_t rawSize;
+    };
+
+    static_assert(sizeof(header_t) == 16);
+
+    constexpr std::uint32_t HEADER_MAGIC = 'CBPZ';
+    constexpr std::uint8_t HEADER_VERSION = 1;
+
+    // false for type ids this build doesn't know (newer data)
+    [[nodiscard]] bool IsAvailable(Type a_type);
+    [[nodiscard]] const char* GetName(Type a_type);
+    [[nodiscard]] bool Parse(const std::string& a_name, Type& a_out);
+
+    [[nodiscard]] bool HasHeader(const char* a_data, std::size_t a_size);
+
+    // Replaces the contents of a_out, throws on failure
+    void Encode(Type a_type, int a_level, const char* a_data, std::size_t a_size, stl::vector<char>& a_out);
+    void Decode(const char* a_data, std::size_t a_size, stl::vector<char>& a_out, Type* a_type = nullptr);
+}
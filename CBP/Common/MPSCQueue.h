@@ -0,0 +1,216 @@
+#pragma once
+
+// called by Drain between taking its snapshot and reading the ring, lets
+// tests push from inside that window
+#ifndef MPSCQUEUE_DRAIN_HOOK
+#define MPSCQUEUE_DRAIN_HOOK()
+#endif
+
+namespace CBP
+{
+    // Bounded multi-producer/single-consumer ring. Producers claim a slot
+    // with a CAS on the head and publish it through the slot's sequence
+    // number. When the ring is full items spill into a locked overflow
+    // queue, and all producers keep using it until the consumer has drained
+    // both the overflow and every ring slot claimed before it, so that
+    // per-producer ordering is preserved.
+    template <class T, std::size_t _Capacity>
+    class MPSCQueue
+    {
+        static_assert(_Capacity >= 2 && (_Capacity & (_Capacity - 1)) == 0);
+
+        static constexpr std::size_t MASK = _Capacity - 1;
+
+        struct cell_t
+        {
+            std::atomic<std::size_t> seq;
+            T data;
+        };
+
+    public:
+
+        struct stats_t
+        {
+            uint64_t pushed;
+            uint64_t overflowed;
+            std::size_t peakBatch;
+        };
+
+        MPSCQueue() :
+            m_head(0),
+            m_tail(0),
+            m_overflowSize(0),
+            m_stats{ 0, 0, 0 }
+        {
+            for (std::size_t i = 0; i < _Capacity; i++)
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        void Push(T&& a_item)
+        {
+            if (m_overflowSize.load(std::memory_order_acquire) == 0)
+            {
+                if (TryPush(a_item))
+                    return;
+            }
+
+            std::lock_guard<std::mutex> _(m_overflowMutex);
+
+            m_overflow.emplace(std::move(a_item));
+            m_overflowSize.fetch_add(1, std::memory_order_release);
+
+            m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // consumer side only
+        [[nodiscard]] bool Empty() const
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail &&
+                m_overflowSize.load(std::memory_order_acquire) == 0;
+        }
+
+        // consumer side only, appends everything published so far to a_out
+        template <class C>
+        std::size_t Drain(C& a_out)
+        {
+            std::queue<T> overflow;
+            std::size_t head;
+
+            bool spilled = m_overflowSize.load(std::memory_order_acquire) != 0;
+
+            // take the overflow and the head together, anything a producer
+            // pushed to the ring before spilling over has claimed a slot below
+            // head. m_overflowSize stays set so producers keep spilling until
+            // that range and the overflow have been emitted.
+            if (spilled)
+            {
+                std::lock_guard<std::mutex> _(m_overflowMutex);
+
+                m_overflow.swap(overflow);
+                head = m_head.load(std::memory_order_acquire);
+            }
+            else
+                head = m_head.load(std::memory_order_acquire);
+
+            MPSCQUEUE_DRAIN_HOOK();
+
+            std::size_t n(0);
+
+            while (m_tail != head)
+            {
+                auto& cell = m_cells[m_tail & MASK];
+
+                // slot claimed but not published yet, the producer is mid-write
+                std::size_t spin(0);
+                while (cell.seq.load(std::memory_order_acquire) != m_tail + 1)
+                {
+                    if (++spin < 64)
+                        _mm_pause();
+                    else
+                        std::this_thread::yield();
+                }
+
+                a_out.emplace_back(std::move(cell.data));
+                cell.seq.store(m_tail + _Capacity, std::memory_order_release);
+
+                m_tail++;
+                n++;
+            }
+
+            while (!overflow.empty())
+            {
+                a_out.emplace_back(std::move(overflow.front()));
+                overflow.pop();
+                n++;
+            }
+
+            // back to the ring only if nothing spilled while we were draining,
+            // otherwise the next drain picks those up first
+            if (spilled)
+            {
+                std::lock_guard<std::mutex> _(m_overflowMutex);
+                m_overflowSize.store(m_overflow.size(), std::memory_order_release);
+            }
+
+            m_stats.pushed += n;
+            m_stats.overflowed = m_overflowCount.load(std::memory_order_relaxed);
+
+            if (n > m_stats.peakBatch)
+                m_stats.peakBatch = n;
+
+            return n;
+        }
+
+        // consumer side only
+        void Clear()
+        {
+            struct discard_t
+            {
+                SKMP_FORCEINLINE void emplace_back(T&&) {}
+            } d;
+
+            Drain(d);
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE const auto& GetStats() const {
+            return m_stats;
+        }
+
+        SKMP_FORCEINLINE void ResetStats() {
+            m_stats.pushed = 0;
+            m_stats.overflowed = 0;
+            m_stats.peakBatch = 0;
+            m_overflowCount.store(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] static constexpr std::size_t Capacity() {
+            return _Capacity;
+        }
+
+    private:
+
+        bool TryPush(T& a_item)
+        {
+            auto pos = m_head.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto& cell = m_cells[pos & MASK];
+                auto seq = cell.seq.load(std::memory_order_acquire);
+                auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (dif == 0)
+                {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.data = std::move(a_item);
+                        cell.seq.store(pos + 1, std::memory_order_release);
+
+                        return true;
+                    }
+                }
+                else if (dif < 0)
+                    return false;
+                else
+                    pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell_t m_cells[_Capacity];
+
+        // keep the producers' head and the consumer's tail on separate cache lines
+        std::atomic<std::size_t> m_head;
+        char m_pad[64 - sizeof(std::atomic<std::size_t>)];
+        std::size_t m_tail;
+
+        std::atomic<std::size_t> m_overflowSize;
+        std::atomic<uint64_t> m_overflowCount{ 0 };
+        std::queue<T> m_overflow;
+        std::mutex m_overflowMutex;
+
+        stats_t m_stats;
+    };
+}
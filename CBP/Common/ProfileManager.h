@@ -212,6 +212,9 @@ class ProfileManager
 public:
     static constexpr size_t MAX_FILENAME_LENGTH = 64;
 
+    // directories with fewer files than this are parsed on the calling thread
+    static constexpr size_t PARALLEL_LOAD_MIN = 4;
+
     ProfileManager(const std::string& a_fc, const fs::path& a_ext = ".json");
 
     ProfileManager() = delete;
@@ -232,6 +235,13 @@ public:
     [[nodiscard]] bool DeleteProfile(const std::string& a_name);
     [[nodiscard]] bool RenameProfile(const std::string& a_oldName, const std::string& a_newName);
 
+    // adopt profiles changed outside of the manager, files are left alone
+    [[nodiscard]] bool UpdateProfile(T&& a_in);
+    bool RemoveProfile(const std::string& a_name);
+
+    // applies the same filters as Load
+    [[nodiscard]] bool IsProfilePath(const fs::path& a_path) const;
+
     [[nodiscard]] SKMP_FORCEINLINE profileStorage_t& Data() noexcept { return m_storage; }
     [[nodiscard]] SKMP_FORCEINLINE const profileStorage_t& Data() const noexcept { return m_storage; }
     [[nodiscard]] SKMP_FORCEINLINE T& Get(const std::string& a_key) { return m_storage.at(a_key); };
@@ -288,39 +298,65 @@ bool ProfileManager<T>::Load(const fs::path& a_path)
         else if (!fs::is_directory(a_path))
             throw std::exception("Root path is not a directory");
 
+        PerfTimer pt;
+        pt.Start();
+
         m_storage.clear();
 
         m_root = a_path;
         m_isInitialized = true;
 
+        stl::vector<T> profiles;
+
         for (const auto& entry : fs::directory_iterator(a_path))
         {
             if (!entry.is_regular_file())
                 continue;
 
             auto& path = entry.path();
-            if (!path.has_extension() || path.extension() != m_ext)
+            if (!IsProfilePath(path))
                 continue;
 
-            auto key = path.stem().string();
-            if (key.size() == 0)
-                continue;
+            profiles.emplace_back(path);
+        }
 
-            if (!std::regex_match(key, m_rFileCheck)) {
-                Warning("Invalid characters in profile name: %s", key.c_str());
-                continue;
-            }
+        // profiles only touch their own state while parsing
+        stl::vector<std::uint8_t> results(profiles.size(), 0);
 
-            auto filename = path.filename().string();
-            if (filename.length() > MAX_FILENAME_LENGTH) {
-                Warning("Filename too long: %s", filename.c_str());
-                continue;
+        uint32_t numThreads(1);
+
+        if (profiles.size() >= PARALLEL_LOAD_MIN)
+        {
+            CBP::ThreadPool pool;
+
+            numThreads = pool.GetNumThreads();
+
+            for (size_t i = 0; i < profiles.size(); i++)
+            {
+                // refused by a stopped pool, parse it here instead
+                if (!pool.Push([&, i] {
+                    results[i] = profiles[i].Load();
+                    }))
+                {
+                    results[i] = profiles[i].Load();
+                }
             }
 
-            T profile(path);
-            if (!profile.Load()) {
+            pool.Wait();
+        }
+        else
+        {
+            for (size_t i = 0; i < profiles.size(); i++)
+                results[i] = profiles[i].Load();
+        }
+
+        for (size_t i = 0; i < profiles.size(); i++)
+        {
+            auto& profile = profiles[i];
+
+            if (!results[i]) {
                 Warning("Failed loading profile '%s': %s",
-                    filename.c_str(), profile.GetLastException().what());
+                    profile.Path().filename().string().c_str(), profile.GetLastException().what());
                 continue;
             }
 
@@ -330,7 +366,8 @@ bool ProfileManager<T>::Load(const fs::path& a_path)
             m_storage.emplace(profile.Name(), std::move(profile));
         }
 
-        Debug("Loaded %zu profile(s)", m_storage.size());
+        Debug("%s: loaded %zu profile(s) in %fs (%u thread(s))",
+            a_path.string().c_str(), m_storage.size(), pt.Stop(), numThreads);
 
         return true;
     }
@@ -462,6 +499,79 @@ bool ProfileManager<T>::AddProfile(T&& a_in)
     }
 }
 
+template <class T>
+bool ProfileManager<T>::IsProfilePath(const fs::path& a_path) const
+{
+    if (!a_path.has_extension() || a_path.extension() != m_ext)
+        return false;
+
+    auto key = a_path.stem().string();
+    if (key.size() == 0)
+        return false;
+
+    if (!std::regex_match(key, m_rFileCheck)) {
+        Warning("Invalid characters in profile name: %s", key.c_str());
+        return false;
+    }
+
+    auto filename = a_path.filename().string();
+    if (filename.length() > MAX_FILENAME_LENGTH) {
+        Warning("Filename too long: %s", filename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+template <class T>
+bool ProfileManager<T>::UpdateProfile(T&& a_in)
+{
+    try
+    {
+        if (!m_isInitialized)
+            throw std::exception("Not initialized");
+
+        auto key = a_in.Name();
+
+        CheckProfileKey(key);
+
+        auto it = m_storage.find(key);
+        if (it != m_storage.end())
+        {
+            m_storage.erase(it);
+            m_storage.emplace(key, std::move(a_in));
+        }
+        else
+        {
+            auto r = m_storage.emplace(key, std::move(a_in));
+            OnProfileAdd(r.first->second);
+        }
+
+        return true;
+    }
+    catch (const std::exception& e) {
+        Error("%s: %s", __FUNCTION__, e.what());
+        m_lastExcept = e;
+        return false;
+    }
+}
+
+template <class T>
+bool ProfileManager<T>::RemoveProfile(const std::string& a_name)
+{
+    if (!m_isInitialized)
+        return false;
+
+    auto it = m_storage.find(a_name);
+    if (it == m_storage.end())
+        return false;
+
+    OnProfileDelete(it->second);
+    m_storage.erase(it);
+
+    return true;
+}
+
 template <class T>
 void ProfileManager<T>::CheckProfileKey(const std::string& a_key) const
 {
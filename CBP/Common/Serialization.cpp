@@ -2,5 +2,246 @@
 
 namespace Serialization
 {
-   
-}
\ No newline at end of file
+    static std::mutex s_writeJournalMutex;
+    static stl::unordered_map<std::wstring, fs::file_time_type> s_writeJournal;
+
+    static std::wstring GetJournalKey(const fs::path& a_path)
+    {
+        auto key = a_path.lexically_normal().wstring();
+        std::transform(key.begin(), key.end(), key.begin(), ::towlower);
+        return key;
+    }
+
+    void RecordWrite(const fs::path& a_path)
+    {
+        std::error_code ec;
+        auto time = fs::last_write_time(a_path, ec);
+        if (ec)
+            return;
+
+        auto key = GetJournalKey(a_path);
+
+        std::lock_guard<std::mutex> lock(s_writeJournalMutex);
+        s_writeJournal.insert_or_assign(std::move(key), time);
+    }
+
+    bool IsOwnWrite(const fs::path& a_path)
+    {
+        std::error_code ec;
+        auto time = fs::last_write_time(a_path, ec);
+        if (ec)
+            return false;
+
+        auto key = GetJournalKey(a_path);
+
+        std::lock_guard<std::mutex> lock(s_writeJournalMutex);
+
+        auto it = s_writeJournal.find(key);
+        return it != s_writeJournal.end() && it->second == time;
+    }
+
+    ObjectScanner::ObjectScanner(const char* a_begin, const char* a_end) :
+        m_p(a_begin),
+        m_end(a_end),
+        m_first(true),
+        m_done(false)
+    {
+        // UTF-8 BOM
+        if (m_end - m_p >= 3 &&
+            static_cast<unsigned char>(m_p[0]) == 0xEF &&
+            static_cast<unsigned char>(m_p[1]) == 0xBB &&
+            static_cast<unsigned char>(m_p[2]) == 0xBF)
+        {
+            m_p += 3;
+        }
+
+        SkipWhitespace();
+
+        if (m_p == m_end || *m_p != '{')
+            Fail("Expected an object");
+
+        m_p++;
+    }
+
+    bool ObjectScanner::Next(std::string& a_key, const char*& a_valueBegin, const char*& a_valueEnd)
+    {
+        if (m_done)
+            return false;
+
+        SkipWhitespace();
+
+        if (m_p == m_end)
+            Fail("Unexpected end of data");
+
+        if (*m_p == '}')
+        {
+            m_p++;
+            m_done = true;
+            return false;
+        }
+
+        if (!m_first)
+        {
+            if (*m_p != ',')
+                Fail("Expected ','");
+
+            m_p++;
+            SkipWhitespace();
+        }
+
+        if (m_p == m_end || *m_p != '"')
+            Fail("Expected a member name");
+
+        auto keyBegin = m_p;
+        SkipString();
+
+        // names needing unescaping go through the regular parser
+        if (std::find(keyBegin, m_p, '\\') != m_p)
+        {
+            Json::Value key;
+            ParseRange(keyBegin, m_p, key);
+            a_key = key.asString();
+        }
+        else
+            a_key.assign(keyBegin + 1, m_p - 1);
+
+        SkipWhitespace();
+
+        if (m_p == m_end || *m_p != ':')
+            Fail("Expected ':'");
+
+        m_p++;
+        SkipWhitespace();
+
+        a_valueBegin = m_p;
+        SkipValue();
+        a_valueEnd = m_p;
+
+        m_first = false;
+
+        return true;
+    }
+
+    size_t ObjectScanner::CountMembers(const char* a_begin, const char* a_end)
+    {
+        ObjectScanner scanner(a_begin, a_end);
+
+        std::string key;
+        const char* b;
+        const char* e;
+
+        size_t n(0);
+
+        while (scanner.Next(key, b, e))
+            n++;
+
+        return n;
+    }
+
+    void ObjectScanner::SkipWhitespace()
+    {
+        while (m_p != m_end &&
+            (*m_p == ' ' || *m_p == '\t' || *m_p == '\r' || *m_p == '\n'))
+        {
+            m_p++;
+        }
+    }
+
+    void ObjectScanner::SkipString()
+    {
+        // opening quote
+        m_p++;
+
+        for (;;)
+        {
+            if (m_p == m_end)
+                Fail("Unterminated string");
+
+            auto c = *m_p++;
+
+            if (c == '"')
+                return;
+
+            if (c == '\\')
+            {
+                if (m_p == m_end)
+                    Fail("Unterminated string");
+
+                m_p++;
+            }
+        }
+    }
+
+    void ObjectScanner::SkipValue()
+    {
+        if (m_p == m_end)
+            Fail("Expected a value");
+
+        switch (*m_p)
+        {
+        case '"':
+            SkipString();
+            break;
+        case '{':
+        case '[':
+        {
+            size_t depth(0);
+
+            for (;;)
+            {
+                if (m_p == m_end)
+                    Fail("Unexpected end of data");
+
+                auto c = *m_p;
+
+                if (c == '"') {
+                    SkipString();
+                    continue;
+                }
+
+                m_p++;
+
+                if (c == '{' || c == '[')
+                    depth++;
+                else if (c == '}' || c == ']')
+                {
+                    if (--depth == 0)
+                        break;
+                }
+            }
+        }
+        break;
+        default:
+        {
+            auto start = m_p;
+
+            while (m_p != m_end &&
+                *m_p != ',' && *m_p != '}' && *m_p != ']' &&
+                *m_p != ' ' && *m_p != '\t' && *m_p != '\r' && *m_p != '\n')
+            {
+                m_p++;
+            }
+
+            if (m_p == start)
+                Fail("Expected a value");
+        }
+        break;
+        }
+    }
+
+    void ObjectScanner::Fail(const char* a_what) const
+    {
+        throw std::exception(a_what);
+    }
+
+    void ParseRange(const char* a_begin, const char* a_end, Json::Value& a_out)
+    {
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+
+        std::string errors;
+
+        if (!reader->parse(a_begin, a_end, std::addressof(a_out), std::addressof(errors)))
+            throw std::exception(errors.c_str());
+    }
+}
@@ -110,8 +110,14 @@ namespace Serialization
             throw std::exception("Root path is not a directory");
     }
 
-    template <class T>
-    void WriteData(const fs::path& a_path, const T& a_root)
+    // WriteStream records the write time each file has once replaced so
+    // file watchers can tell our own writes from external edits
+    void RecordWrite(const fs::path& a_path);
+    [[nodiscard]] bool IsOwnWrite(const fs::path& a_path);
+
+    // writes to a temporary file which replaces a_path once a_func returns
+    template <class Tf>
+    void WriteStream(const fs::path& a_path, Tf a_func)
     {
         CreateRootPath(a_path);
 
@@ -127,10 +133,15 @@ namespace Serialization
                 if (!ofs.is_open())
                     throw std::system_error(errno, std::system_category(), tmpPath.string());
 
-                ofs << a_root;
+                a_func(ofs);
+
+                if (!ofs.good())
+                    throw std::exception("Write failed");
             }
 
             fs::rename(tmpPath, a_path);
+
+            RecordWrite(a_path);
         }
         catch (const std::exception& e)
         {
@@ -139,4 +150,40 @@ namespace Serialization
         }
     }
 
+    template <class T>
+    void WriteData(const fs::path& a_path, const T& a_root)
+    {
+        WriteStream(a_path, [&](std::ofstream& a_out) { a_out << a_root; });
+    }
+
+    // Walks the members of a JSON object without building a tree. Values are
+    // handed out as [begin, end) ranges so large documents can be parsed one
+    // member at a time. Only the structure (strings, escapes, nesting) is
+    // checked here, values are validated by whoever parses them.
+    class ObjectScanner
+    {
+    public:
+        ObjectScanner(const char* a_begin, const char* a_end);
+
+        // false once the closing brace is reached
+        bool Next(std::string& a_key, const char*& a_valueBegin, const char*& a_valueEnd);
+
+        [[nodiscard]] static size_t CountMembers(const char* a_begin, const char* a_end);
+
+    private:
+        void SkipWhitespace();
+        void SkipString();
+        void SkipValue();
+
+        [[noreturn]] void Fail(const char* a_what) const;
+
+        const char* m_p;
+        const char* m_end;
+        bool m_first;
+        bool m_done;
+    };
+
+    // parses a single value range produced by ObjectScanner
+    void ParseRange(const char* a_begin, const char* a_end, Json::Value& a_out);
+
 }
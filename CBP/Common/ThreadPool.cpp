@@ -0,0 +1,106 @@
+#include "pch.h"
+
+namespace CBP
+{
+    ThreadPool::ThreadPool(uint32_t a_numThreads) :
+        m_numThreads(a_numThreads),
+        m_busy(0),
+        m_stop(false)
+    {
+        if (!m_numThreads)
+        {
+            auto n = std::thread::hardware_concurrency();
+            m_numThreads = std::clamp<uint32_t>(n > 1 ? n - 1 : 1, 1, 8);
+        }
+    }
+
+    ThreadPool::~ThreadPool() noexcept
+    {
+        Stop();
+    }
+
+    void ThreadPool::Start()
+    {
+        m_threads.reserve(m_numThreads);
+
+        for (uint32_t i = 0; i < m_numThreads; i++)
+            m_threads.emplace_back(&ThreadPool::Worker, this);
+    }
+
+    bool ThreadPool::Push(func_t&& a_func)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_stop)
+                return false;
+
+            if (m_threads.empty())
+                Start();
+
+            m_queue.emplace(std::move(a_func));
+        }
+
+        m_cond.notify_one();
+
+        return true;
+    }
+
+    void ThreadPool::Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_idleCond.wait(lock, [&] {
+            return m_queue.empty() && m_busy == 0;
+            });
+    }
+
+    void ThreadPool::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_cond.notify_all();
+
+        for (auto& e : m_threads)
+        {
+            if (e.joinable())
+                e.join();
+        }
+
+        m_threads.clear();
+    }
+
+    void ThreadPool::Worker()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (;;)
+        {
+            m_cond.wait(lock, [&] {
+                return !m_queue.empty() || m_stop;
+                });
+
+            if (m_queue.empty())
+                break;
+
+            auto func = std::move(m_queue.front());
+            m_queue.pop();
+
+            m_busy++;
+
+            lock.unlock();
+
+            func();
+
+            lock.lock();
+
+            m_busy--;
+
+            if (m_queue.empty() && m_busy == 0)
+                m_idleCond.notify_all();
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+namespace CBP
+{
+    class ThreadPool
+    {
+    public:
+
+        using func_t = std::function<void()>;
+
+        ThreadPool(uint32_t a_numThreads = 0);
+        virtual ~ThreadPool() noexcept;
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // false if the pool has been stopped
+        [[nodiscard]] bool Push(func_t&& a_func);
+        void Wait();
+        void Stop();
+
+        [[nodiscard]] SKMP_FORCEINLINE auto GetNumThreads() const {
+            return m_numThreads;
+        }
+
+    private:
+
+        void Start();
+        void Worker();
+
+        stl::vector<std::thread> m_threads;
+        std::queue<func_t> m_queue;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        std::condition_variable m_idleCond;
+
+        uint32_t m_numThreads;
+        uint32_t m_busy;
+        bool m_stop;
+    };
+}
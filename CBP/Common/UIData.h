@@ -9,7 +9,7 @@ namespace UIData
         UICollapsibleStates() = default;
 
         void Parse(const Json::Value& a_in);
-        void Create(Json::Value& a_out);
+        void Create(Json::Value& a_out) const;
 
         SKMP_FORCEINLINE bool& Get(const std::string& a_key, bool a_default = true)
         {
@@ -0,0 +1,448 @@
+// Standalone round-trip, fuzz and timing test for IConfigSchema, the co-save
+// block format, against the boost archive format it replaced. Not part of
+// the plugin build, pch.h in this directory stands in for the plugin's:
+//
+//   cl /std:c++latest /O2 /EHsc /arch:AVX2 /I. ConfigSchemaTest.cpp
+//       ..\..\CBP\ConfigDataISeg.cpp ..\..\CBP\ConfigData.cpp ..\..\CBP\ConfigSchema.cpp
+//   g++ -std=c++20 -O2 -mavx2 -I. -I/usr/include/jsoncpp ConfigSchemaTest.cpp
+//       ../../CBP/ConfigDataISeg.cpp ../../CBP/ConfigData.cpp ../../CBP/ConfigSchema.cpp
+//       -lboost_serialization
+//
+// (plus the jsoncpp/boost include and library paths). Build with
+// -fsanitize=address,undefined to have the fuzz pass catch out of bounds
+// reads as well.
+//
+//   ConfigSchemaTest [fuzz iterations] [actors] [groups]
+//
+// Returns non-zero if a round trip differs, unknown or missing fields aren't
+// handled or a corrupt block is read without a clean exception.
+
+#include "pch.h"
+
+#include <random>
+
+using namespace CBP;
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr std::uint64_t HANDLE_BASE = 0x0000FFFF00000000ULL;
+
+    void Synthesize(
+        std::uint32_t a_actors,
+        std::uint32_t a_groups,
+        actorConfigComponentsHolder_t& a_physics,
+        actorConfigNodesHolder_t& a_nodes)
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        char buf[32];
+
+        for (std::uint32_t i = 0; i < a_actors; i++)
+        {
+            Game::ObjectHandle handle(HANDLE_BASE + i);
+
+            auto& physics = a_physics[handle];
+            auto& nodes = a_nodes[handle];
+
+            for (std::uint32_t j = 0; j < a_groups; j++)
+            {
+                _snprintf_s(buf, _TRUNCATE, "group%u", j);
+                auto& c = physics[buf];
+
+                auto base = reinterpret_cast<char*>(std::addressof(c));
+                for (std::size_t k = 0; k < vec.size(); k++)
+                    *reinterpret_cast<float*>(base + vec[k].second.offset) +=
+                        static_cast<float>((i + j * 7 + k * 13) % 97) * 0.01f;
+
+                c.ex.colShape = static_cast<ColliderShapeType>((i + j) % 7);
+                if ((i + j) % 5 == 0)
+                    c.ex.colMesh = "mesh" + std::to_string(j);
+
+                _snprintf_s(buf, _TRUNCATE, "node%u", j);
+                auto& n = nodes[buf];
+
+                n.bl.b.motion.female = ((i + j) & 1) == 0;
+                n.bl.b.collisions.male = ((i + j) & 2) == 0;
+                n.bl.b.boneCast = ((i + j) & 4) == 0;
+                n.fp.f32.nodeScale = 1.0f + static_cast<float>((i + j) % 10) * 0.05f;
+                n.fp.f32.colRot[1] = static_cast<float>(j);
+                if ((i + j) % 3 == 0)
+                    n.ex.bcShape = "shape" + std::to_string(i);
+            }
+        }
+    }
+
+    // same layout BlockSerializeBegin writes for a holder bucket
+    template <class T>
+    void WriteBlock(const T& a_holder, stl::vector<char>& a_out)
+    {
+        a_out.clear();
+
+        IConfigSchema::Writer out(a_out);
+        IConfigSchema::BlockWriter ar(out);
+
+        for (const auto& e : a_holder)
+        {
+            ar << e.first;
+            ar << e.second;
+        }
+    }
+
+    template <class T>
+    void ReadBlock(const char* a_data, std::size_t a_size, std::size_t a_count, T& a_out)
+    {
+        IConfigSchema::Reader in(a_data, a_size);
+        IConfigSchema::BlockReader ar(in);
+
+        for (std::size_t i = 0; i < a_count; i++)
+        {
+            Game::ObjectHandle handle;
+            ar >> handle;
+            ar >> a_out[handle];
+        }
+    }
+
+    bool Equal(const configNode_t& a_lhs, const configNode_t& a_rhs)
+    {
+        return std::memcmp(std::addressof(a_lhs.fp.f32), std::addressof(a_rhs.fp.f32), sizeof(nodeDataF32_t)) == 0 &&
+            a_lhs.bl.u64.d0 == a_rhs.bl.u64.d0 &&
+            a_lhs.ex.bcShape == a_rhs.ex.bcShape;
+    }
+
+    bool Equal(const configComponent32_t& a_lhs, const configComponent32_t& a_rhs)
+    {
+        return a_lhs.Equals(a_rhs);
+    }
+
+    template <class T>
+    bool Equal(const T& a_lhs, const T& a_rhs)
+    {
+        if (a_lhs.size() != a_rhs.size())
+            return false;
+
+        for (const auto& e : a_lhs)
+        {
+            auto it = a_rhs.find(e.first);
+            if (it == a_rhs.end())
+                return false;
+
+            if (!Equal(e.second, it->second))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool RunRoundTrip(std::uint32_t a_actors, std::uint32_t a_groups)
+    {
+        actorConfigComponentsHolder_t physics;
+        actorConfigNodesHolder_t nodes;
+
+        Synthesize(a_actors, a_groups, physics, nodes);
+
+        stl::vector<char> pblock, nblock;
+
+        WriteBlock(physics, pblock);
+        WriteBlock(nodes, nblock);
+
+        actorConfigComponentsHolder_t physicsIn;
+        actorConfigNodesHolder_t nodesIn;
+
+        bool ok(true);
+
+        try
+        {
+            ReadBlock(pblock.data(), pblock.size(), physics.size(), physicsIn);
+            ReadBlock(nblock.data(), nblock.size(), nodes.size(), nodesIn);
+
+            ok = Equal(physics, physicsIn) && Equal(nodes, nodesIn);
+        }
+        catch (const std::exception& e)
+        {
+            std::fprintf(stderr, "round trip: %s\n", e.what());
+            ok = false;
+        }
+
+        std::printf("%-28s %s\n", "round trip", ok ? "ok" : "FAILED");
+
+        return ok;
+    }
+
+    // A table naming a field this build doesn't know and leaving out one it
+    // does: the unknown slot is skipped, the missing one keeps its default
+    // and data appended to the record body is ignored.
+    bool RunForwardCompat()
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        stl::vector<char> block;
+        IConfigSchema::Writer out(block);
+
+        // table: every known field but the first, plus one unknown
+        out.Write(static_cast<std::uint32_t>(vec.size()));
+        for (std::size_t i = 1; i < vec.size(); i++)
+            out.Write(vec[i].first);
+        out.Write(std::string("fieldFromTheFuture"));
+
+        // one record
+        out.Write(std::uint32_t(1));
+        out.Write(std::string("group0"));
+
+        auto sizePos = out.Position();
+        out.Write(std::uint32_t(0));
+
+        for (std::size_t i = 1; i < vec.size(); i++)
+            out.Write(static_cast<float>(i));
+        out.Write(123.0f);
+
+        out.Write(ColliderShapeType::Box);
+        out.Write(std::string("mesh"));
+        out.Write(std::uint64_t(0xDEADBEEF));
+
+        out.Patch(sizePos, static_cast<std::uint32_t>(out.Position() - sizePos - sizeof(std::uint32_t)));
+
+        IConfigSchema::ResetReadStats();
+
+        configComponents_t result;
+        bool ok(true);
+
+        try
+        {
+            IConfigSchema::Reader in(block.data(), block.size());
+
+            IConfigSchema::fieldMap_t map;
+            IConfigSchema::ReadPhysicsTable(in, map);
+            IConfigSchema::Read(in, map, result);
+
+            ok = in.Remaining() == 0;
+        }
+        catch (const std::exception& e)
+        {
+            std::fprintf(stderr, "forward compat: %s\n", e.what());
+            ok = false;
+        }
+
+        configComponent32_t defaults;
+
+        auto it = result.find("group0");
+        if (ok && it != result.end())
+        {
+            auto base = reinterpret_cast<const char*>(std::addressof(it->second));
+            auto dbase = reinterpret_cast<const char*>(std::addressof(defaults));
+
+            ok &= std::memcmp(base + vec[0].second.offset, dbase + vec[0].second.offset, sizeof(float)) == 0;
+
+            for (std::size_t i = 1; i < vec.size(); i++)
+                ok &= *reinterpret_cast<const float*>(base + vec[i].second.offset) == static_cast<float>(i);
+
+            ok &= it->second.ex.colShape == ColliderShapeType::Box;
+            ok &= it->second.ex.colMesh == "mesh";
+        }
+        else
+            ok = false;
+
+        ok &= IConfigSchema::GetReadStats().unknownFields == 1;
+
+        std::printf("%-28s %s\n", "unknown/missing fields", ok ? "ok" : "FAILED");
+
+        return ok;
+    }
+
+    // Mutates valid blocks and reads them back. Every read has to either
+    // succeed or throw std::exception, anything else (a crash, a sanitizer
+    // report, a foreign exception) is a failure.
+    bool RunFuzz(std::uint32_t a_iterations)
+    {
+        actorConfigComponentsHolder_t physics;
+        actorConfigNodesHolder_t nodes;
+
+        Synthesize(16, 4, physics, nodes);
+
+        stl::vector<char> blocks[2];
+
+        WriteBlock(physics, blocks[0]);
+        WriteBlock(nodes, blocks[1]);
+
+        std::mt19937_64 rng(0xCB9F);
+
+        static constexpr std::uint32_t interesting[] = {
+            0, 1, 2, 0x7F, 0x80, 0xFF, 0x100, 0xFFFF, 0x10000,
+            0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF
+        };
+
+        std::size_t accepted(0), rejected(0);
+        bool ok(true);
+
+        stl::vector<char> data;
+
+        for (std::uint32_t iter = 0; iter < a_iterations; iter++)
+        {
+            auto& src = blocks[iter & 1];
+
+            data.assign(src.begin(), src.end());
+
+            auto mutations = 1 + rng() % 4;
+
+            for (std::uint64_t m = 0; m < mutations && !data.empty(); m++)
+            {
+                auto pos = static_cast<std::size_t>(rng() % data.size());
+
+                switch (rng() % 5)
+                {
+                case 0:
+                    data[pos] ^= static_cast<char>(1 << (rng() % 8));
+                    break;
+                case 1:
+                    data[pos] = static_cast<char>(rng());
+                    break;
+                case 2:
+                    // length prefixes and counts are all 32 bit
+                    if (pos + sizeof(std::uint32_t) <= data.size())
+                    {
+                        auto v = interesting[rng() % std::size(interesting)];
+                        std::memcpy(data.data() + pos, std::addressof(v), sizeof(v));
+                    }
+                    break;
+                case 3:
+                    data.resize(pos);
+                    break;
+                case 4:
+                    data.insert(data.begin() + pos, static_cast<char>(rng()));
+                    break;
+                }
+            }
+
+            try
+            {
+                if (iter & 1)
+                {
+                    actorConfigNodesHolder_t out;
+                    ReadBlock(data.data(), data.size(), nodes.size(), out);
+                }
+                else
+                {
+                    actorConfigComponentsHolder_t out;
+                    ReadBlock(data.data(), data.size(), physics.size(), out);
+                }
+
+                accepted++;
+            }
+            catch (const std::exception&)
+            {
+                rejected++;
+            }
+            catch (...)
+            {
+                std::fprintf(stderr, "fuzz: iteration %u threw a foreign exception\n", iter);
+                ok = false;
+            }
+        }
+
+        std::printf("%-28s %u iterations, %zu read, %zu rejected  %s\n",
+            "fuzz", a_iterations, accepted, rejected, ok ? "ok" : "FAILED");
+
+        return ok;
+    }
+
+    template <class Tf>
+    double Time(int a_runs, Tf a_func)
+    {
+        double best(std::numeric_limits<double>::max());
+
+        for (int i = 0; i < a_runs; i++)
+        {
+            auto start = clock_type::now();
+            a_func();
+            best = std::min(best, std::chrono::duration<double>(clock_type::now() - start).count());
+        }
+
+        return best;
+    }
+
+    void PrintTiming(const char* a_name, double a_time, std::size_t a_bytes)
+    {
+        std::printf("%-28s %9.3f ms  %10zu bytes  %8.1f MB/s\n",
+            a_name, a_time * 1000.0, a_bytes,
+            a_time > 0.0 ? static_cast<double>(a_bytes) / a_time / (1024.0 * 1024.0) : 0.0);
+    }
+
+    // best of a few runs, same data through both formats
+    void RunTiming(std::uint32_t a_actors, std::uint32_t a_groups)
+    {
+        constexpr int RUNS = 5;
+
+        actorConfigComponentsHolder_t physics;
+        actorConfigNodesHolder_t nodes;
+
+        Synthesize(a_actors, a_groups, physics, nodes);
+
+        std::printf("\n%u actors x %u groups, best of %d\n", a_actors, a_groups, RUNS);
+
+        std::string archive;
+
+        auto t = Time(RUNS, [&]
+            {
+                std::ostringstream ss;
+                {
+                    boost::archive::binary_oarchive ar(ss);
+                    ar << physics;
+                    ar << nodes;
+                }
+                archive = ss.str();
+            });
+        PrintTiming("archive_save", t, archive.size());
+
+        t = Time(RUNS, [&]
+            {
+                actorConfigComponentsHolder_t p;
+                actorConfigNodesHolder_t n;
+
+                std::istringstream ss(archive);
+                boost::archive::binary_iarchive ar(ss);
+                ar >> p;
+                ar >> n;
+            });
+        PrintTiming("archive_load", t, archive.size());
+
+        stl::vector<char> pblock, nblock;
+
+        t = Time(RUNS, [&]
+            {
+                WriteBlock(physics, pblock);
+                WriteBlock(nodes, nblock);
+            });
+        PrintTiming("schema_write", t, pblock.size() + nblock.size());
+
+        t = Time(RUNS, [&]
+            {
+                actorConfigComponentsHolder_t p;
+                actorConfigNodesHolder_t n;
+
+                ReadBlock(pblock.data(), pblock.size(), physics.size(), p);
+                ReadBlock(nblock.data(), nblock.size(), nodes.size(), n);
+            });
+        PrintTiming("schema_read", t, pblock.size() + nblock.size());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::uint32_t iterations = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 20000;
+    std::uint32_t actors = argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1000;
+    std::uint32_t groups = argc > 3 ? static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 8;
+
+    bool ok(true);
+
+    ok &= RunRoundTrip(64, 8);
+    ok &= RunForwardCompat();
+    ok &= RunFuzz(iterations);
+
+    if (actors && groups)
+        RunTiming(actors, groups);
+
+    std::printf("%s\n", ok ? "PASSED" : "FAILED");
+
+    return ok ? 0 : 1;
+}
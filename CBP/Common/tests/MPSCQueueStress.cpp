@@ -0,0 +1,327 @@
+// Standalone contention stress test and latency benchmark for MPSCQueue.
+// Not part of the plugin build:
+//
+//   cl /std:c++17 /O2 /EHsc MPSCQueueStress.cpp
+//   g++ -std=c++17 -O2 -pthread MPSCQueueStress.cpp
+//
+// Returns non-zero if any item is lost, duplicated or delivered out of
+// per-producer order.
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <immintrin.h>
+
+#ifndef SKMP_FORCEINLINE
+#   if defined(_MSC_VER)
+#       define SKMP_FORCEINLINE __forceinline
+#   else
+#       define SKMP_FORCEINLINE inline __attribute__((always_inline))
+#   endif
+#endif
+
+// lets the interleaving test push from inside Drain
+static std::function<void()> g_drainHook;
+
+#define MPSCQUEUE_DRAIN_HOOK() do { if (g_drainHook) g_drainHook(); } while (0)
+
+#include "../MPSCQueue.h"
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct item_t
+    {
+        uint32_t producer;
+        uint32_t seq;
+        clock_type::time_point pushed;
+    };
+
+    // the locked queue the controller used before the ring
+    class LockedQueue
+    {
+    public:
+
+        void Push(item_t&& a_item)
+        {
+            std::lock_guard<std::mutex> _(m_mutex);
+            m_queue.emplace(std::move(a_item));
+        }
+
+        template <class C>
+        std::size_t Drain(C& a_out)
+        {
+            std::lock_guard<std::mutex> _(m_mutex);
+
+            std::size_t n(0);
+
+            while (!m_queue.empty())
+            {
+                a_out.emplace_back(std::move(m_queue.front()));
+                m_queue.pop();
+                n++;
+            }
+
+            return n;
+        }
+
+    private:
+
+        std::mutex m_mutex;
+        std::queue<item_t> m_queue;
+    };
+
+    struct result_t
+    {
+        bool ok;
+        double seconds;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t max;
+    };
+
+    template <class Q>
+    result_t Run(
+        Q& a_queue,
+        uint32_t a_producers,
+        uint32_t a_itemsPerProducer,
+        uint32_t a_burst)
+    {
+        std::atomic<uint32_t> ready(0);
+        std::atomic<bool> go(false);
+
+        std::vector<std::thread> producers;
+
+        for (uint32_t p = 0; p < a_producers; p++)
+        {
+            producers.emplace_back([&, p]
+                {
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+
+                    for (uint32_t i = 0; i < a_itemsPerProducer; i++)
+                    {
+                        a_queue.Push(item_t{ p, i, clock_type::now() });
+
+                        // bursts with short gaps, roughly what event threads do
+                        if (a_burst && (i % a_burst) == a_burst - 1)
+                            std::this_thread::yield();
+                    }
+                });
+        }
+
+        while (ready.load() != a_producers)
+            std::this_thread::yield();
+
+        const uint64_t total = uint64_t(a_producers) * a_itemsPerProducer;
+
+        std::vector<uint32_t> next(a_producers, 0);
+        std::vector<uint64_t> latencies;
+        std::vector<item_t> batch;
+
+        latencies.reserve(std::size_t(total));
+
+        bool ok(true);
+        uint64_t received(0);
+
+        auto start = clock_type::now();
+        go.store(true, std::memory_order_release);
+
+        while (received < total)
+        {
+            batch.clear();
+
+            if (!a_queue.Drain(batch))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            auto now = clock_type::now();
+
+            for (auto& e : batch)
+            {
+                if (e.producer >= a_producers || e.seq != next[e.producer])
+                {
+                    std::fprintf(stderr, "out of order: producer %u, got %u, expected %u\n",
+                        e.producer, e.seq, e.producer < a_producers ? next[e.producer] : 0);
+                    ok = false;
+                }
+                else
+                    next[e.producer]++;
+
+                latencies.emplace_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - e.pushed).count()));
+            }
+
+            received += batch.size();
+        }
+
+        auto elapsed = clock_type::now() - start;
+
+        for (auto& e : producers)
+            e.join();
+
+        // nothing may be left behind once every producer finished
+        batch.clear();
+        if (a_queue.Drain(batch))
+        {
+            std::fprintf(stderr, "%zu extra items after all were received\n", batch.size());
+            ok = false;
+        }
+
+        for (uint32_t p = 0; p < a_producers; p++)
+        {
+            if (next[p] != a_itemsPerProducer)
+            {
+                std::fprintf(stderr, "producer %u: received %u/%u\n", p, next[p], a_itemsPerProducer);
+                ok = false;
+            }
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        auto pct = [&](double a_p) -> uint64_t {
+            if (latencies.empty())
+                return 0;
+            return latencies[std::min(latencies.size() - 1, std::size_t(double(latencies.size()) * a_p))];
+        };
+
+        return result_t{
+            ok,
+            std::chrono::duration<double>(elapsed).count(),
+            pct(0.5),
+            pct(0.99),
+            latencies.empty() ? 0 : latencies.back()
+        };
+    }
+
+    // A producer pushes while the consumer is between taking its snapshot
+    // and reading the ring, on two drains in a row:
+    //
+    //   1. ring is full, the push spills, the drain then frees every slot
+    //   2. the spilled item is taken, the push must not overtake it through
+    //      the free slots
+    bool RunInterleaving()
+    {
+        CBP::MPSCQueue<item_t, 4> q;
+
+        uint32_t seq(0);
+        auto push = [&] { q.Push(item_t{ 0, seq++, clock_type::now() }); };
+
+        std::vector<item_t> out;
+
+        for (std::size_t i = 0; i < q.Capacity(); i++)
+            push();
+
+        g_drainHook = push;
+
+        q.Drain(out);
+        q.Drain(out);
+
+        g_drainHook = nullptr;
+
+        push();
+
+        while (q.Drain(out))
+        {
+        }
+
+        bool ok(out.size() == seq);
+
+        for (std::size_t i = 0; i < out.size(); i++)
+        {
+            if (out[i].seq != i)
+                ok = false;
+        }
+
+        if (!ok)
+        {
+            std::fprintf(stderr, "interleaving: got");
+            for (auto& e : out)
+                std::fprintf(stderr, " %u", e.seq);
+            std::fprintf(stderr, "\n");
+        }
+
+        std::printf("%-28s %s\n", "drain interleaving", ok ? "ok" : "FAILED");
+
+        return ok;
+    }
+
+    void Print(const char* a_name, uint32_t a_producers, uint32_t a_items, const result_t& a_result)
+    {
+        double total = double(a_producers) * a_items;
+
+        std::printf("%-28s %2u producers  %8.0f items/ms  p50 %7llu ns  p99 %9llu ns  max %10llu ns  %s\n",
+            a_name,
+            a_producers,
+            total / (a_result.seconds * 1000.0),
+            static_cast<unsigned long long>(a_result.p50),
+            static_cast<unsigned long long>(a_result.p99),
+            static_cast<unsigned long long>(a_result.max),
+            a_result.ok ? "ok" : "FAILED");
+    }
+}
+
+int main()
+{
+    constexpr uint32_t ITEMS = 200000;
+
+    uint32_t hw = std::max(2u, std::thread::hardware_concurrency());
+
+    std::vector<uint32_t> producerCounts{ 1, 2, 4 };
+    if (hw > 4)
+        producerCounts.emplace_back(std::min(hw - 1, 16u));
+
+    bool ok(RunInterleaving());
+
+    for (auto n : producerCounts)
+    {
+        {
+            // same capacity as the controller
+            auto q = std::make_unique<CBP::MPSCQueue<item_t, 4096>>();
+            auto r = Run(*q, n, ITEMS, 64);
+            Print("MPSCQueue<4096>", n, ITEMS, r);
+
+            auto& stats = q->GetStats();
+            std::printf("%-28s pushed %llu, overflowed %llu, peak batch %zu\n", "",
+                static_cast<unsigned long long>(stats.pushed),
+                static_cast<unsigned long long>(stats.overflowed),
+                stats.peakBatch);
+
+            ok &= r.ok;
+        }
+
+        {
+            // tiny ring, most pushes go through the overflow path
+            auto q = std::make_unique<CBP::MPSCQueue<item_t, 16>>();
+            auto r = Run(*q, n, ITEMS, 0);
+            Print("MPSCQueue<16> (overflow)", n, ITEMS, r);
+
+            ok &= r.ok;
+        }
+
+        {
+            LockedQueue q;
+            auto r = Run(q, n, ITEMS, 64);
+            Print("mutex + std::queue", n, ITEMS, r);
+
+            ok &= r.ok;
+        }
+    }
+
+    std::printf("%s\n", ok ? "PASSED" : "FAILED");
+
+    return ok ? 0 : 1;
+}
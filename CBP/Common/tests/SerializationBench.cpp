@@ -0,0 +1,453 @@
+// Standalone version of the in-game serialization benchmark covering the
+// paths that don't need the game: the JSON parsers, the boost archive, the
+// co-save block schema and the codecs. Not part of the plugin build, pch.h
+// in this directory stands in for the plugin's:
+//
+//   cl /std:c++latest /O2 /EHsc /arch:AVX2 /I. SerializationBench.cpp
+//       ..\..\CBP\ConfigDataISeg.cpp ..\..\CBP\ConfigData.cpp ..\..\CBP\ConfigSchema.cpp
+//       ..\..\CBP\SerializationParser.cpp ..\Serialization.cpp ..\Codec.cpp
+//   g++ -std=c++20 -O2 -mavx2 -I. -I/usr/include/jsoncpp SerializationBench.cpp
+//       ../../CBP/ConfigDataISeg.cpp ../../CBP/ConfigData.cpp ../../CBP/ConfigSchema.cpp
+//       ../../CBP/SerializationParser.cpp ../Serialization.cpp ../Codec.cpp
+//       -ljsoncpp -lboost_serialization -lboost_iostreams -lz -lzstd -llz4
+//
+// (plus the jsoncpp/boost/zstd/lz4 include and library paths).
+//
+//   SerializationBench [actors] [groups] [report.csv]
+//
+// Every phase reports the peak heap it reached above what was live when it
+// started, tracked through the global operator new/delete below. Memory the
+// codec libraries allocate with malloc internally (zstd/lz4/zlib contexts)
+// isn't counted. Returns non-zero if a round trip doesn't give back what
+// went in.
+
+#include "pch.h"
+
+#include <new>
+#include <cstdlib>
+
+using namespace CBP;
+
+namespace
+{
+    std::atomic<std::size_t> g_heapCurrent(0);
+    std::atomic<std::size_t> g_heapPeak(0);
+
+    // size and the pointer malloc returned are kept right below the block
+    constexpr std::size_t HEAP_HEADER = sizeof(std::size_t) * 2;
+
+    void* HeapAlloc(std::size_t a_size, std::size_t a_align)
+    {
+        if (a_align < HEAP_HEADER)
+            a_align = HEAP_HEADER;
+
+        auto base = static_cast<char*>(std::malloc(a_size + a_align + HEAP_HEADER));
+        if (!base)
+            return nullptr;
+
+        auto addr = reinterpret_cast<std::uintptr_t>(base + HEAP_HEADER);
+        addr = (addr + a_align - 1) & ~(static_cast<std::uintptr_t>(a_align) - 1);
+
+        auto p = reinterpret_cast<std::size_t*>(addr);
+        p[-1] = a_size;
+        p[-2] = reinterpret_cast<std::uintptr_t>(base);
+
+        auto current = g_heapCurrent.fetch_add(a_size, std::memory_order_relaxed) + a_size;
+        auto peak = g_heapPeak.load(std::memory_order_relaxed);
+        while (current > peak &&
+            !g_heapPeak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        {
+        }
+
+        return p;
+    }
+
+    void HeapFree(void* a_ptr) noexcept
+    {
+        if (!a_ptr)
+            return;
+
+        auto p = static_cast<std::size_t*>(a_ptr);
+        g_heapCurrent.fetch_sub(p[-1], std::memory_order_relaxed);
+        std::free(reinterpret_cast<void*>(p[-2]));
+    }
+
+    void* HeapAllocOrThrow(std::size_t a_size, std::size_t a_align)
+    {
+        if (auto p = HeapAlloc(a_size, a_align))
+            return p;
+
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t a_size) { return HeapAllocOrThrow(a_size, 0); }
+void* operator new[](std::size_t a_size) { return HeapAllocOrThrow(a_size, 0); }
+void* operator new(std::size_t a_size, std::align_val_t a_align) { return HeapAllocOrThrow(a_size, static_cast<std::size_t>(a_align)); }
+void* operator new[](std::size_t a_size, std::align_val_t a_align) { return HeapAllocOrThrow(a_size, static_cast<std::size_t>(a_align)); }
+void* operator new(std::size_t a_size, const std::nothrow_t&) noexcept { return HeapAlloc(a_size, 0); }
+void* operator new[](std::size_t a_size, const std::nothrow_t&) noexcept { return HeapAlloc(a_size, 0); }
+void operator delete(void* a_ptr) noexcept { HeapFree(a_ptr); }
+void operator delete[](void* a_ptr) noexcept { HeapFree(a_ptr); }
+void operator delete(void* a_ptr, std::size_t) noexcept { HeapFree(a_ptr); }
+void operator delete[](void* a_ptr, std::size_t) noexcept { HeapFree(a_ptr); }
+void operator delete(void* a_ptr, std::align_val_t) noexcept { HeapFree(a_ptr); }
+void operator delete[](void* a_ptr, std::align_val_t) noexcept { HeapFree(a_ptr); }
+void operator delete(void* a_ptr, std::size_t, std::align_val_t) noexcept { HeapFree(a_ptr); }
+void operator delete[](void* a_ptr, std::size_t, std::align_val_t) noexcept { HeapFree(a_ptr); }
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr std::uint64_t HANDLE_BASE = 0x0000FFFF00000000ULL;
+
+    struct phase_t
+    {
+        std::string name;
+        std::size_t entries;
+        double time;
+        std::size_t bytes;
+        // highest live heap during the phase minus what was live at its start
+        std::size_t peakHeap;
+    };
+
+    class PhaseRecorder
+    {
+    public:
+        void Begin()
+        {
+            m_heapBase = g_heapCurrent.load(std::memory_order_relaxed);
+            g_heapPeak.store(m_heapBase, std::memory_order_relaxed);
+            m_start = clock_type::now();
+        }
+
+        void Record(std::string a_name, std::size_t a_entries, std::size_t a_bytes)
+        {
+            auto time = std::chrono::duration<double>(clock_type::now() - m_start).count();
+            auto peak = g_heapPeak.load(std::memory_order_relaxed);
+
+            m_phases.push_back({ std::move(a_name), a_entries, time, a_bytes, peak - m_heapBase });
+        }
+
+        [[nodiscard]] const auto& GetPhases() const noexcept {
+            return m_phases;
+        }
+
+    private:
+        clock_type::time_point m_start;
+        std::size_t m_heapBase{ 0 };
+        stl::vector<phase_t> m_phases;
+    };
+
+    void Synthesize(
+        std::uint32_t a_actors,
+        std::uint32_t a_groups,
+        actorConfigComponentsHolder_t& a_physics,
+        actorConfigNodesHolder_t& a_nodes)
+    {
+        auto& vec = configComponent32_t::descMap.getvec();
+
+        char buf[32];
+
+        for (std::uint32_t i = 0; i < a_actors; i++)
+        {
+            Game::ObjectHandle handle(HANDLE_BASE + i);
+
+            auto& physics = a_physics[handle];
+            auto& nodes = a_nodes[handle];
+
+            for (std::uint32_t j = 0; j < a_groups; j++)
+            {
+                _snprintf_s(buf, _TRUNCATE, "group%u", j);
+                auto& c = physics[buf];
+
+                // vary the values so the codecs don't see a single repeating record
+                auto base = reinterpret_cast<char*>(std::addressof(c));
+                for (std::size_t k = 0; k < vec.size(); k++)
+                    *reinterpret_cast<float*>(base + vec[k].second.offset) +=
+                        static_cast<float>((i + j * 7 + k * 13) % 97) * 0.01f;
+
+                _snprintf_s(buf, _TRUNCATE, "node%u", j);
+                auto& n = nodes[buf];
+
+                n.bl.b.motion.female = ((i + j) & 1) == 0;
+                n.bl.b.collisions.male = ((i + j) & 2) == 0;
+                n.fp.f32.nodeScale = 1.0f + static_cast<float>((i + j) % 10) * 0.05f;
+            }
+        }
+    }
+
+    bool Check(const char* a_name, std::size_t a_physics, std::size_t a_nodes, std::uint32_t a_actors)
+    {
+        if (a_physics == a_actors && a_nodes == a_actors)
+            return true;
+
+        std::fprintf(stderr, "%s: round trip mismatch (%zu/%zu, expected %u)\n",
+            a_name, a_physics, a_nodes, a_actors);
+
+        return false;
+    }
+
+    bool Run(std::uint32_t a_actors, std::uint32_t a_groups, PhaseRecorder& a_rec)
+    {
+        bool ok(true);
+
+        Serialization::Parser<configComponents_t> componentParser;
+        Serialization::Parser<configNodes_t> nodeParser;
+
+        actorConfigComponentsHolder_t dataPhysics;
+        actorConfigNodesHolder_t dataNodes;
+
+        a_rec.Begin();
+        Synthesize(a_actors, a_groups, dataPhysics, dataNodes);
+        a_rec.Record("synthesize", a_actors, 0);
+
+        // JSON: per-entry values as written by export and the profile store
+
+        stl::vector<Json::Value> values;
+        values.reserve(a_actors);
+
+        a_rec.Begin();
+        for (const auto& e : dataPhysics)
+        {
+            auto& v = values.emplace_back();
+            componentParser.Create(e.second, v);
+            nodeParser.Create(dataNodes[e.first], v);
+        }
+        a_rec.Record("json_create", a_actors, 0);
+
+        stl::vector<std::string> texts;
+        texts.reserve(a_actors);
+
+        {
+            Json::StreamWriterBuilder builder;
+            builder["indentation"] = "";
+
+            std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+            std::size_t bytes(0);
+
+            a_rec.Begin();
+            for (const auto& e : values)
+            {
+                std::ostringstream ss;
+                writer->write(e, std::addressof(ss));
+
+                auto& s = texts.emplace_back(ss.str());
+                bytes += s.size();
+            }
+            a_rec.Record("json_write", a_actors, bytes);
+        }
+
+        values.swap(decltype(values)());
+
+        {
+            actorConfigComponentsHolder_t physics;
+            actorConfigNodesHolder_t nodes;
+
+            std::size_t bytes(0);
+            std::uint64_t i(0);
+
+            a_rec.Begin();
+            for (const auto& e : texts)
+            {
+                Json::Value v;
+                Serialization::ParseRange(e.data(), e.data() + e.size(), v);
+
+                Game::ObjectHandle handle(HANDLE_BASE + i++);
+
+                if (!componentParser.Parse(v, physics[handle]) ||
+                    !nodeParser.Parse(v, nodes[handle]))
+                {
+                    throw std::exception("JSON parse failed");
+                }
+
+                bytes += e.size();
+            }
+            a_rec.Record("json_parse", a_actors, bytes);
+
+            ok &= Check("json_parse", physics.size(), nodes.size(), a_actors);
+        }
+
+        texts.swap(decltype(texts)());
+
+        // boost archive, the co-save format prior to the block schema
+
+        {
+            std::stringstream ss;
+
+            a_rec.Begin();
+            {
+                boost::archive::binary_oarchive ar(ss);
+                ar << dataPhysics;
+                ar << dataNodes;
+            }
+            auto bytes = static_cast<std::size_t>(ss.tellp());
+            a_rec.Record("archive_save", a_actors, bytes);
+
+            actorConfigComponentsHolder_t physics;
+            actorConfigNodesHolder_t nodes;
+
+            a_rec.Begin();
+            {
+                boost::archive::binary_iarchive ar(ss);
+                ar >> physics;
+                ar >> nodes;
+            }
+            a_rec.Record("archive_load", a_actors, bytes);
+
+            ok &= Check("archive_load", physics.size(), nodes.size(), a_actors);
+        }
+
+        // flat block schema as written by BlockSerializeBegin, unbucketed
+
+        stl::vector<char> block;
+
+        {
+            IConfigSchema::Writer out(block);
+
+            a_rec.Begin();
+            {
+                IConfigSchema::BlockWriter ar(out);
+                for (const auto& e : dataPhysics)
+                {
+                    ar << e.first;
+                    ar << e.second;
+                }
+            }
+
+            auto split = block.size();
+
+            {
+                IConfigSchema::BlockWriter ar(out);
+                for (const auto& e : dataNodes)
+                {
+                    ar << e.first;
+                    ar << e.second;
+                }
+            }
+            a_rec.Record("schema_write", a_actors, block.size());
+
+            actorConfigComponentsHolder_t tmpPhysics;
+            actorConfigNodesHolder_t tmpNodes;
+
+            a_rec.Begin();
+            {
+                IConfigSchema::Reader in(block.data(), split);
+                IConfigSchema::BlockReader ar(in);
+
+                for (std::uint32_t i = 0; i < a_actors; i++)
+                {
+                    Game::ObjectHandle handle;
+                    ar >> handle;
+                    ar >> tmpPhysics[handle];
+                }
+            }
+            {
+                IConfigSchema::Reader in(block.data() + split, block.size() - split);
+                IConfigSchema::BlockReader ar(in);
+
+                for (std::uint32_t i = 0; i < a_actors; i++)
+                {
+                    Game::ObjectHandle handle;
+                    ar >> handle;
+                    ar >> tmpNodes[handle];
+                }
+            }
+            a_rec.Record("schema_read", a_actors, block.size());
+
+            ok &= Check("schema_read", tmpPhysics.size(), tmpNodes.size(), a_actors);
+        }
+
+        for (auto type : { Codec::Type::Gzip, Codec::Type::Zstd, Codec::Type::LZ4 })
+        {
+            std::string name(Codec::GetName(type));
+
+            stl::vector<char> encoded, decoded;
+
+            a_rec.Begin();
+            Codec::Encode(type, -1, block.data(), block.size(), encoded);
+            a_rec.Record("encode_" + name, a_actors, encoded.size());
+
+            a_rec.Begin();
+            Codec::Decode(encoded.data(), encoded.size(), decoded);
+            a_rec.Record("decode_" + name, a_actors, decoded.size());
+
+            if (decoded != block)
+            {
+                std::fprintf(stderr, "%s: codec round trip mismatch\n", name.c_str());
+                ok = false;
+            }
+        }
+
+        return ok;
+    }
+
+    void WriteReport(
+        const fs::path& a_path,
+        std::uint32_t a_actors,
+        std::uint32_t a_groups,
+        const stl::vector<phase_t>& a_phases)
+    {
+        std::ofstream ofs(a_path, std::ofstream::out | std::ofstream::trunc);
+        if (!ofs.is_open())
+            throw std::system_error(errno, std::system_category(), a_path.string());
+
+        ofs << "phase,actors,groups,seconds,entries_per_s,bytes,mb_per_s,peak_heap_kb\n";
+
+        for (const auto& e : a_phases)
+        {
+            ofs << e.name << ',' << a_actors << ',' << a_groups << ',' << e.time << ','
+                << (e.time > 0.0 ? static_cast<double>(e.entries) / e.time : 0.0) << ','
+                << e.bytes << ','
+                << (e.time > 0.0 ? static_cast<double>(e.bytes) / e.time / (1024.0 * 1024.0) : 0.0) << ','
+                << e.peakHeap / 1024 << '\n';
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::uint32_t actors = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000;
+    std::uint32_t groups = argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 8;
+
+    if (actors == 0 || groups == 0)
+    {
+        std::fprintf(stderr, "Nothing to do\n");
+        return 1;
+    }
+
+    PhaseRecorder rec;
+    bool ok;
+
+    try
+    {
+        ok = Run(actors, groups, rec);
+
+        if (argc > 3)
+            WriteReport(argv[3], actors, groups, rec.GetPhases());
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        ok = false;
+    }
+    catch (...)
+    {
+        std::fprintf(stderr, "Unhandled exception\n");
+        ok = false;
+    }
+
+    std::printf("%u actors x %u groups\n", actors, groups);
+
+    for (const auto& e : rec.GetPhases())
+    {
+        std::printf("%-16s %10.3f ms %12zu bytes %10zu KB peak heap\n",
+            e.name.c_str(), e.time * 1000.0, e.bytes, e.peakHeap / 1024);
+    }
+
+    std::printf("%s\n", ok ? "PASSED" : "FAILED");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+// Stand-in for the plugin's pch.h used by the standalone tests. Pulls in the
+// same third party headers and provides just enough of the SKSE/common
+// library surface for the config, schema, codec and JSON parser sources to
+// build without the game. Compile with this directory first on the include
+// path so "pch.h" resolves here.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <cwctype>
+#include <cerrno>
+#include <limits>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <atomic>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <queue>
+#include <algorithm>
+#include <bitset>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <exception>
+
+#include <immintrin.h>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
+
+#include <json/json.h>
+
+#if !defined(_MSC_VER)
+
+#include <strings.h>
+
+// MSVC's std::exception takes a message, the plugin sources rely on it
+namespace std
+{
+    struct cbp_exception :
+        runtime_error
+    {
+        cbp_exception() : runtime_error("") {}
+        cbp_exception(const char* a_what) : runtime_error(a_what) {}
+        cbp_exception(const std::exception& a_rhs) : runtime_error(a_rhs.what()) {}
+    };
+}
+
+#define exception cbp_exception
+
+inline int _stricmp(const char* a_lhs, const char* a_rhs) {
+    return ::strcasecmp(a_lhs, a_rhs);
+}
+
+template <std::size_t N, class... Args>
+inline int _snprintf_s(char(&a_buf)[N], std::size_t, const char* a_fmt, Args... a_args) {
+    return std::snprintf(a_buf, N, a_fmt, a_args...);
+}
+
+#define _TRUNCATE static_cast<std::size_t>(-1)
+
+#define __declspec(a_spec) CBP_DECLSPEC_##a_spec
+#define CBP_DECLSPEC_align(a_n) __attribute__((aligned(a_n)))
+
+#endif
+
+#if defined(_MSC_VER)
+#define SKMP_FORCEINLINE __forceinline
+#else
+#define SKMP_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+#define SKMP_ALIGN(x) alignas(x)
+
+#define DEFINE_ENUM_CLASS_BITWISE(a_type) \
+    constexpr a_type operator|(a_type a_lhs, a_type a_rhs) noexcept { \
+        return static_cast<a_type>(static_cast<std::underlying_type_t<a_type>>(a_lhs) | static_cast<std::underlying_type_t<a_type>>(a_rhs)); } \
+    constexpr a_type operator&(a_type a_lhs, a_type a_rhs) noexcept { \
+        return static_cast<a_type>(static_cast<std::underlying_type_t<a_type>>(a_lhs) & static_cast<std::underlying_type_t<a_type>>(a_rhs)); } \
+    constexpr a_type operator^(a_type a_lhs, a_type a_rhs) noexcept { \
+        return static_cast<a_type>(static_cast<std::underlying_type_t<a_type>>(a_lhs) ^ static_cast<std::underlying_type_t<a_type>>(a_rhs)); } \
+    constexpr a_type operator~(a_type a_value) noexcept { \
+        return static_cast<a_type>(~static_cast<std::underlying_type_t<a_type>>(a_value)); } \
+    constexpr a_type& operator|=(a_type& a_lhs, a_type a_rhs) noexcept { return a_lhs = a_lhs | a_rhs; } \
+    constexpr a_type& operator&=(a_type& a_lhs, a_type a_rhs) noexcept { return a_lhs = a_lhs & a_rhs; }
+
+#define ASSERT_STR(a_cond, a_msg) do { if (!(a_cond)) throw std::exception(a_msg); } while (0)
+#define ASSERT(a_cond) ASSERT_STR(a_cond, #a_cond)
+
+#if !defined(ARRAYSIZE)
+#define ARRAYSIZE(a_arr) (sizeof(a_arr) / sizeof((a_arr)[0]))
+#endif
+
+namespace fs = std::filesystem;
+
+typedef std::uint8_t UInt8;
+typedef std::uint16_t UInt16;
+typedef std::uint32_t UInt32;
+typedef std::uint64_t UInt64;
+typedef std::int32_t SInt32;
+
+#define DIK_LSHIFT 0x2A
+#define DIK_END 0xCF
+#define DIK_PGDN 0xD1
+
+class Actor;
+
+struct NiPoint3
+{
+    float x, y, z;
+};
+
+namespace Game
+{
+    typedef std::uint64_t ObjectHandle;
+    typedef std::uint32_t FormID;
+}
+
+namespace stl
+{
+    struct iless
+    {
+        bool operator()(const std::string& a_lhs, const std::string& a_rhs) const {
+            return _stricmp(a_lhs.c_str(), a_rhs.c_str()) < 0;
+        }
+    };
+
+    struct ihash
+    {
+        std::size_t operator()(const std::string& a_key) const
+        {
+            std::size_t h(14695981039346656037ULL);
+            for (auto c : a_key)
+                h = (h ^ static_cast<std::size_t>(std::tolower(static_cast<unsigned char>(c)))) * 1099511628211ULL;
+            return h;
+        }
+    };
+
+    struct iequal_to
+    {
+        bool operator()(const std::string& a_lhs, const std::string& a_rhs) const {
+            return _stricmp(a_lhs.c_str(), a_rhs.c_str()) == 0;
+        }
+    };
+
+#if defined(_MSC_VER)
+
+    template <class B>
+    using container = B;
+
+#else
+
+    // MSVC binds the temporary in x.swap(decltype(x)()), everything else
+    // needs an rvalue overload
+    template <class B>
+    struct container :
+        B
+    {
+        using B::B;
+
+        container() = default;
+        container(const B& a_rhs) : B(a_rhs) {}
+        container(B&& a_rhs) : B(std::move(a_rhs)) {}
+
+        void swap(container& a_rhs) noexcept { B::swap(a_rhs); }
+        void swap(container&& a_rhs) noexcept { B::swap(a_rhs); }
+    };
+
+#endif
+
+    template <class T>
+    using vector = container<std::vector<T>>;
+
+    template <class K, class V>
+    using map = container<std::map<K, V>>;
+
+    template <class K>
+    using set = container<std::set<K>>;
+
+    template <class K, class V>
+    using unordered_map = container<std::unordered_map<K, V>>;
+
+    template <class K>
+    using unordered_set = container<std::unordered_set<K>>;
+
+    template <class K, class V>
+    using imap = container<std::map<K, V, iless>>;
+
+    template <class K>
+    using iset = container<std::set<K, iless>>;
+
+    template <class K, class V>
+    using iunordered_map = container<std::unordered_map<K, V, ihash, iequal_to>>;
+
+    template <class K>
+    using iunordered_set = container<std::unordered_set<K, ihash, iequal_to>>;
+}
+
+#if !defined(_MSC_VER)
+
+namespace boost
+{
+    namespace serialization
+    {
+        // serialized as the standard container it wraps
+        template <class Archive, class B>
+        void serialize(Archive& a_ar, ::stl::container<B>& a_value, const unsigned int a_version)
+        {
+            serialize(a_ar, static_cast<B&>(a_value), a_version);
+        }
+    }
+}
+
+#endif
+
+namespace except
+{
+    class descriptor
+    {
+    public:
+        descriptor() = default;
+
+        descriptor& operator=(const std::exception& a_rhs)
+        {
+            m_what = a_rhs.what();
+            return *this;
+        }
+
+        const char* what() const noexcept {
+            return m_what.c_str();
+        }
+
+    private:
+        std::string m_what;
+    };
+}
+
+namespace Enum
+{
+    template <class T>
+    constexpr auto Underlying(T a_value) noexcept {
+        return static_cast<std::underlying_type_t<T>>(a_value);
+    }
+}
+
+namespace StrHelpers
+{
+    inline int icompare(const std::string& a_lhs, const std::string& a_rhs) {
+        return _stricmp(a_lhs.c_str(), a_rhs.c_str());
+    }
+}
+
+#define FN_NAMEPROC(a_name) \
+    [[nodiscard]] const char* ModuleName() const noexcept { return a_name; }
+
+// messages go to stderr, Debug is dropped
+class ILog
+{
+protected:
+    void Debug(const char*, ...) const {}
+
+    void Message(const char* a_fmt, ...) const
+    {
+        va_list args;
+        va_start(args, a_fmt);
+        std::vfprintf(stderr, a_fmt, args);
+        std::fputc('\n', stderr);
+        va_end(args);
+    }
+
+    void Warning(const char* a_fmt, ...) const
+    {
+        va_list args;
+        va_start(args, a_fmt);
+        std::vfprintf(stderr, a_fmt, args);
+        std::fputc('\n', stderr);
+        va_end(args);
+    }
+
+    void Error(const char* a_fmt, ...) const
+    {
+        va_list args;
+        va_start(args, a_fmt);
+        std::vfprintf(stderr, a_fmt, args);
+        std::fputc('\n', stderr);
+        va_end(args);
+    }
+};
+
+#include "../Data.h"
+#include "../UIData.h"
+#include "../Serialization.h"
+#include "../Codec.h"
+#include "../../CBP/ArmorCache.h"
+#include "../../CBP/config.h"
+#include "../../CBP/ConfigSchema.h"
+#include "../../CBP/SerializationParser.h"
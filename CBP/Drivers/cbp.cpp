@@ -16,10 +16,12 @@ namespace CBP
     constexpr const char* CKEY_DEBUGRENDERER = "DebugRenderer";
     constexpr const char* CKEY_FORCEINIKEYS = "ForceINIKeys";
     constexpr const char* CKEY_COMPLEVEL = "CompressionLevel";
+    constexpr const char* CKEY_COMPCODEC = "CompressionCodec";
     constexpr const char* CKEY_DATAPATH = "DataPath";
     constexpr const char* CKEY_IMGUIINI = "ImGuiSettings";
     constexpr const char* CKEY_UIOPENRESTRICTIONS = "UIOpenRestrictions";
     constexpr const char* CKEY_TPOFFLOAD = "TaskpoolOffload";
+    constexpr const char* CKEY_WATCHCONFIG = "WatchConfigFiles";
 
     constexpr const char* CKEY_BTEPA = "UseEpaPenetrationAlgorithm";
     constexpr const char* CKEY_BTMANIFOLDPOOLSIZE = "MaxPersistentManifoldPoolSize";
@@ -45,6 +47,11 @@ namespace CBP
             CBP::ControllerInstruction::Action::Reset);
     }
 
+    void DCBP::PrefetchBoneCast(Game::ObjectHandle a_handle)
+    {
+        CBP::IBoneCast::Prefetch(a_handle);
+    }
+
     void DCBP::ResetPhysics()
     {
         m_Instance.m_controller->AddTask(
@@ -146,19 +153,43 @@ namespace CBP
     bool DCBP::ExportData(const std::filesystem::path& a_path)
     {
         auto& iface = m_Instance.m_serialization;
-        return iface.Export(a_path);
+        return iface.ExportAsync(a_path, std::addressof(m_Instance.m_asyncIOCompleteTask));
     }
 
     bool DCBP::ImportData(const std::filesystem::path& a_path, ISerialization::ImportFlags a_flags)
     {
         auto& iface = m_Instance.m_serialization;
+        return iface.ImportAsync(a_path, a_flags, std::addressof(m_Instance.m_asyncIOCompleteTask));
+    }
 
-        bool res = iface.Import(nullptr, a_path, a_flags);
-        if (res)
+    void DCBP::AsyncIOCompleteTask::Run()
+    {
+        IScopedCriticalSection _(GetLock());
+
+        auto& iface = m_Instance.m_serialization;
+
+        auto op = iface.GetAsyncStatus().op;
+
+        if (iface.CompleteAsync() && op == ISerialization::AsyncOp::Import)
             ResetActors();
+    }
 
-        return res;
+#ifdef _CBP_ENABLE_DEBUG
+    bool DCBP::RunSerializationBenchmark(
+        std::uint32_t a_actors,
+        std::uint32_t a_groups,
+        ISerialization::benchResult_t& a_out)
+    {
+        auto& iface = m_Instance.m_serialization;
+
+        return iface.RunBenchmark(
+            a_actors,
+            a_groups,
+            m_Instance.m_conf.paths.benchScratch,
+            m_Instance.m_conf.paths.benchReport,
+            a_out);
     }
+#endif
 
     bool DCBP::GetImportInfo(const std::filesystem::path& a_path, importInfo_t& a_out)
     {
@@ -170,6 +201,7 @@ namespace CBP
     void DCBP::ResetProfiler()
     {
         m_Instance.m_controller->GetProfiler().Reset();
+        m_Instance.m_controller->ResetInstructionStats();
     }
 
     void DCBP::SetProfilerInterval(long long a_interval)
@@ -209,9 +241,17 @@ namespace CBP
         m_conf.debug_renderer = GetConfigValue(SECTION_CBP, CKEY_DEBUGRENDERER, false);
         m_conf.force_ini_keys = GetConfigValue(SECTION_CBP, CKEY_FORCEINIKEYS, false);
         m_conf.compression_level = std::clamp(GetConfigValue(SECTION_CBP, CKEY_COMPLEVEL, 1), 0, 9);
+
+        auto codec = GetConfigValue(SECTION_CBP, CKEY_COMPCODEC, "gzip");
+        if (!Codec::Parse(codec, m_conf.compression_codec))
+        {
+            Warning("Unknown compression codec '%s', using gzip", codec.c_str());
+            m_conf.compression_codec = Codec::Type::Gzip;
+        }
         m_conf.imguiIni = GetConfigValue(SECTION_CBP, CKEY_IMGUIINI, PLUGIN_IMGUI_INI_FILE);
         m_conf.ui_open_restrictions = GetConfigValue(SECTION_CBP, CKEY_UIOPENRESTRICTIONS, true);
         m_conf.taskpool_offload = GetConfigValue(SECTION_CBP, CKEY_TPOFFLOAD, false);
+        m_conf.watch_config = GetConfigValue(SECTION_CBP, CKEY_WATCHCONFIG, true);
 
         m_conf.use_epa = GetConfigValue(SECTION_CBP, CKEY_BTEPA, true);
         m_conf.maxPersistentManifoldPoolSize = GetConfigValue(SECTION_CBP, CKEY_BTMANIFOLDPOOLSIZE, 4096);
@@ -248,6 +288,9 @@ namespace CBP
             paths.templatePlugins = paths.root / PLUGIN_CBP_TEMP_PLUG_R;
             paths.colliderData = paths.root / PLUGIN_CBP_COLLIDER_DATA_R;
             paths.boneCastData = paths.root / PLUGIN_CBP_BONECAST_DATA_R;
+            paths.armorCache = paths.root / PLUGIN_CBP_ARMOR_CACHE_R;
+            paths.benchReport = paths.root / PLUGIN_CBP_BENCH_REPORT_R;
+            paths.benchScratch = paths.root / PLUGIN_CBP_BENCH_SCRATCH_R;
 
             return true;
         }
@@ -496,6 +539,8 @@ namespace CBP
 
         IScopedCriticalSection _(GetLock());
 
+        CBP::IConfigWatcher::Release();
+
         SavePending();
 
         m_Instance.m_controller->ClearActors(true);
@@ -505,6 +550,9 @@ namespace CBP
         m_Instance.m_uiContext.reset();
 
         CBP::ICollision::Destroy();
+
+        CBP::IBoneCast::Release();
+        CBP::IArmorCache::Release();
     }
 
     void DCBP::MessageHandler(Event, void* args)
@@ -531,6 +579,8 @@ namespace CBP
             if (IData::PopulateRaceList())
                 m_Instance.Debug("%zu TESRace forms found", IData::RaceListSize());
 
+            IArmorCache::StartWarm(m_Instance.m_conf.paths.armorCache);
+
             auto& iface = GetSerializationInterface();
 
             PerfTimer pt;
@@ -575,6 +625,19 @@ namespace CBP
 
             IEvents::GetBackLog().SetLimit(globalConf.ui.backlogLimit);
 
+            if (m_Instance.m_conf.watch_config)
+            {
+                auto& paths = m_Instance.m_conf.paths;
+
+                IConfigWatcher::Start({
+                    paths.settings,
+                    paths.collisionGroups,
+                    paths.profilesPhysics,
+                    paths.profilesNode,
+                    paths.colliderData
+                    }, std::addressof(m_Instance.m_configReloadTask));
+            }
+
             Unlock();
 
             m_Instance.Debug("%s: data loaded (%f)", __FUNCTION__, pt.Stop());
@@ -627,27 +690,29 @@ namespace CBP
             return false;
         }
 
-        auto data = std::make_unique<char[]>(dataLength);
+        auto& data = m_Instance.m_recordBuffer;
+        auto& out = m_Instance.m_payloadBuffer;
 
-        if (a_intfc->ReadRecordData(data.get(), dataLength) != dataLength) {
+        data.resize(dataLength);
+
+        if (a_intfc->ReadRecordData(data.data(), dataLength) != dataLength) {
             m_Instance.Error("[%.4s]: Couldn't read record data", &a_type);
             return false;
         }
 
-        std::stringstream out;
-        std::streamsize length;
+        std::size_t length;
+        Codec::Type codec;
+        long long decodeTime;
 
         try
         {
-            using namespace boost::iostreams;
+            auto tts = PerfCounter::Query();
 
-            using Device = basic_array_source<char>;
-            stream<Device> stream(data.get(), dataLength);
+            // headerless records are gzip
+            Codec::Decode(data.data(), dataLength, out, std::addressof(codec));
 
-            filtering_streambuf<input> in;
-            in.push(gzip_decompressor(zlib::default_window_bits, 1024 * 64));
-            in.push(stream);
-            length = copy(in, out, 1024 * 64);
+            decodeTime = PerfCounter::delta_us(tts, PerfCounter::Query());
+            length = out.size();
         }
         catch (const boost::iostreams::gzip_error& e)
         {
@@ -667,11 +732,15 @@ namespace CBP
 
         auto& iface = m_Instance.m_serialization;
 
+        // parsed in place from the inflated buffer
+        boost::iostreams::stream<boost::iostreams::array_source> in(
+            out.data(), out.size());
+
         size_t num = std::bind(
             a_func,
             std::addressof(iface),
             std::placeholders::_1,
-            std::placeholders::_2)(a_intfc, out);
+            std::placeholders::_2)(a_intfc, in);
 
         if (!num)
             return false;
@@ -679,7 +748,9 @@ namespace CBP
         if (a_bin)
             SerializationStats(a_type, iface.GetStats());
 
-        m_Instance.Debug("%s [%.4s]: %zu record(s), %fs (%u/%lld)", __FUNCTION__, &a_type, num, pt.Stop(), dataLength, length);
+        m_Instance.Debug("%s [%.4s]: %zu record(s), %fs (%s: %u/%zu, decode %lld us, buffers %zu kb)",
+            __FUNCTION__, &a_type, num, pt.Stop(), Codec::GetName(codec), dataLength, length,
+            decodeTime, (data.capacity() + out.capacity()) / 1024);
 
         return true;
     }
@@ -693,6 +764,8 @@ namespace CBP
 
         Lock();
 
+        GetSerializationInterface().CancelAsync();
+
         if (version == kDataVersion1)
         {
             while (intfc->GetNextRecordInfo(&type, &currentVersion, &length))
@@ -727,6 +800,9 @@ namespace CBP
                 case 'EPBC':
                     LoadRecord(intfc, type, true, &CBP::ISerialization::BinSerializeLoad);
                     break;
+                case 'BPBC':
+                    LoadBlockRecord(intfc, type);
+                    break;
                 default:
                     m_Instance.Warning("Unknown record '%.4s'", &type);
                     break;
@@ -737,11 +813,19 @@ namespace CBP
             m_Instance.Error("Unrecognized data version: %u", version);
         }
 
+        TrimRecordBuffers();
+
         GetProfiler().Reset();
         QueueUIReset();
 
         GetController()->ResetInstructionQueue();
 
+        for (const auto& e : CBP::IConfig::GetActorNodeHolder())
+            CBP::IBoneCast::Prefetch(e.first);
+
+        for (const auto& e : CBP::IData::GetActorCache())
+            CBP::IBoneCast::Prefetch(e.first);
+
         Unlock();
 
         m_Instance.Debug("%s: %f", __FUNCTION__, pt.Stop());
@@ -752,53 +836,67 @@ namespace CBP
     template <typename T>
     bool DCBP::SerializeToSave(SKSESerializationInterface* a_intfc, UInt32 a_type, T a_func)
     {
-        struct strsink :
-            public boost::iostreams::sink
-        {
-            strsink(std::string& a_dataHolder) :
-                data(a_dataHolder)
-            {}
-
-            std::streamsize write(
-                const char* a_data,
-                std::streamsize a_len)
-            {
-                data.append(a_data, a_len);
-                return a_len;
-            }
-
-            std::string& data;
-        };
-
         PerfTimer pt;
         pt.Start();
 
         auto& iface = m_Instance.m_serialization;
+        auto& driverConf = GetDriverConfig();
 
-        std::stringstream ss;
-        boost::archive::binary_oarchive data(ss);
-        std::string compressed;
-        strsink out(compressed);
-        UInt32 length;
+        auto& compressed = m_Instance.m_recordBuffer;
+        auto& payload = m_Instance.m_payloadBuffer;
 
-        size_t num = std::bind(
-            a_func,
-            std::addressof(iface),
-            std::placeholders::_1)(data);
+        compressed.clear();
+        payload.clear();
 
-        if (!num)
-            return false;
+        auto codec = driverConf.compression_codec;
+        bool gzip = codec == Codec::Type::Gzip;
 
-        auto& driverConf = GetDriverConfig();
+        size_t num;
+        UInt32 length;
+        long long encodeTime(0);
 
         try
         {
             using namespace boost::iostreams;
 
-            filtering_streambuf<input> in;
-            in.push(gzip_compressor(gzip_params(driverConf.compression_level), 1024 * 64));
-            in.push(ss);
-            length = static_cast<UInt32>(copy(in, out, 1024 * 64));
+            // gzip is streamed straight into the record buffer, block codecs
+            // need the whole payload first
+            filtering_streambuf<output> out;
+
+            if (gzip)
+            {
+                out.push(gzip_compressor(gzip_params(driverConf.compression_level), 1024 * 64));
+                out.push(boost::iostreams::back_inserter(compressed));
+            }
+            else
+                out.push(boost::iostreams::back_inserter(payload));
+
+            {
+                boost::archive::binary_oarchive data(out);
+
+                num = std::bind(
+                    a_func,
+                    std::addressof(iface),
+                    std::placeholders::_1)(data);
+            }
+
+            if (!num)
+                return false;
+
+            // flushes and writes the gzip trailer
+            out.reset();
+
+            if (!gzip)
+            {
+                auto tts = PerfCounter::Query();
+
+                Codec::Encode(codec, driverConf.compression_level,
+                    payload.data(), payload.size(), compressed);
+
+                encodeTime = PerfCounter::delta_us(tts, PerfCounter::Query());
+            }
+
+            length = static_cast<UInt32>(compressed.size());
         }
         catch (const boost::iostreams::gzip_error& e)
         {
@@ -833,11 +931,86 @@ namespace CBP
 
         SerializationStats(a_type, iface.GetStats());
 
-        m_Instance.Debug("%s [%.4s]: %zu record(s), %fs (%u b)", __FUNCTION__, &a_type, num, pt.Stop(), length);
+        if (gzip)
+            m_Instance.Debug("%s [%.4s]: %zu record(s), %fs (gzip: %u b, buffer %zu kb)",
+                __FUNCTION__, &a_type, num, pt.Stop(), length, compressed.capacity() / 1024);
+        else
+            m_Instance.Debug("%s [%.4s]: %zu record(s), %fs (%s: %zu -> %u b, %.2fx, encode %lld us, buffers %zu kb)",
+                __FUNCTION__, &a_type, num, pt.Stop(), Codec::GetName(codec), payload.size(), length,
+                length ? double(payload.size()) / double(length) : 0.0, encodeTime,
+                (compressed.capacity() + payload.capacity()) / 1024);
+
+        return true;
+    }
+
+    bool DCBP::SaveBlockRecord(SKSESerializationInterface* a_intfc, UInt32 a_type)
+    {
+        PerfTimer pt;
+        pt.Start();
+
+        auto& iface = m_Instance.m_serialization;
+
+        // nothing is written if encoding fails, the caller falls back to the single archive record
+        if (!iface.BlockSerializeEnd())
+            return false;
+
+        if (!a_intfc->OpenRecord(a_type, kDataVersion2)) {
+            m_Instance.Error("[%.4s]: OpenRecord failed", &a_type);
+            return true;
+        }
+
+        if (!iface.BlockSerializeWrite(a_intfc)) {
+            m_Instance.Error("[%.4s]: Failed writing record data", &a_type);
+            iface.ClearBlockCache();
+            return true;
+        }
+
+        SerializationStats(a_type, iface.GetStats());
+
+        auto& stats = iface.GetBlockStats();
+
+        m_Instance.Debug("%s [%.4s]: %zu block(s), %zu reused, %zu encoded while waiting, %zu -> %zu b, %fs",
+            __FUNCTION__, &a_type, stats.total, stats.reused, stats.encodedSync, stats.raw, stats.encoded, pt.Stop());
 
         return true;
     }
 
+    bool DCBP::LoadBlockRecord(SKSESerializationInterface* a_intfc, UInt32 a_type)
+    {
+        PerfTimer pt;
+        pt.Start();
+
+        auto& iface = m_Instance.m_serialization;
+        auto& driverConf = GetDriverConfig();
+
+        size_t num = iface.BlockSerializeLoad(
+            a_intfc, driverConf.compression_codec, driverConf.compression_level);
+
+        if (!num)
+            return false;
+
+        SerializationStats(a_type, iface.GetStats());
+
+        auto& stats = iface.GetBlockStats();
+
+        m_Instance.Debug("%s [%.4s]: %zu record(s), %zu block(s) (%zu legacy), %zu -> %zu b, %fs",
+            __FUNCTION__, &a_type, num, stats.total, stats.legacy, stats.encoded, stats.raw, pt.Stop());
+
+        return true;
+    }
+
+    void DCBP::TrimRecordBuffers()
+    {
+        auto& r = m_Instance.m_recordBuffer;
+        auto& p = m_Instance.m_payloadBuffer;
+
+        if (r.capacity() > RECORD_BUFFER_KEEP)
+            r.swap(decltype(m_Instance.m_recordBuffer)());
+
+        if (p.capacity() > RECORD_BUFFER_KEEP)
+            p.swap(decltype(m_Instance.m_payloadBuffer)());
+    }
+
     void DCBP::SaveGameHandler(Event, void* args)
     {
         auto intfc = static_cast<SKSESerializationInterface*>(args);
@@ -845,11 +1018,35 @@ namespace CBP
 
         IScopedCriticalSection _(GetLock());
 
+        PerfTimer pt;
+        pt.Start();
+
+        if (CBP::IConfig::GetGlobal().general.autoPrune)
+        {
+            auto num = CBP::IConfig::PruneDirty();
+            if (num)
+                m_Instance.Debug("%s: %zu inactive record(s) pruned", __FUNCTION__, num);
+        }
+
+        auto& driverConf = GetDriverConfig();
+
+        // block encoding runs on the pool while the file flushes below happen here
+        bool blocks = iface.BlockSerializeBegin(
+            driverConf.compression_codec, driverConf.compression_level);
+
         SavePending();
 
+        CBP::IBoneCast::FlushWrites();
+        CBP::IArmorCache::FlushPersistent();
+
         intfc->OpenRecord('DPBC', kDataVersion2);
 
-        SerializeToSave(intfc, 'EPBC', &CBP::ISerialization::BinSerializeSave);
+        if (!blocks || !SaveBlockRecord(intfc, 'BPBC'))
+            SerializeToSave(intfc, 'EPBC', &CBP::ISerialization::BinSerializeSave);
+
+        TrimRecordBuffers();
+
+        m_Instance.Debug("%s: %fs", __FUNCTION__, pt.Stop());
     }
 
     void DCBP::RevertHandler(Event, void*)
@@ -858,6 +1055,8 @@ namespace CBP
 
         IScopedCriticalSection _(GetLock());
 
+        GetSerializationInterface().CancelAsync();
+
         GetController()->ClearActors(false, true);
 
         IConfig::ReleaseActorPhysicsHolder();
@@ -865,10 +1064,13 @@ namespace CBP
         IConfig::ReleaseRacePhysicsHolder();
         IConfig::ReleaseRaceNodeHolder();
         IConfig::ReleaseMergedCache();
+        IConfig::ClearPruneDirty();
 
         IData::ReleaseActorCache();
         IData::ReleaseActorMaps();
 
+        CBP::IBoneCast::ClearPathTable();
+
         auto& sif = GetSerializationInterface();
         auto& dgp = IConfig::GetDefaultProfile();
 
@@ -1042,6 +1244,211 @@ namespace CBP
         CBP::IData::UpdateActorCache(GetSimActorList());
     }
 
+    void DCBP::ConfigReloadTask::Run()
+    {
+        CBP::configChanges_t changes;
+
+        if (!CBP::IConfigWatcher::TakeChanges(changes))
+            return;
+
+        IScopedCriticalSection _(GetLock());
+
+        m_Instance.ApplyConfigChanges(changes);
+    }
+
+    template <class T>
+    static std::size_t ApplyProfileChanges(ProfileManager<T>& a_pm, profileChanges_t<T>& a_changes)
+    {
+        std::size_t num(0);
+
+        for (auto& e : a_changes)
+        {
+            if (e.profile)
+            {
+                if (a_pm.UpdateProfile(std::move(*e.profile)))
+                    num++;
+            }
+            else if (a_pm.RemoveProfile(e.name))
+                num++;
+        }
+
+        return num;
+    }
+
+    // Profiles are copied when applied so only the stores are touched, the
+    // rest only updates what the changed values feed into
+    void DCBP::ApplyConfigChanges(CBP::configChanges_t& a_changes)
+    {
+        PerfTimer pt;
+        pt.Start();
+
+        if (a_changes.hasGlobals)
+            ApplyGlobalConfig(a_changes.globals);
+
+        if (a_changes.hasCollisionGroups)
+            ApplyCollisionGroups(a_changes.collisionGroups, a_changes.nodeCollisionGroupMap);
+
+        auto numPhysics = ApplyProfileChanges(
+            GlobalProfileManager::GetSingleton<PhysicsProfile>(), a_changes.physicsProfiles);
+
+        auto numNode = ApplyProfileChanges(
+            GlobalProfileManager::GetSingleton<NodeProfile>(), a_changes.nodeProfiles);
+
+        if (numPhysics || numNode)
+            Message("Reloaded %zu physics and %zu node profile(s)", numPhysics, numNode);
+
+        if (!a_changes.colliders.empty())
+            ApplyColliderChanges(a_changes.colliders);
+
+        Debug("%s: %fs", __FUNCTION__, pt.Stop());
+    }
+
+    void DCBP::ApplyGlobalConfig(CBP::configGlobal_t& a_globals)
+    {
+        IScopedCriticalSection _(GetLock());
+
+        // parsed on the watcher thread without looking at the group list
+        ISerialization::FilterGlobalConfig(a_globals);
+
+        Json::Value current, next;
+
+        ISerialization::CreateGlobalConfig(IConfig::GetGlobal(), current);
+        ISerialization::CreateGlobalConfig(a_globals, next);
+
+        if (current == next)
+            return;
+
+        auto changed = [&](const char* a_key) {
+            return current[a_key] != next[a_key];
+        };
+
+        const auto& old = IConfig::GetGlobal();
+
+        // decides which actors are simulated at all
+        bool reset = old.general.femaleOnly != a_globals.general.femaleOnly;
+        bool updateAll = old.phys.collisions != a_globals.phys.collisions;
+        bool drState = old.debugRenderer.enabled != a_globals.debugRenderer.enabled;
+
+        IConfig::SetGlobal(std::move(a_globals));
+
+        const auto& globalConf = IConfig::GetGlobal();
+
+        if (changed("physics"))
+            GetController()->UpdateTimeTick(globalConf.phys.timeTick);
+
+        if (changed("general"))
+            UpdateProfilerSettings();
+
+        if (changed("ui"))
+        {
+            UpdateKeys();
+
+            if (GetUIContext() != nullptr)
+            {
+                auto& uirt = GetUIRenderTask();
+
+                uirt.SetLock(globalConf.ui.lockControls);
+                uirt.SetFreeze(globalConf.ui.freezeTime);
+            }
+
+            IEvents::GetBackLog().SetLimit(globalConf.ui.backlogLimit);
+        }
+
+        if (changed("debugRenderer"))
+        {
+            UpdateDebugRendererSettings();
+
+            if (drState)
+                UpdateDebugRendererState();
+        }
+
+        if (reset)
+            ResetActors();
+        else if (updateAll)
+            UpdateConfigOnAllActors();
+
+        Message("Reloaded global settings");
+    }
+
+    void DCBP::ApplyCollisionGroups(
+        CBP::collisionGroups_t& a_groups,
+        CBP::nodeCollisionGroupMap_t& a_nodeMap)
+    {
+        IScopedCriticalSection _(GetLock());
+
+        ISerialization::FilterCollisionGroups(a_nodeMap);
+
+        if (IConfig::GetCollisionGroups() == a_groups &&
+            IConfig::GetNodeCollisionGroupMap() == a_nodeMap)
+        {
+            return;
+        }
+
+        IConfig::SetCollisionGroups(std::move(a_groups));
+        IConfig::SetNodeCollisionGroupMap(std::move(a_nodeMap));
+
+        // group ids are assigned when the sim object is built
+        std::size_t num(0);
+
+        for (const auto& e : GetSimActorList())
+        {
+            auto& nl = e.second.GetNodeList();
+
+            int count = nl.size();
+            for (int i = 0; i < count; i++)
+            {
+                auto& n = nl[i];
+
+                if (n->GetCollisionGroupId() != IConfig::GetNodeCollisionGroupId(n->GetNodeName()))
+                {
+                    DispatchActorTask(e.first, ControllerInstruction::Action::RemoveActor);
+                    DispatchActorTask(e.first, ControllerInstruction::Action::AddActor);
+                    num++;
+                    break;
+                }
+            }
+        }
+
+        Message("Reloaded collision groups, %zu actor(s) reset", num);
+    }
+
+    void DCBP::ApplyColliderChanges(CBP::profileChanges_t<CBP::ColliderProfile>& a_changes)
+    {
+        auto num = ApplyProfileChanges(ProfileManagerCollider::GetSingleton(), a_changes);
+        if (!num)
+            return;
+
+        stl::iunordered_set<std::string> names;
+
+        for (const auto& e : a_changes)
+            names.emplace(e.name);
+
+        // colliders notice the new update id once their config is re-applied
+        std::size_t numActors(0);
+
+        for (const auto& e : GetSimActorList())
+        {
+            auto& nl = e.second.GetNodeList();
+
+            int count = nl.size();
+            for (int i = 0; i < count; i++)
+            {
+                auto& conf = nl[i]->GetConfig();
+
+                if ((conf.ex.colShape == ColliderShapeType::Mesh ||
+                    conf.ex.colShape == ColliderShapeType::ConvexHull) &&
+                    names.contains(conf.ex.colMesh))
+                {
+                    m_controller->AddTask(ControllerInstruction::Action::UpdateConfig, e.first);
+                    numActors++;
+                    break;
+                }
+            }
+        }
+
+        Message("Reloaded %zu collider mesh(es), %zu actor(s) updated", num, numActors);
+    }
+
     DCBP::UpdateNodeRefDataTask::UpdateNodeRefDataTask(Game::ObjectHandle a_handle) :
         m_handle(a_handle)
     {
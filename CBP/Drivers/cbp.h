@@ -70,6 +70,20 @@ namespace CBP
             virtual void Run();
         };
 
+        class ConfigReloadTask :
+            public TaskDelegateStatic
+        {
+        public:
+            virtual void Run();
+        };
+
+        class AsyncIOCompleteTask :
+            public TaskDelegateStatic
+        {
+        public:
+            virtual void Run();
+        };
+
         class UIRenderTask :
             public UIRenderTaskBase
         {
@@ -126,6 +140,7 @@ namespace CBP
         static void UpdateDebugRendererSettings();
         static void UpdateProfilerSettings();
         static void ApplyForce(Game::ObjectHandle a_handle, uint32_t a_steps, const std::string& a_component, const NiPoint3& a_force);
+        static void PrefetchBoneCast(Game::ObjectHandle a_handle);
 
         SKMP_FORCEINLINE static bool SaveGlobals() {
             return m_Instance.m_serialization.SaveGlobalConfig();
@@ -154,6 +169,21 @@ namespace CBP
         static bool ExportData(const std::filesystem::path& a_path);
         static bool ImportData(const std::filesystem::path& a_path, CBP::ISerialization::ImportFlags a_flags);
 
+        [[nodiscard]] SKMP_FORCEINLINE static auto GetAsyncIOStatus() {
+            return m_Instance.m_serialization.GetAsyncStatus();
+        }
+
+        [[nodiscard]] SKMP_FORCEINLINE static bool TakeAsyncIOResult(CBP::ISerialization::AsyncOp a_op, bool& a_result) {
+            return m_Instance.m_serialization.TakeAsyncResult(a_op, a_result);
+        }
+
+#ifdef _CBP_ENABLE_DEBUG
+        static bool RunSerializationBenchmark(
+            std::uint32_t a_actors,
+            std::uint32_t a_groups,
+            CBP::ISerialization::benchResult_t& a_out);
+#endif
+
         static bool GetImportInfo(const std::filesystem::path& a_path, CBP::importInfo_t& a_out);
 
         [[nodiscard]] SKMP_FORCEINLINE static const auto& GetLastSerializationException() {
@@ -259,6 +289,11 @@ namespace CBP
         template <typename T>
         static bool SerializeToSave(SKSESerializationInterface* intfc, UInt32 a_type, T a_func);
 
+        static bool SaveBlockRecord(SKSESerializationInterface* intfc, UInt32 a_type);
+        static bool LoadBlockRecord(SKSESerializationInterface* intfc, UInt32 a_type);
+
+        static void TrimRecordBuffers();
+
         static void OnD3D11PostCreate_CBP(Event code, void* data);
         static void OnExit(Event, void* data);
         static void Present_Pre();
@@ -270,6 +305,11 @@ namespace CBP
 
         void UpdateKeysImpl();
 
+        void ApplyConfigChanges(CBP::configChanges_t& a_changes);
+        void ApplyGlobalConfig(CBP::configGlobal_t& a_globals);
+        void ApplyCollisionGroups(CBP::collisionGroups_t& a_groups, CBP::nodeCollisionGroupMap_t& a_nodeMap);
+        void ApplyColliderChanges(CBP::profileChanges_t<CBP::ColliderProfile>& a_changes);
+
         UIRenderTask m_uiRenderTask;
 
         struct
@@ -279,8 +319,10 @@ namespace CBP
             bool debug_renderer;
             bool force_ini_keys;
             int compression_level;
+            Codec::Type compression_codec;
             bool ui_open_restrictions;
             bool taskpool_offload;
+            bool watch_config;
 
             bool use_epa;
             int maxPersistentManifoldPoolSize;
@@ -304,6 +346,9 @@ namespace CBP
                 fs::path templatePlugins;
                 fs::path colliderData;
                 fs::path boneCastData;
+                fs::path armorCache;
+                fs::path benchReport;
+                fs::path benchScratch;
                 //fs::path imguiSettings;
             } paths;
 
@@ -316,6 +361,8 @@ namespace CBP
         uint32_t m_loadInstance;
         ToggleUITask m_taskToggle;
         UpdateActorCacheTask m_updateActorCacheTask;
+        ConfigReloadTask m_configReloadTask;
+        AsyncIOCompleteTask m_asyncIOCompleteTask;
 
         MainKeyPressHandler m_mainKeyPressEventHandler;
         DebugRendererKeyPressHandler m_drKeyPressEventHandler;
@@ -326,6 +373,12 @@ namespace CBP
 
         CBP::ISerialization m_serialization;
 
+        // reused across saves/loads, compressed record data and inflated payload
+        static constexpr std::size_t RECORD_BUFFER_KEEP = 1024 * 1024 * 8;
+
+        stl::vector<char> m_recordBuffer;
+        stl::vector<char> m_payloadBuffer;
+
         std::unique_ptr<CBP::ControllerTask> m_controller;
 
         ICriticalSection m_lock;
@@ -345,7 +398,7 @@ namespace CBP
         if (a_actor != nullptr) {
             Game::ObjectHandle handle;
             if (handle.Get(a_actor))
-                m_Instance.m_controller->AddTask(a_action, handle);
+                DispatchActorTask(handle, a_action);
         }
     }
 
@@ -353,6 +406,9 @@ namespace CBP
         Game::ObjectHandle handle,
         CBP::ControllerInstruction::Action action)
     {
+        if (action == CBP::ControllerInstruction::Action::AddActor)
+            PrefetchBoneCast(handle);
+
         m_Instance.m_controller->AddTask(action, handle);
     }
 }
\ No newline at end of file
@@ -5,7 +5,8 @@ namespace CBP
     DData DData::m_Instance;
 
     IPluginInfo::IPluginInfo() :
-        m_populated(false)
+        m_populated(false),
+        m_regular{ nullptr }
     {
     }
 
@@ -18,6 +19,9 @@ namespace CBP
         m_pluginIndexMap.clear();
         m_pluginNameMap.clear();
 
+        std::fill(std::begin(m_regular), std::end(m_regular), nullptr);
+        m_light.assign(NUM_LIGHT, nullptr);
+
         for (auto it = dh->modList.modInfoList.Begin(); !it.End(); ++it)
         {
             auto modInfo = it.Get();
@@ -33,7 +37,18 @@ namespace CBP
                 modInfo->lightIndex,
                 modInfo->name);
 
-            m_pluginNameMap.emplace(modInfo->name, r.first->second);
+            auto& info = r.first->second;
+
+            m_pluginNameMap.emplace(modInfo->name, info);
+
+            if (!info.isLight) {
+                if (info.modIndex < NUM_REGULAR)
+                    m_regular[info.modIndex] = std::addressof(info);
+            }
+            else {
+                if (info.lightIndex < NUM_LIGHT)
+                    m_light[info.lightIndex] = std::addressof(info);
+            }
         }
 
         return (m_populated = true);
@@ -50,10 +65,12 @@ namespace CBP
 
     const pluginInfo_t* IPluginInfo::Lookup(UInt32 const a_modID) const
     {
-        const auto it = m_pluginIndexMap.find(a_modID);
-        if (it != m_pluginIndexMap.end()) {
-            return std::addressof(it->second);
-        }
+        if (a_modID < NUM_REGULAR)
+            return m_regular[a_modID];
+
+        if ((a_modID & ~(NUM_LIGHT - 1)) == 0xFE000 && !m_light.empty())
+            return m_light[a_modID & (NUM_LIGHT - 1)];
+
         return nullptr;
     }
 
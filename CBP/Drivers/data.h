@@ -8,6 +8,7 @@ namespace CBP
         UInt32 modIndex;
         UInt32 lightIndex;
         std::string name;
+        std::string lowerName;
 
         bool isLight;
         UInt32 partialIndex;
@@ -21,8 +22,11 @@ namespace CBP
             fileFlags(a_fileFlags),
             modIndex(a_modIndex),
             lightIndex(a_lightIndex),
-            name(a_name)
+            name(a_name),
+            lowerName(a_name)
         {
+            std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+
             isLight = (a_fileFlags & ModInfo::kFileFlags_Light) == ModInfo::kFileFlags_Light;
             partialIndex = !isLight ? a_modIndex : (UInt32(0xFE000) | a_lightIndex);
         }
@@ -87,8 +91,15 @@ namespace CBP
 
     private:
 
+        static constexpr UInt32 NUM_REGULAR = 0xFE;
+        static constexpr UInt32 NUM_LIGHT = 0x1000;
+
         bool m_populated;
 
+        // partial index -> entry, filled once the load order is known
+        const pluginInfo_t* m_regular[NUM_REGULAR];
+        stl::vector<const pluginInfo_t*> m_light;
+
         stl::map<UInt32, pluginInfo_t> m_pluginIndexMap;
         stl::iunordered_map<std::string, pluginInfo_t&> m_pluginNameMap;
     };
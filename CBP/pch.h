@@ -45,6 +45,9 @@
 #include <functional>
 #include <numbers>
 #include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <ShlObj.h>
 
@@ -72,6 +75,8 @@
 #include <boost/any.hpp>
 
 #include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/copy.hpp>
@@ -119,15 +124,20 @@ namespace fs = std::filesystem;
 #include "drivers/render.h"
 #include "drivers/gui.h"
 #include "Common/Serialization.h"
+#include "Common/ThreadPool.h"
+#include "Common/MPSCQueue.h"
 #include "Common/ProfileManager.h"
 #include "Common/UIData.h"
 #include "Common/UICommon.h"
 #include "Common/Crypto.h"
+#include "Common/Codec.h"
 #include "Common/Game.h"
 #include "cbp/Data.h"
 #include "cbp/ArmorCache.h"
 #include "CBP/ColliderData.h"
 #include "cbp/Config.h"
+#include "CBP/ConfigSchema.h"
+#include "CBP/SerializationParser.h"
 #include "cbp/Serialization.h"
 #include "cbp/Profile.h"
 #include "cbp/Template.h"
@@ -135,6 +145,7 @@ namespace fs = std::filesystem;
 #include "cbp/SimComponent.h"
 #include "cbp/SimObject.h"
 #include "cbp/Collision.h"
+#include "CBP/ConfigWatcher.h"
 #include "cbp/Armor.h"
 #include "cbp/UI.h"
 #include "cbp/Papyrus.h"